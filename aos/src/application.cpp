@@ -2,19 +2,25 @@
 #include "camera.hpp"
 #include "color.hpp"
 #include "config.hpp"
+#include "hdr_image.hpp"
+#include "image_io.hpp"
 #include "object.hpp"
 #include "ray.hpp"
 #include "scene.hpp"
 #include "scene_parser.hpp"
+#include "tonemap.hpp"
 #include "vector.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
-#include <fstream>
 #include <gsl/span>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <random>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -59,6 +65,7 @@ namespace {
     int width;
     int height;
     double gamma;
+    render::image_format format;
   };
 
   // Calcula color de un rayo recursivamente con rebotes
@@ -114,30 +121,34 @@ namespace {
     return accumulated / static_cast<double>(params.samples_per_pixel);
   }
 
-  // Guarda imagen en formato PPM
+  // Guarda imagen en formato PPM o QOI. Los colores se cuantizan a canales de 8 bits y el texto
+  // P3 o el QOI se codifican en paralelo en common; P6 va en un único búfer intercalado.
   void save_ppm(std::string const & filename, std::vector<render::color> const & image,
                 ImageSaveParams const & params) {
-    std::ofstream out(filename);
-    if (!out.is_open()) {
-      throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+    if (params.format == render::image_format::p6) {
+      std::vector<char> rgb(3 * image.size());
+      for (size_t index = 0; index < image.size(); ++index) {
+        rgb[3 * index]     = static_cast<char>(image[index].to_discrete_r(params.gamma));
+        rgb[3 * index + 1] = static_cast<char>(image[index].to_discrete_g(params.gamma));
+        rgb[3 * index + 2] = static_cast<char>(image[index].to_discrete_b(params.gamma));
+      }
+      render::write_p6(filename, params.width, params.height, rgb);
+      return;
     }
 
-    out << "P3\n" << params.width << " " << params.height << "\n255\n";
-
-    for (int j = 0; j < params.height; ++j) {
-      for (int i = 0; i < params.width; ++i) {
-        size_t const index =
-            static_cast<size_t>(j) * static_cast<size_t>(params.width) + static_cast<size_t>(i);
-        render::color const & pixel = image[index];
-
-        auto const r = pixel.to_discrete_r(params.gamma);
-        auto const g = pixel.to_discrete_g(params.gamma);
-        auto const b = pixel.to_discrete_b(params.gamma);
-
-        out << static_cast<int>(r) << " " << static_cast<int>(g) << " " << static_cast<int>(b)
-            << "\n";
-      }
+    std::vector<std::uint8_t> r(image.size());
+    std::vector<std::uint8_t> g(image.size());
+    std::vector<std::uint8_t> b(image.size());
+    for (size_t index = 0; index < image.size(); ++index) {
+      r[index] = image[index].to_discrete_r(params.gamma);
+      g[index] = image[index].to_discrete_g(params.gamma);
+      b[index] = image[index].to_discrete_b(params.gamma);
+    }
+    if (params.format == render::image_format::qoi) {
+      render::write_qoi(filename, params.width, params.height, r, g, b);
+      return;
     }
+    render::write_p3(filename, params.width, params.height, r, g, b);
   }
 
   // Bucle principal de renderizado en AOS
@@ -153,11 +164,34 @@ namespace {
     PixelRenderParams const render_params{
       image_width, image_height, job.cfg.get_samples_per_pixel(), job.cfg.get_max_depth(), &dist};
 
-    ImageSaveParams const save_params{image_width, image_height, job.cfg.get_gamma()};
+    ImageSaveParams const save_params{
+      image_width, image_height, job.cfg.get_gamma(),
+      render::resolve_image_format(job.cfg.get_output_format(), job.output_path)};
 
-    // Almacenar imagen completa en memoria (AOS)
+    // Almacenar imagen completa en memoria (AOS). Con salida en flujo solo se guarda una banda
+    // de tile_height filas, que se cuantiza y se escribe al terminarla.
+    bool const streaming  = job.cfg.get_stream_window() > 0;
+    int const band_height = std::max(1, streaming ? job.cfg.get_tile_height() : image_height);
     std::vector<render::color> image(static_cast<size_t>(image_width) *
-                                     static_cast<size_t>(image_height));
+                                     static_cast<size_t>(band_height));
+
+    std::optional<render::image_stream_writer> writer;
+    std::vector<std::uint8_t> band_r;
+    std::vector<std::uint8_t> band_g;
+    std::vector<std::uint8_t> band_b;
+    if (streaming) {
+      writer.emplace(job.output_path, save_params.format, image_width, image_height);
+      band_r.resize(image.size());
+      band_g.resize(image.size());
+      band_b.resize(image.size());
+    }
+    render::tonemapper const tonemap{save_params.gamma};
+
+    // Con framebuffer: hdr se guarda también la imagen lineal, sin gamma
+    render::hdr_image hdr;
+    if (job.cfg.get_framebuffer() == "hdr") {
+      hdr = render::hdr_image{image_width, image_height};
+    }
 
     std::cout << "Renderizando escena (" << image_width << "x" << image_height << ") con "
               << render_params.samples_per_pixel << " samples/pixel...\n";
@@ -166,19 +200,46 @@ namespace {
     for (int j = 0; j < image_height; ++j) {
       std::cerr << "\rScanlines restantes: " << (image_height - j) << "   " << std::flush;
 
+      int const band_row = j % band_height;
       for (int i = 0; i < image_width; ++i) {
         render::color const pixel_color = render_pixel(i, j, job, render_params);
 
-        size_t const index =
-            static_cast<size_t>(j) * static_cast<size_t>(image_width) + static_cast<size_t>(i);
+        size_t const index = static_cast<size_t>(band_row) * static_cast<size_t>(image_width) +
+                             static_cast<size_t>(i);
         image[index] = pixel_color;
       }
+
+      // Banda terminada
+      if (band_row == band_height - 1 or j == image_height - 1) {
+        size_t const count = static_cast<size_t>(band_row + 1) * static_cast<size_t>(image_width);
+        auto const band    = std::span<render::color const>{image}.first(count);
+        if (not hdr.empty()) {
+          hdr.set_rows(j - band_row, band);
+        }
+        if (writer) {
+          tonemap.map(band, std::span{band_r}.first(count), std::span{band_g}.first(count),
+                      std::span{band_b}.first(count));
+          writer->write_rows(std::span{band_r}.first(count), std::span{band_g}.first(count),
+                             std::span{band_b}.first(count));
+        }
+      }
     }
 
     std::cerr << "\rRenderizado completado.                    \n";
 
-    save_ppm(job.output_path, image, save_params);
+    if (writer) {
+      writer->finish();
+    } else {
+      save_ppm(job.output_path, image, save_params);
+    }
     std::cout << "Imagen guardada como " << job.output_path << "\n";
+
+    if (not hdr.empty()) {
+      std::string const hdr_path = render::hdr_path_for(job.output_path);
+      render::write_pfm(hdr_path, hdr);
+      std::cout << "Imagen lineal guardada como " << hdr_path << " ("
+                << render_params.samples_per_pixel << " muestras/píxel)\n";
+    }
   }
 
 }  // namespace
@@ -0,0 +1,40 @@
+// Generación de rayos de la cámara y conversión de color a 8 bits
+
+#include "camera.hpp"
+#include "color.hpp"
+#include "config.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+  void bm_camera_get_ray(benchmark::State & state) {
+    render::camera const cam{render::config{}};
+    double u = 0.0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(cam.get_ray(u, 0.5));
+      u = u < 1.0 ? u + 1e-3 : 0.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void bm_color_to_discrete(benchmark::State & state) {
+    render::color const pixel{0.2, 0.5, 0.8};
+    for (auto _ : state) {
+      std::uint8_t const r = pixel.to_discrete_r(2.2);
+      std::uint8_t const g = pixel.to_discrete_g(2.2);
+      std::uint8_t const b = pixel.to_discrete_b(2.2);
+      benchmark::DoNotOptimize(r);
+      benchmark::DoNotOptimize(g);
+      benchmark::DoNotOptimize(b);
+    }
+    // Un elemento es un píxel: los tres canales
+    state.SetItemsProcessed(state.iterations());
+  }
+
+}  // namespace
+
+BENCHMARK(bm_camera_get_ray);
+BENCHMARK(bm_color_to_discrete);
@@ -0,0 +1,43 @@
+// Escritura de la imagen final en PPM de texto (P3) y binario (P6)
+
+#include "color.hpp"
+#include "image_io.hpp"
+#include "image_soa_par.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <string>
+
+namespace {
+
+  void bm_save_ppm(benchmark::State & state, render::image_format const format) {
+    int const width  = static_cast<int>(state.range(0));
+    int const height = width * 9 / 16;
+    ImageSOA image{width, height};
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        render::color const pixel{static_cast<double>(x) / width,
+                                  static_cast<double>(y) / height, 0.5};
+        image.set_pixel(x, y, pixel, 2.2);
+      }
+    }
+    auto const path = (std::filesystem::temp_directory_path() / "render_bench_image.ppm").string();
+
+    for (auto _ : state) {
+      image.save_ppm(path, format);
+    }
+    state.SetItemsProcessed(state.iterations() * width * height);
+    std::filesystem::remove(path);
+  }
+
+}  // namespace
+
+BENCHMARK_CAPTURE(bm_save_ppm, p3, render::image_format::p3)
+    ->Arg(640)
+    ->Arg(1920)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_save_ppm, p6, render::image_format::p6)
+    ->Arg(640)
+    ->Arg(1920)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,39 @@
+// Dispersión de un rayo en cada tipo de material
+
+#include "material.hpp"
+#include "object.hpp"
+#include "ray.hpp"
+#include "vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace {
+
+  void bm_scatter(benchmark::State & state, render::material const & mat) {
+    render::ray const r_in{render::vector{0.0, 0.0, 0.0}, render::vector{0.3, -0.2, -1.0}};
+    render::hit_record rec;
+    rec.point      = render::vector{0.0, 0.0, -1.0};
+    rec.normal     = render::vector{0.0, 0.0, 1.0};
+    rec.mat_ptr    = &mat;
+    rec.t          = 1.0;
+    rec.front_face = true;
+    std::mt19937_64 rng{13};
+    render::ray scattered;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(mat.scatter(r_in, rec, scattered, rng));
+      benchmark::DoNotOptimize(scattered);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  render::matte_material const matte{render::vector{0.5, 0.4, 0.3}};
+  render::metal_material const metal{render::vector{0.9, 0.8, 0.7}, 0.2};
+  render::refractive_material const glass{1.5};
+
+}  // namespace
+
+BENCHMARK_CAPTURE(bm_scatter, matte, matte);
+BENCHMARK_CAPTURE(bm_scatter, metal, metal);
+BENCHMARK_CAPTURE(bm_scatter, refractive, glass);
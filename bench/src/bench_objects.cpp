@@ -0,0 +1,48 @@
+// Intersección de un rayo con una esfera y con un cilindro, con rayos que aciertan y que fallan
+
+#include "material.hpp"
+#include "object.hpp"
+#include "ray.hpp"
+#include "vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+  render::matte_material const gray{render::vector{0.5, 0.5, 0.5}};
+
+  // Rayo desde el origen hacia -z, desplazado en x para fallar
+  render::ray ray_at(double const x) {
+    return render::ray{render::vector{x, 0.0, 0.0}, render::vector{0.0, 0.0, -1.0}};
+  }
+
+  void bm_sphere_hit(benchmark::State & state, double const x) {
+    render::sphere const ball{render::vector{0.0, 0.0, -5.0}, 1.0, &gray};
+    auto const r = ray_at(x);
+    render::hit_record rec;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ball.hit(r, 0.001, 1e9, rec));
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void bm_cylinder_hit(benchmark::State & state, double const x) {
+    // Eje vertical: el rayo cruza la superficie curva
+    render::cylinder const tube{render::vector{0.0, 0.0, -5.0}, 1.0, render::vector{0.0, 2.0, 0.0},
+                                &gray};
+    auto const r = ray_at(x);
+    render::hit_record rec;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(tube.hit(r, 0.001, 1e9, rec));
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+}  // namespace
+
+BENCHMARK_CAPTURE(bm_sphere_hit, hit, 0.0);
+BENCHMARK_CAPTURE(bm_sphere_hit, miss, 3.0);
+BENCHMARK_CAPTURE(bm_cylinder_hit, hit, 0.0);
+BENCHMARK_CAPTURE(bm_cylinder_hit, miss, 3.0);
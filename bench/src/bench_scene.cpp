@@ -0,0 +1,81 @@
+// Intersección con la escena completa y lectura del fichero de escena, a varios tamaños. Las
+// escenas se generan con render-gen-scene (distribución en rejilla, como scene4).
+
+#include "camera.hpp"
+#include "config.hpp"
+#include "object.hpp"
+#include "scene.hpp"
+#include "scene_generator.hpp"
+#include "scene_parser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+  render::scene generated_scene(std::size_t const objects) {
+    render::scene_generator_options options;
+    options.object_count = objects;
+    options.layout       = render::scene_layout::grid;
+    options.seed         = 4;
+    render::scene scn;
+    render::generate_scene(options, scn);
+    return scn;
+  }
+
+  // Un rayo de la cámara de config4 por iteración, recorriendo la imagen
+  void bm_scene_hit(benchmark::State & state) {
+    auto const scn = generated_scene(static_cast<std::size_t>(state.range(0)));
+    render::config cfg;
+    cfg.set_camera_position(render::vector{13.0, 2.0, 3.0});
+    cfg.set_camera_target(render::vector{0.0, 0.0, 0.0});
+    cfg.set_field_of_view(20.0);
+    render::camera const cam{cfg};
+
+    constexpr int side = 64;
+    int pixel          = 0;
+    std::int64_t hits  = 0;
+    render::hit_record rec;
+    for (auto _ : state) {
+      double const u = (pixel % side + 0.5) / side;
+      double const v = (pixel / side + 0.5) / side;
+      hits += scn.hit(cam.get_ray(u, v), 0.001, 1e9, rec) ? 1 : 0;
+      pixel = (pixel + 1) % (side * side);
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["objects"] = static_cast<double>(state.range(0));
+  }
+
+  void bm_parse_scene_file(benchmark::State & state) {
+    auto const objects = static_cast<std::size_t>(state.range(0));
+    auto const name    = "render_bench_scene_" + std::to_string(objects) + ".txt";
+    auto const path    = (std::filesystem::temp_directory_path() / name).string();
+    {
+      std::ofstream out(path);
+      render::write_scene_text(generated_scene(objects), out);
+    }
+    auto const bytes = std::filesystem::file_size(path);
+
+    for (auto _ : state) {
+      render::scene scn;
+      render::parse_scene_file(path, scn);
+      benchmark::DoNotOptimize(scn.get_objects().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(objects));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+    std::filesystem::remove(path);
+  }
+
+}  // namespace
+
+BENCHMARK(bm_scene_hit)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK(bm_parse_scene_file)
+    ->RangeMultiplier(10)
+    ->Range(100, 100'000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,322 @@
+// render-bench-e2e: mide de extremo a extremo render-aos, render-soa y render-par con la matriz
+// de un plan (escenas, hilos y partitioners; ver bench_plan.hpp), compara cada imagen con la
+// del front end de referencia y, si se da una referencia de tiempos, marca las regresiones.
+//
+//   render-bench-e2e <plan> <resultados.json> [opciones]
+//     --csv <fichero>          escribe también los resultados en CSV
+//     --baseline <fichero>     CSV de una medición anterior con la que comparar los tiempos
+//     --threshold <fracción>   regresión a partir de la que se falla (0.1: un 10 % más lento)
+//     --bin-dir <dir>          directorio de build con aos/, soa/ y par/ (el del propio programa)
+//     --work-dir <dir>         configuraciones, imágenes y salidas de cada ejecución (bench-e2e)
+//
+// Devuelve un código de error si algún caso es más lento que la referencia por encima del
+// umbral, de modo que puede usarse como comprobación en CI.
+
+#include "bench_plan.hpp"
+#include "bench_report.hpp"
+#include "config.hpp"
+#include "image_io.hpp"
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <gsl/span>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+extern char ** environ;
+
+namespace {
+
+  namespace fs = std::filesystem;
+
+  // Ejecución de un programa hijo
+  struct run_result {
+    double wall_seconds{0.0};
+    long peak_rss_kib{0};
+  };
+
+  // Caso de la matriz ya preparado: programa, configuración e imagen de salida
+  struct bench_case {
+    render::bench_result result;
+    fs::path binary;
+    fs::path config_path;
+    fs::path output_path;
+    fs::path log_path;
+  };
+
+  // Valor numérico completo de una opción
+  template <typename T>
+  T parse_value(std::string const & option, std::string const & text) {
+    std::istringstream in{text};
+    T value{};
+    if (not(in >> value) or not in.eof()) {
+      throw std::invalid_argument("Error: Invalid value for " + option + ": " + text);
+    }
+    return value;
+  }
+
+  std::string read_text(fs::path const & path) {
+    std::ifstream in{path};
+    if (not in) {
+      throw std::runtime_error("Error: Cannot open file: " + path.string());
+    }
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  }
+
+  void write_text(fs::path const & path, std::string const & text) {
+    std::ofstream out{path};
+    if (not out or not(out << text) or not out.flush()) {
+      throw std::runtime_error("Error: Cannot write to file: " + path.string());
+    }
+  }
+
+  // Lanza el programa con la salida estándar y de errores en log y espera a que termine. El
+  // tiempo incluye el arranque y la carga de la escena; la memoria es el máximo residente del
+  // hijo según wait4.
+  run_result run_child(std::vector<std::string> args, fs::path const & log) {
+    posix_spawn_file_actions_t actions{};
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log.c_str(),
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    std::vector<char *> argv;
+    argv.reserve(args.size() + 1);
+    for (auto & arg : args) {
+      argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    auto const start = std::chrono::steady_clock::now();
+    pid_t pid        = 0;
+    int const error  = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+      throw std::runtime_error("Error: Cannot run " + args[0] + ": " + std::strerror(error));
+    }
+
+    int status = 0;
+    rusage usage{};
+    while (wait4(pid, &status, 0, &usage) < 0) {
+      if (errno != EINTR) {
+        throw std::runtime_error("Error: Cannot wait for " + args[0]);
+      }
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    if (not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+      throw std::runtime_error("Error: " + args[0] + " failed, see " + log.string());
+    }
+    return {.wall_seconds = elapsed.count(), .peak_rss_kib = usage.ru_maxrss};
+  }
+
+  // Rayos primarios a partir de la línea "Renderizando escena (WxH)" que escriben los tres
+  // front ends
+  double primary_rays(fs::path const & log, int const samples_per_pixel) {
+    constexpr std::string_view marker = "Renderizando escena (";
+    std::string const text            = read_text(log);
+    auto const found                  = text.find(marker);
+    if (found != std::string::npos) {
+      std::istringstream in{text.substr(found + marker.size())};
+      long width  = 0;
+      long height = 0;
+      char x      = 0;
+      if (in >> width >> x >> height and x == 'x') {
+        return static_cast<double>(width) * static_cast<double>(height) * samples_per_pixel;
+      }
+    }
+    throw std::runtime_error("Error: Image size not found in " + log.string());
+  }
+
+  std::string case_name(render::bench_result const & r, std::size_t const scene_index) {
+    std::string name = r.frontend + "_s" + std::to_string(scene_index);
+    if (r.frontend == "par") {
+      name += "_t" + (r.threads < 0 ? std::string{"auto"} : std::to_string(r.threads)) + "_" +
+              r.partitioner;
+    }
+    return name;
+  }
+
+  // Casos de una escena: uno por front end y, en par, uno por cada hilos x partitioner con su
+  // propia configuración
+  std::vector<bench_case> make_cases(render::bench_plan const & plan, std::size_t scene_index,
+                                     std::string const & base_config, fs::path const & bin_dir,
+                                     fs::path const & work_dir) {
+    std::vector<bench_case> cases;
+    for (auto const & frontend : plan.frontends) {
+      render::bench_result base;
+      base.frontend = frontend;
+      base.scene    = plan.scene_paths[scene_index];
+      std::vector<render::bench_result> variants;
+      if (frontend == "par") {
+        for (int const threads : plan.thread_counts) {
+          for (auto const & partitioner : plan.partitioners) {
+            variants.push_back(base);
+            variants.back().threads     = threads;
+            variants.back().partitioner = partitioner;
+          }
+        }
+      } else {
+        variants.push_back(base);
+      }
+      for (auto const & variant : variants) {
+        std::string const name = case_name(variant, scene_index);
+        bench_case item{.result      = variant,
+                        .binary      = bin_dir / frontend / ("render-" + frontend),
+                        .config_path = plan.config_path,
+                        .output_path = work_dir / (name + ".ppm"),
+                        .log_path    = work_dir / (name + ".log")};
+        if (frontend == "par") {
+          item.config_path = work_dir / (name + ".config.txt");
+          write_text(item.config_path, base_config + "\nnum_threads: " +
+                                           std::to_string(variant.threads) +
+                                           "\npartitioner: " + variant.partitioner + "\n");
+        }
+        cases.push_back(std::move(item));
+      }
+    }
+    return cases;
+  }
+
+  void run_case(bench_case & item, int const repetitions, int const samples_per_pixel) {
+    auto & r = item.result;
+    for (int i = 0; i < repetitions; ++i) {
+      auto const run = run_child({item.binary.string(), item.config_path.string(), r.scene,
+                                  item.output_path.string()},
+                                 item.log_path);
+      if (i == 0 or run.wall_seconds < r.wall_seconds) {
+        r.wall_seconds = run.wall_seconds;
+      }
+      r.peak_rss_kib = std::max(r.peak_rss_kib, run.peak_rss_kib);
+    }
+    r.rays_per_second = primary_rays(item.log_path, samples_per_pixel) / r.wall_seconds;
+  }
+
+  void print_result(render::bench_result const & r) {
+    std::cout << std::left << std::setw(4) << r.frontend << " " << std::right << std::setw(4)
+              << r.threads << " " << std::left << std::setw(7) << r.partitioner << std::right
+              << std::fixed << std::setprecision(3) << std::setw(9) << r.wall_seconds << " s "
+              << std::setprecision(0) << std::setw(12) << r.rays_per_second << " rayos/s "
+              << std::setw(9) << r.peak_rss_kib << " KiB  rmse " << std::setprecision(3)
+              << r.rmse << " max " << r.max_error << "  " << r.scene << "\n"
+              << std::defaultfloat << std::setprecision(6);
+  }
+
+  fs::path default_bin_dir() {
+    // El programa está en <build>/bench; los front ends, en <build>/aos, soa y par
+    return fs::read_symlink("/proc/self/exe").parent_path().parent_path();
+  }
+
+  int run(gsl::span<char const * const> args) {
+    if (args.size() < 3 or args.size() % 2 == 0) {
+      std::cerr << "Uso: render-bench-e2e <plan> <resultados.json> [--csv fichero] "
+                   "[--baseline fichero.csv] [--threshold f] [--bin-dir dir] [--work-dir dir]\n";
+      return EXIT_FAILURE;
+    }
+    auto const plan             = render::read_bench_plan(args[1]);
+    std::string const json_path = args[2];
+    std::string csv_path;
+    std::string baseline_path;
+    double threshold  = 0.1;
+    fs::path bin_dir  = default_bin_dir();
+    fs::path work_dir = "bench-e2e";
+    for (std::size_t i = 3; i < args.size(); i += 2) {
+      std::string const option = args[i];
+      std::string const value  = args[i + 1];
+      if (option == "--csv") {
+        csv_path = value;
+      } else if (option == "--baseline") {
+        baseline_path = value;
+      } else if (option == "--threshold") {
+        threshold = parse_value<double>(option, value);
+      } else if (option == "--bin-dir") {
+        bin_dir = value;
+      } else if (option == "--work-dir") {
+        work_dir = value;
+      } else {
+        throw std::invalid_argument("Error: Invalid option: " + option + " " + value);
+      }
+    }
+    // Se lee antes de medir para no descubrir un fichero erróneo al final
+    std::vector<render::bench_result> baseline;
+    if (not baseline_path.empty()) {
+      baseline = render::read_bench_results_csv(baseline_path);
+    }
+
+    fs::create_directories(work_dir);
+    std::string const base_config = read_text(plan.config_path);
+    render::config cfg;
+    render::load_config(plan.config_path, cfg);
+
+    std::vector<render::bench_result> results;
+    for (std::size_t s = 0; s < plan.scene_paths.size(); ++s) {
+      auto cases = make_cases(plan, s, base_config, bin_dir, work_dir);
+      for (auto & item : cases) {
+        run_case(item, plan.repetitions, cfg.get_samples_per_pixel());
+      }
+      auto const reference = std::ranges::find(cases, plan.reference, [](bench_case const & c) {
+        return c.result.frontend;
+      });
+      auto const reference_image = render::read_ppm(reference->output_path.string());
+      for (auto & item : cases) {
+        auto const diff  = render::compare_images(reference_image,
+                                                  render::read_ppm(item.output_path.string()));
+        item.result.rmse      = diff.rmse;
+        item.result.max_error = diff.max_error;
+        print_result(item.result);
+        results.push_back(item.result);
+      }
+    }
+
+    write_text(json_path, render::bench_results_json(results));
+    std::cout << "Resultados guardados como " << json_path << "\n";
+    if (not csv_path.empty()) {
+      write_text(csv_path, render::bench_results_csv(results));
+      std::cout << "Resultados guardados como " << csv_path << "\n";
+    }
+    if (baseline_path.empty()) {
+      return EXIT_SUCCESS;
+    }
+
+    auto const regressions = render::find_regressions(results, baseline, threshold);
+    for (auto const & regression : regressions) {
+      auto const & r = regression.current;
+      std::cout << "Regresión: " << r.frontend << " " << r.threads << " " << r.partitioner
+                << " " << r.scene << ": " << r.wall_seconds << " s frente a "
+                << regression.baseline_seconds << " s (+" << std::fixed << std::setprecision(1)
+                << 100.0 * regression.slowdown << " %)\n"
+                << std::defaultfloat << std::setprecision(6);
+    }
+    std::cout << "Regresiones por encima del " << 100.0 * threshold
+              << " %: " << regressions.size() << "\n";
+    return regressions.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  try {
+    return run({argv, static_cast<std::size_t>(argc)});
+  } catch (std::exception const & e) {
+    std::cerr << "Ha ocurrido una excepción: " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,29 @@
+#ifndef RENDER_BATCH_FILE_HPP
+#define RENDER_BATCH_FILE_HPP
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Trabajo de un fichero de lotes: imagen de salida y líneas "clave: valores" que se aplican
+  // sobre la configuración base
+  struct batch_job {
+    std::string output_path;
+    std::string overrides;
+  };
+
+  // Lee una lista de trabajos. Cada trabajo empieza con una línea "output <ruta>" y sigue con
+  // las claves de configuración que cambia; las líneas vacías y las que empiezan por # se
+  // ignoran. Lanza std::invalid_argument si hay claves antes del primer output, un output sin
+  // ruta o ningún trabajo.
+  std::vector<batch_job> parse_batch_jobs(std::istream & in);
+
+  // Igual que parse_batch_jobs, a partir de un fichero. Lanza std::runtime_error si no se puede
+  // abrir.
+  std::vector<batch_job> read_batch_file(std::string const & path);
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef RENDER_BENCH_PLAN_HPP
+#define RENDER_BENCH_PLAN_HPP
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Matriz de una medición de extremo a extremo: cada front end con cada escena y, en par, con
+  // cada número de hilos y cada partitioner
+  struct bench_plan {
+    std::string config_path;
+    std::vector<std::string> scene_paths;
+    std::vector<std::string> frontends{"aos", "soa", "par"};
+    std::vector<int> thread_counts{-1};
+    std::vector<std::string> partitioners{"auto"};
+    int repetitions{3};     // Ejecuciones de cada caso; se guarda la más rápida
+    std::string reference;  // Front end cuya imagen sirve de referencia del error
+  };
+
+  // Lee un plan de líneas "clave: valores"; las líneas vacías y las que empiezan por # se
+  // ignoran. Claves: config (obligatoria), scene (una o más líneas), frontends (aos, soa o
+  // par), threads (-1 o positivos), partitioners (auto, simple o static), repetitions y
+  // reference (por defecto, el primer front end). Lanza std::invalid_argument si falta una
+  // clave obligatoria o algún valor no es válido.
+  bench_plan parse_bench_plan(std::istream & in);
+
+  // Igual que parse_bench_plan, a partir de un fichero. Lanza std::runtime_error si no se puede
+  // abrir.
+  bench_plan read_bench_plan(std::string const & path);
+
+}  // namespace render
+
+#endif
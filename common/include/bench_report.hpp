@@ -0,0 +1,62 @@
+#ifndef RENDER_BENCH_REPORT_HPP
+#define RENDER_BENCH_REPORT_HPP
+
+#include "image_io.hpp"
+
+#include <istream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Resultado de un caso de la matriz de bench_plan
+  struct bench_result {
+    std::string frontend;
+    std::string scene;
+    int threads{1};               // -1: los que elija TBB; 1 en aos y soa
+    std::string partitioner{"-"};  // "-" en aos y soa
+    double wall_seconds{0.0};     // Ejecución completa del programa, la más rápida
+    double rays_per_second{0.0};  // Rayos primarios (ancho x alto x muestras) por segundo
+    long peak_rss_kib{0};         // Máximo de memoria residente
+    double rmse{0.0};             // Error con la imagen de referencia, en niveles de 0 a 255
+    int max_error{0};
+  };
+
+  // Diferencia entre dos imágenes de las mismas dimensiones
+  struct image_difference {
+    double rmse{0.0};
+    int max_error{0};
+  };
+
+  // Compara canal a canal. Lanza std::invalid_argument si las dimensiones no coinciden.
+  [[nodiscard]] image_difference compare_images(ppm_image const & a, ppm_image const & b);
+
+  // Caso más lento que su referencia por encima del umbral
+  struct bench_regression {
+    bench_result current;
+    double baseline_seconds{0.0};
+    double slowdown{0.0};  // current / baseline - 1
+  };
+
+  // Resultados como un array JSON de objetos y como CSV con cabecera
+  [[nodiscard]] std::string bench_results_json(std::span<bench_result const> results);
+  [[nodiscard]] std::string bench_results_csv(std::span<bench_result const> results);
+
+  // Lee un CSV escrito por bench_results_csv. Lanza std::invalid_argument si la cabecera o
+  // alguna fila no tienen el formato esperado.
+  std::vector<bench_result> parse_bench_results_csv(std::istream & in);
+
+  // Igual que parse_bench_results_csv, a partir de un fichero. Lanza std::runtime_error si no se
+  // puede abrir.
+  std::vector<bench_result> read_bench_results_csv(std::string const & path);
+
+  // Casos cuyo tiempo supera al de la referencia con el mismo front end, escena, hilos y
+  // partitioner en más de threshold (0.1 es un 10 %). Los casos sin referencia se ignoran.
+  [[nodiscard]] std::vector<bench_regression>
+      find_regressions(std::span<bench_result const> current,
+                       std::span<bench_result const> baseline, double threshold);
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef RENDER_BINARY_IO_HPP
+#define RENDER_BINARY_IO_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace render {
+
+  // Lectura y escritura de valores en el orden de bytes de la máquina, para ficheros intermedios
+  // que se leen en la misma arquitectura que los escribe. Los datos pasan por un búfer de bytes
+  // para no reinterpretar punteros.
+
+  constexpr std::size_t raw_copy_chunk = std::size_t{1} << 16U;
+
+  template <typename T>
+  void write_raw(std::ostream & out, T const & value) {
+    std::array<char, sizeof(T)> bytes{};
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    out.write(bytes.data(), bytes.size());
+  }
+
+  template <typename T>
+  [[nodiscard]] T read_raw(std::istream & in) {
+    std::array<char, sizeof(T)> bytes{};
+    in.read(bytes.data(), bytes.size());
+    T value{};
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  void write_raw_span(std::ostream & out, std::span<T const> values) {
+    std::vector<char> buffer(std::min(raw_copy_chunk, values.size_bytes()));
+    for (std::size_t done = 0; done < values.size_bytes(); done += buffer.size()) {
+      std::size_t const bytes = std::min(buffer.size(), values.size_bytes() - done);
+      std::memcpy(buffer.data(), std::as_bytes(values).subspan(done).data(), bytes);
+      out.write(buffer.data(), static_cast<std::streamsize>(bytes));
+    }
+  }
+
+  // Lee count valores en values. Si el flujo se acaba antes, in queda en estado de error.
+  template <typename T>
+  void read_raw_vector(std::istream & in, std::vector<T> & values, std::size_t count) {
+    values.resize(count);
+    auto const target = std::as_writable_bytes(std::span{values});
+    std::vector<char> buffer(std::min(raw_copy_chunk, target.size()));
+    for (std::size_t done = 0; done < target.size() and in; done += buffer.size()) {
+      std::size_t const bytes = std::min(buffer.size(), target.size() - done);
+      in.read(buffer.data(), static_cast<std::streamsize>(bytes));
+      std::memcpy(target.subspan(done).data(), buffer.data(), bytes);
+    }
+  }
+
+}  // namespace render
+
+#endif
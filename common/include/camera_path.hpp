@@ -0,0 +1,22 @@
+#ifndef RENDER_CAMERA_PATH_HPP
+#define RENDER_CAMERA_PATH_HPP
+
+#include "config.hpp"
+#include <string>
+
+namespace render {
+
+  // Configuración del fotograma frame de una secuencia. La cámara (posición, objetivo, norte y
+  // campo de visión) se interpola linealmente entre los dos fotogramas clave que lo rodean;
+  // antes del primero y después del último se mantiene la del extremo. Sin fotogramas clave
+  // devuelve cfg sin cambios.
+  [[nodiscard]] config frame_config(config const & cfg, int frame);
+
+  // Ruta de salida del fotograma: la última serie de # del nombre se sustituye por el número
+  // con ceros a la izquierda ("vuelta_###.ppm" -> "vuelta_007.ppm"). Si no hay ninguna, se añade
+  // "_0007" antes de la extensión.
+  [[nodiscard]] std::string frame_output_path(std::string const & pattern, int frame);
+
+}  // namespace render
+
+#endif
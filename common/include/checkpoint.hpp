@@ -0,0 +1,56 @@
+#ifndef RENDER_CHECKPOINT_HPP
+#define RENDER_CHECKPOINT_HPP
+
+#include "sampling.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Datos que identifican un render a medias. Las filas [0, rows_done) están terminadas con
+  // todas sus muestras; las demás se rehacen al reanudar. No hace falta guardar el estado de los
+  // generadores aleatorios porque cada fila o fragmento tiene su propio flujo.
+  struct checkpoint_header {
+    int width{0};
+    int height{0};
+    int band_height{0};
+    int rows_done{0};
+    std::uint64_t fingerprint{0};
+    // Estrategia ya resuelta y ray_streams con los que se renderizaron las filas terminadas. Con
+    // otros valores las filas que faltan usarían otros flujos aleatorios.
+    parallel_strategy strategy{parallel_strategy::rows};
+    int ray_streams{1};
+  };
+
+  // Punto de control leído de disco: bytes ya cuantizados de las filas terminadas y, si el render
+  // guarda color lineal, sus float RGB intercalados
+  struct checkpoint {
+    checkpoint_header header;
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    std::vector<float> linear;
+  };
+
+  // Fichero de puntos de control que acompaña a una salida: la misma ruta con ".ckpt" añadido
+  [[nodiscard]] std::string checkpoint_path_for(std::string const & output_path);
+
+  // Huella FNV-1a de 64 bits del contenido de los ficheros, en orden. Un punto de control solo
+  // se reanuda con la misma configuración y la misma escena.
+  [[nodiscard]] std::uint64_t fingerprint_files(std::span<std::string const> filenames);
+
+  // Escribe el punto de control en un fichero temporal y lo renombra sobre filename, así que una
+  // interrupción a mitad deja intacto el anterior. Cada canal tiene rows_done * width bytes y
+  // linear está vacío o tiene tres float por píxel.
+  void write_checkpoint(std::string const & filename, checkpoint_header const & header,
+                        std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                        std::span<std::uint8_t const> b, std::span<float const> linear);
+
+  [[nodiscard]] checkpoint read_checkpoint(std::string const & filename);
+
+}  // namespace render
+
+#endif
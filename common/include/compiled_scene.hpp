@@ -0,0 +1,45 @@
+#ifndef RENDER_COMPILED_SCENE_HPP
+#define RENDER_COMPILED_SCENE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace render {
+
+  class scene;
+
+  // Escena compilada: formato binario que se carga sin volver a interpretar texto. Tras una
+  // cabecera de 128 bytes vienen, cada sección alineada a 64 bytes para leerla directamente de
+  // la proyección en memoria:
+  //   - la tabla de materiales (tipo, nombre y parámetros) y el bloque de nombres,
+  //   - el tipo de cada objeto en orden de escena,
+  //   - las esferas y los cilindros como arrays separados por componente (SoA).
+  // Los valores van en el orden de bytes de la máquina que lo escribe; la cabecera lleva una
+  // marca para rechazar ficheros de otra arquitectura.
+  inline constexpr std::array<char, 8> compiled_scene_magic{'R', 'N', 'D', 'S', 'C', 'N', '\r',
+                                                            '\n'};
+  inline constexpr std::uint32_t compiled_scene_version = 2;
+
+  // Escribe la escena en formato compilado. source_fingerprint es la huella del texto del que
+  // procede (fingerprint_files), o 0 si no se conoce.
+  void write_compiled_scene(std::string const & path, scene const & scn,
+                            std::uint64_t source_fingerprint = 0);
+
+  // Carga una escena compilada. Lanza std::runtime_error si el fichero no es una escena
+  // compilada, es de otra versión o arquitectura, o está truncado o dañado.
+  void load_compiled_scene(std::string const & path, scene & scn);
+
+  // Huella del texto de origen guardada en la cabecera. Lanza std::runtime_error si el fichero
+  // no es una escena compilada de esta versión.
+  [[nodiscard]] std::uint64_t compiled_scene_source(std::string const & path);
+
+  // Indica si el fichero empieza por la firma de una escena compilada
+  [[nodiscard]] bool is_compiled_scene(std::string const & path);
+
+  // Carga una escena en texto o compilada, según su firma
+  void load_scene_file(std::string const & path, scene & scn);
+
+}  // namespace render
+
+#endif
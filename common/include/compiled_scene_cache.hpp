@@ -0,0 +1,33 @@
+#ifndef RENDER_COMPILED_SCENE_CACHE_HPP
+#define RENDER_COMPILED_SCENE_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace render {
+
+  class scene;
+
+  // Resultado de cargar una escena a través de la caché en disco
+  enum class scene_cache_status { off, hit, miss };
+
+  [[nodiscard]] std::string_view to_string(scene_cache_status status);
+
+  // Fichero de la caché para una escena con la huella dada. El nombre lleva también la versión
+  // del formato compilado, así que un cambio de formato no reutiliza entradas antiguas.
+  [[nodiscard]] std::string compiled_scene_cache_path(std::string const & cache_dir,
+                                                      std::uint64_t fingerprint);
+
+  // Carga una escena a través de una caché en disco de escenas compiladas, indexada por la
+  // huella del contenido del fichero. Si la entrada existe y guarda esa huella se proyecta en
+  // memoria; si no, o si está dañada, la escena se interpreta y se guarda compilada para la
+  // próxima vez. Un fallo al guardar la entrada se avisa por std::cerr y no interrumpe la carga.
+  // Con cache_dir vacío, o si la escena ya está compilada, equivale a load_scene_file y devuelve
+  // off.
+  scene_cache_status load_scene_cached(std::string const & path, std::string const & cache_dir,
+                                       scene & scn);
+
+}  // namespace render
+
+#endif
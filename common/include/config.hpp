@@ -4,9 +4,20 @@
 #include "vector.hpp"
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace render {
 
+  // Fotograma clave de la trayectoria de la cámara. time es el número de fotograma, que puede
+  // ser fraccionario.
+  struct camera_keyframe {
+    double time;
+    vector position;
+    vector target;
+    vector north;
+    double field_of_view;
+  };
+
   // Almacena la configuración para el renderizado
   class config {
   public:
@@ -48,6 +59,25 @@ namespace render {
     [[nodiscard]] int get_num_threads() const { return num_threads; }
     [[nodiscard]] int get_grain_size() const { return grain_size; }
     [[nodiscard]] std::string get_partitioner() const { return partitioner; }
+    [[nodiscard]] std::string get_parallel_strategy() const { return parallel_strategy; }
+    [[nodiscard]] std::string get_numa() const { return numa; }
+    [[nodiscard]] std::string get_numa_scene() const { return numa_scene; }
+    [[nodiscard]] int get_tile_height() const { return tile_height; }
+    [[nodiscard]] std::string get_scheduler() const { return scheduler; }
+    [[nodiscard]] std::string get_thread_affinity() const { return thread_affinity; }
+    [[nodiscard]] int get_ray_streams() const { return ray_streams; }
+    [[nodiscard]] std::string get_output_format() const { return output_format; }
+    [[nodiscard]] std::string get_framebuffer() const { return framebuffer; }
+    [[nodiscard]] int get_stream_window() const { return stream_window; }
+    [[nodiscard]] std::string get_mmap_output() const { return mmap_output; }
+    [[nodiscard]] double get_checkpoint_interval() const { return checkpoint_interval; }
+    [[nodiscard]] int get_frame_count() const { return frame_count; }
+
+    // Fotogramas clave de la cámara, en orden de tiempo creciente
+    [[nodiscard]] std::vector<camera_keyframe> const & get_camera_keyframes() const {
+      return camera_keyframes;
+    }
+    [[nodiscard]] std::string get_scene_cache_dir() const { return scene_cache_dir; }
 
     // Setters con validación
     void set_aspect_ratio(int width, int height);
@@ -64,6 +94,21 @@ namespace render {
     void set_num_threads(int n);
     void set_grain_size(int s);
     void set_partitioner(std::string const & p);
+    void set_parallel_strategy(std::string const & s);
+    void set_numa(std::string const & value);
+    void set_numa_scene(std::string const & value);
+    void set_tile_height(int value);
+    void set_scheduler(std::string const & value);
+    void set_thread_affinity(std::string const & value);
+    void set_ray_streams(int value);
+    void set_output_format(std::string const & value);
+    void set_framebuffer(std::string const & value);
+    void set_stream_window(int value);
+    void set_mmap_output(std::string const & value);
+    void set_checkpoint_interval(double value);
+    void set_frame_count(int value);
+    void add_camera_keyframe(camera_keyframe const & key);
+    void set_scene_cache_dir(std::string const & value);
     void set_background_dark_color(vector const & color);
     void set_background_light_color(vector const & color);
 
@@ -92,6 +137,21 @@ namespace render {
     int num_threads{-1};
     int grain_size{1};
     std::string partitioner{"auto"};
+    std::string parallel_strategy{"auto"};
+    std::string numa{"off"};
+    std::string numa_scene{"shared"};
+    int tile_height{16};
+    std::string scheduler{"tbb"};
+    std::string thread_affinity{"none"};
+    int ray_streams{1};
+    std::string output_format{"auto"};
+    std::string framebuffer{"ldr"};
+    int stream_window{0};
+    std::string mmap_output{"off"};
+    double checkpoint_interval{0.0};
+    int frame_count{1};
+    std::vector<camera_keyframe> camera_keyframes;
+    std::string scene_cache_dir;  // Vacío: sin caché de escenas compiladas
 
     // Colores de fondo para el gradiente
     vector background_dark_color{0.25, 0.5, 1.0};
@@ -101,6 +161,10 @@ namespace render {
   // Carga configuración desde archivo de texto
   void load_config(std::string const & path, config & out);
 
+  // Aplica sobre out líneas con el mismo formato que el archivo ("clave: valores"). Sirve para
+  // sobrescribir algunas claves de una configuración ya cargada.
+  void apply_config_text(std::string const & text, config & out);
+
 }  // namespace render
 
 #endif
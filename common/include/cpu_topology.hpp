@@ -0,0 +1,36 @@
+#ifndef RENDER_CPU_TOPOLOGY_HPP
+#define RENDER_CPU_TOPOLOGY_HPP
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace render {
+
+  // Núcleo físico con sus CPU lógicas (hermanas SMT) en orden creciente
+  struct cpu_core {
+    int package;
+    int core;
+    std::vector<int> cpus;
+  };
+
+  // Interpreta una lista de CPU del kernel ("0-3,8,10-11"). Lanza si el formato no es válido.
+  std::vector<int> parse_cpu_list(std::string_view text);
+
+  // Agrupa las CPU permitidas por núcleo físico leyendo <sysfs_root>/cpuN/topology. Una CPU sin
+  // información de topología se trata como un núcleo propio. Núcleos ordenados por (paquete,
+  // núcleo).
+  std::vector<cpu_core> read_cpu_topology(std::filesystem::path const & sysfs_root,
+                                          std::span<int const> allowed_cpus);
+
+  // CPU lógicas en el orden en que se asignan a los hilos según la política:
+  //   none  -> vacío (sin afinidad)
+  //   cores -> la primera CPU de cada núcleo físico, sin usar las hermanas SMT
+  //   smt   -> todas las CPU, primero una por núcleo y después sus hermanas
+  std::vector<int> affinity_plan(std::span<cpu_core const> cores, std::string const & policy);
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef RENDER_HDR_IMAGE_HPP
+#define RENDER_HDR_IMAGE_HPP
+
+#include "color.hpp"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Imagen en color lineal sin gamma ni cuantización, con tres float por píxel (RGB
+  // intercalado, fila 0 arriba). Permite reaplicar gamma o sumar más muestras sin re-renderizar.
+  class hdr_image {
+  public:
+    hdr_image() = default;
+    hdr_image(int width, int height);
+
+    [[nodiscard]] int get_width() const { return width; }
+
+    [[nodiscard]] int get_height() const { return height; }
+
+    [[nodiscard]] bool empty() const { return values.empty(); }
+
+    [[nodiscard]] color get_pixel(int x, int y) const;
+    void set_pixel(int x, int y, color const & value);
+
+    // Copia filas completas a partir de row_begin. pixels tiene un número entero de filas.
+    void set_rows(int row_begin, std::span<color const> pixels);
+
+    // Colores de las filas [row_begin, row_end) en out, que debe tener el tamaño justo
+    void get_rows(int row_begin, int row_end, std::span<color> out) const;
+
+    [[nodiscard]] std::span<float const> data() const { return values; }
+
+    [[nodiscard]] std::span<float> data() { return values; }
+
+  private:
+    [[nodiscard]] std::size_t offset(int x, int y) const;
+
+    int width{0};
+    int height{0};
+    std::vector<float> values;
+  };
+
+  // Render parcial con su peso en la mezcla (normalmente sus muestras por píxel)
+  struct weighted_hdr {
+    std::string path;
+    double weight{1.0};
+  };
+
+  // Interpreta "fichero.pfm@spp". Sin "@" el peso es 1; un peso no positivo es un error.
+  [[nodiscard]] weighted_hdr parse_weighted_hdr(std::string const & argument);
+
+  // Media ponderada de imágenes del mismo tamaño. Se acumula en double antes de volver a float.
+  [[nodiscard]] hdr_image merge_hdr(std::span<hdr_image const> images,
+                                    std::span<double const> weights);
+
+  // Fichero PFM que acompaña a una salida PPM: misma ruta con la extensión cambiada a .pfm. Si
+  // la salida ya acaba en .pfm se usa .hdr.pfm, para no escribir las dos en el mismo fichero.
+  [[nodiscard]] std::string hdr_path_for(std::string const & output_path);
+
+  // Escribe un PFM en color ("PF"). Las filas van de abajo arriba, como exige el formato, y los
+  // float en el orden de bytes de la máquina, indicado por el signo de la escala.
+  void write_pfm(std::string const & filename, hdr_image const & image);
+
+  // Lee un PFM en color de cualquier orden de bytes
+  [[nodiscard]] hdr_image read_pfm(std::string const & filename);
+
+}  // namespace render
+
+#endif
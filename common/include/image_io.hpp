@@ -0,0 +1,152 @@
+#ifndef RENDER_IMAGE_IO_HPP
+#define RENDER_IMAGE_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace render {
+
+  // Formatos de salida
+  enum class image_format {
+    p3,   // Texto: un valor decimal por canal, un píxel por línea
+    p6,   // Binario: tres bytes RGB por píxel
+    qoi,  // Comprimido sin pérdidas (QOI)
+  };
+
+  // Resuelve output_format ("auto", "p3", "p6" o "qoi"). Con "auto" se usa P6 para la
+  // extensión .pnm, QOI para .qoi y P3 en cualquier otro caso, que es el formato que espera
+  // scripts/compare_ppm.py.
+  [[nodiscard]] image_format resolve_image_format(std::string const & setting,
+                                                  std::string const & path);
+
+  // Cabecera PPM ("P3" o "P6", dimensiones y valor máximo 255)
+  [[nodiscard]] std::string ppm_header(image_format format, int width, int height);
+
+  // Intercala los canales r, g y b en out (3 bytes por píxel). out debe tener 3 * r.size()
+  void interleave_rgb(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                      std::span<std::uint8_t const> b, std::span<char> out);
+
+  // Píxeles por bloque del codificador P3 paralelo
+  constexpr std::size_t p3_chunk_pixels = 16'384;
+
+  // Bytes que ocupan en P3 los píxeles de los canales dados ("r g b\n" por píxel)
+  [[nodiscard]] std::size_t p3_text_length(std::span<std::uint8_t const> r,
+                                           std::span<std::uint8_t const> g,
+                                           std::span<std::uint8_t const> b);
+
+  // Escribe en out el texto P3 de los píxeles con una tabla de dígitos precalculada y devuelve
+  // los bytes escritos. out debe tener al menos p3_text_length(r, g, b) bytes.
+  std::size_t encode_p3_pixels(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                               std::span<std::uint8_t const> b, std::span<char> out);
+
+  // Fichero P3 completo (cabecera incluida). Los bloques se miden y se codifican en paralelo con
+  // TBB, cada uno en su posición exacta calculada con una suma de prefijos. El resultado es
+  // idéntico byte a byte al de escribir cada valor con operator<<.
+  [[nodiscard]] std::string encode_p3(int width, int height, std::span<std::uint8_t const> r,
+                                      std::span<std::uint8_t const> g,
+                                      std::span<std::uint8_t const> b);
+
+  // Escribe el P3 de encode_p3 en una única escritura
+  void write_p3(std::string const & filename, int width, int height,
+                std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                std::span<std::uint8_t const> b);
+
+  // Escribe un P6 con la cabecera y los píxeles RGB intercalados en una única escritura
+  void write_p6(std::string const & filename, int width, int height, std::span<char const> rgb);
+
+  // Igual que write_p6 pero a partir de canales separados
+  void write_p6(std::string const & filename, int width, int height,
+                std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                std::span<std::uint8_t const> b);
+
+  // Imagen PPM leída, con los píxeles RGB intercalados (3 bytes por píxel)
+  struct ppm_image {
+    int width{0};
+    int height{0};
+    std::vector<std::uint8_t> rgb;
+  };
+
+  // Lee un P3 o un P6 con valor máximo 255. Lanza std::runtime_error si no se puede abrir, la
+  // cabecera no es válida o faltan píxeles.
+  [[nodiscard]] ppm_image read_ppm(std::string const & filename);
+
+  // Cabecera QOI de 14 bytes (3 canales, sRGB) y marca de fin de 8 bytes
+  [[nodiscard]] std::string qoi_header(int width, int height);
+  [[nodiscard]] std::string qoi_end_marker();
+
+  // Píxeles por franja del codificador QOI paralelo
+  constexpr std::size_t qoi_chunk_pixels = 65'536;
+
+  // Añade a out los píxeles codificados en QOI como una franja independiente: no supone nada
+  // del píxel anterior ni de la tabla de colores, así que su primer píxel va completo y solo
+  // se referencian entradas de la tabla escritas dentro de la franja. Cualquier decodificador
+  // QOI lee bien la concatenación de franjas, que pueden codificarse en paralelo.
+  void append_qoi_pixels(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                         std::span<std::uint8_t const> b, std::string & out);
+
+  // Fichero QOI completo, con las franjas de qoi_chunk_pixels codificadas en paralelo con TBB
+  [[nodiscard]] std::string encode_qoi(int width, int height, std::span<std::uint8_t const> r,
+                                       std::span<std::uint8_t const> g,
+                                       std::span<std::uint8_t const> b);
+
+  // Escribe el QOI de encode_qoi en una única escritura
+  void write_qoi(std::string const & filename, int width, int height,
+                 std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                 std::span<std::uint8_t const> b);
+
+  // Escribe la imagen completa en el formato dado con write_p3, write_p6 o write_qoi
+  void write_image(std::string const & filename, image_format format, int width, int height,
+                   std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                   std::span<std::uint8_t const> b);
+
+  // Cabecera del formato dado (PPM o QOI) y bytes que cierran el fichero (solo en QOI)
+  [[nodiscard]] std::string image_header(image_format format, int width, int height);
+  [[nodiscard]] std::string image_trailer(image_format format);
+
+  // Añade a out los píxeles codificados en el formato dado, sin cabecera. Las llamadas
+  // sucesivas con filas consecutivas forman el cuerpo completo del fichero.
+  void append_encoded_pixels(image_format format, std::span<std::uint8_t const> r,
+                             std::span<std::uint8_t const> g, std::span<std::uint8_t const> b,
+                             std::string & out);
+
+  // Escribe una imagen por bandas de filas, en orden: la cabecera al crearlo, cada banda al
+  // recibirla y el cierre en finish. Solo guarda la banda en curso, de modo que la memoria no
+  // depende del tamaño de la imagen.
+  class image_stream_writer {
+  public:
+    image_stream_writer(std::string filename, image_format format, int width, int height);
+
+    [[nodiscard]] image_format get_format() const { return format; }
+
+    [[nodiscard]] int get_rows_written() const { return rows_written; }
+
+    // Codifica y escribe las siguientes filas completas de la imagen
+    void write_rows(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                    std::span<std::uint8_t const> b);
+
+    // Escribe rows filas ya codificadas con append_encoded_pixels
+    void write_encoded(int rows, std::string_view bytes);
+
+    // Escribe el cierre del formato y el fichero. Falla si no se han escrito todas las filas.
+    void finish();
+
+  private:
+    void write(std::string_view bytes);
+
+    std::string filename;
+    image_format format;
+    int width;
+    int height;
+    int rows_written{0};
+    std::ofstream out;
+    std::string scratch;
+  };
+
+}  // namespace render
+
+#endif
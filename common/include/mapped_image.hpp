@@ -0,0 +1,55 @@
+#ifndef RENDER_MAPPED_IMAGE_HPP
+#define RENDER_MAPPED_IMAGE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <span>
+#include <string>
+
+namespace render {
+
+  // Fichero P6 proyectado en memoria. El tamaño final (cabecera más 3 bytes por píxel) se
+  // conoce de antemano, así que se reserva con ftruncate, se escribe la cabecera y los hilos de
+  // render cuantizan cada banda directamente en sus páginas, sin búfer de imagen intermedio ni
+  // pasada de guardado. Solo para sistemas POSIX.
+  class mapped_p6_file {
+  public:
+    mapped_p6_file(std::string filename, int width, int height);
+    ~mapped_p6_file();
+
+    mapped_p6_file(mapped_p6_file const &)             = delete;
+    mapped_p6_file & operator=(mapped_p6_file const &) = delete;
+    mapped_p6_file(mapped_p6_file &&)                  = delete;
+    mapped_p6_file & operator=(mapped_p6_file &&)      = delete;
+
+    [[nodiscard]] int get_width() const { return width; }
+
+    [[nodiscard]] int get_height() const { return height; }
+
+    // Bytes RGB intercalados de las filas [row_begin, row_end) dentro del fichero
+    [[nodiscard]] std::span<char> rows(int row_begin, int row_end);
+
+    // Empieza a escribir a disco las filas dadas sin esperar (msync asíncrono), para que la
+    // escritura se solape con el render del resto de la imagen
+    void flush_rows(int row_begin, int row_end);
+
+    // Espera a que todo esté en disco (msync síncrono), deshace la proyección y cierra
+    void finish();
+
+  private:
+    // Libera lo reservado y lanza system_error con el errno actual
+    [[noreturn]] void fail(std::string const & message);
+    void release() noexcept;
+
+    std::string filename;
+    int width;
+    int height;
+    std::size_t header_size{0};
+    std::size_t file_size{0};
+    std::FILE * file{nullptr};
+    char * data{nullptr};
+  };
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef RENDER_SAMPLING_HPP
+#define RENDER_SAMPLING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace render {
+
+  // Número máximo de muestras que procesa cada fragmento en la estrategia por muestras
+  constexpr int samples_per_chunk = 64;
+
+  // Por debajo de estas filas el reparto por filas deja núcleos ociosos en una máquina de hasta
+  // 64 hilos, y conviene repartir también las muestras de cada píxel
+  constexpr int few_rows = 64;
+
+  // Estrategias de paralelización del bucle de render
+  enum class parallel_strategy {
+    rows,     // Reparto por filas completas
+    samples,  // Reparto por (píxel, fragmento de muestras) con reducción determinista
+  };
+
+  // Resuelve la estrategia pedida ("auto", "rows" o "samples") para una imagen concreta. "auto"
+  // sólo elige samples si la imagen tiene menos de few_rows filas y las muestras de cada píxel
+  // se dividen en más de un fragmento; si no, el reparto por muestras no gana paralelismo y sí
+  // paga dos generadores por fragmento. Las dos estrategias usan flujos aleatorios distintos,
+  // así que la decisión no depende del número de hilos: la misma configuración da la misma
+  // imagen con cualquier num_threads.
+  [[nodiscard]] parallel_strategy choose_parallel_strategy(std::string const & requested,
+                                                           int image_height,
+                                                           int samples_per_pixel);
+
+  // Número de fragmentos en que se dividen las muestras de un píxel
+  [[nodiscard]] int sample_chunk_count(int samples_per_pixel);
+
+  // Deriva una semilla reproducible para el flujo aleatorio identificado por (key, sub)
+  [[nodiscard]] std::uint64_t stream_seed(std::uint64_t base, std::uint64_t key,
+                                          std::uint64_t sub = 0);
+
+}  // namespace render
+
+#endif
@@ -3,9 +3,13 @@
 
 #include "object.hpp"
 #include "ray.hpp"
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace render {
@@ -15,8 +19,13 @@ namespace render {
   public:
     scene() = default;
 
-    // Añade un material con nombre único a la escena
-    void add_material(std::string const & name, std::unique_ptr<material> mat);
+    // Identificador denso de un material: su posición en el orden en que se añadió
+    using material_id                        = std::uint32_t;
+    static constexpr material_id no_material = ~material_id{0};
+
+    // Añade un material con nombre único a la escena y devuelve su identificador. Si ya hay uno
+    // con ese nombre lo sustituye y conserva su identificador.
+    material_id add_material(std::string_view name, std::unique_ptr<material> mat);
 
     // Añade un objeto geométrico a la escena
     void add_object(std::unique_ptr<object> obj);
@@ -24,11 +33,31 @@ namespace render {
     // Determina si un rayo interseca algún objeto en el rango [t_min, t_max]
     [[nodiscard]] bool hit(ray const & r, double t_min, double t_max, hit_record & rec) const;
 
-    // Obtiene material por nombre
-    [[nodiscard]] material const * get_material(std::string const & name) const;
+    // Identificador del material con ese nombre, o no_material si no existe
+    [[nodiscard]] material_id find_material(std::string_view name) const;
+
+    // Obtiene material por nombre, o nullptr si no existe
+    [[nodiscard]] material const * get_material(std::string_view name) const;
+
+    [[nodiscard]] material const * get_material(material_id id) const {
+      return materials[id].get();
+    }
+
+    [[nodiscard]] std::string const & get_material_name(material_id id) const { return names[id]; }
+
+    [[nodiscard]] std::size_t material_count() const { return materials.size(); }
+
+    // Objetos en el orden en que se añadieron
+    [[nodiscard]] std::vector<std::unique_ptr<object>> const & get_objects() const {
+      return objects;
+    }
 
   private:
-    std::map<std::string, std::unique_ptr<material>> materials;
+    // Materiales y sus nombres, indexados por identificador. Los nombres están en un deque
+    // porque no se mueven al crecer, así que las claves de material_ids pueden apuntar a ellos.
+    std::vector<std::unique_ptr<material>> materials;
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, material_id> material_ids;
     std::vector<std::unique_ptr<object>> objects;
   };
 
@@ -0,0 +1,69 @@
+#ifndef RENDER_SCENE_CACHE_HPP
+#define RENDER_SCENE_CACHE_HPP
+
+#include "compiled_scene_cache.hpp"
+#include "scene.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace render {
+
+  // Escenas ya leídas, indexadas por la huella de su contenido: si el fichero cambia se vuelve
+  // a leer, y dos rutas con el mismo contenido comparten la escena. Guarda como mucho capacity
+  // escenas y descarta la usada hace más tiempo. No es segura entre hilos.
+  //
+  // La huella de cada ruta se recuerda junto con el dispositivo, el inodo, el tamaño y la fecha
+  // de modificación del fichero, y sólo se vuelve a calcular si alguno cambia. Un fichero
+  // modificado menos de un segundo antes de calcular su huella se vuelve a leer siempre, porque
+  // otra escritura en ese intervalo podría dejar la misma fecha.
+  class scene_cache {
+  public:
+    explicit scene_cache(std::size_t capacity);
+
+    struct lookup {
+      std::shared_ptr<scene const> value;
+      bool hit;
+      scene_cache_status disk{scene_cache_status::off};  // Solo si no estaba en memoria
+    };
+
+    // Escena del fichero, leída ahora o tomada de la caché. Si no está en memoria se carga a
+    // través de la caché en disco de disk_cache_dir, cuando no está vacío.
+    [[nodiscard]] lookup get(std::string const & path, std::string const & disk_cache_dir = {});
+
+    [[nodiscard]] std::size_t size() const { return entries.size(); }
+
+  private:
+    struct entry {
+      std::uint64_t key;
+      std::shared_ptr<scene const> value;
+    };
+
+    struct file_stamp {
+      std::uint64_t device;
+      std::uint64_t inode;
+      std::int64_t size;
+      std::int64_t mtime_ns;
+
+      bool operator==(file_stamp const &) const = default;
+    };
+
+    struct known_file {
+      file_stamp stamp;
+      std::uint64_t key;
+      bool settled;  // La fecha de modificación basta para saber si el fichero cambia
+    };
+
+    [[nodiscard]] std::uint64_t key_for(std::string const & path);
+
+    std::size_t capacity;
+    std::list<entry> entries;  // La usada más recientemente, primero
+    std::unordered_map<std::string, known_file> files;
+  };
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef RENDER_SCENE_GENERATOR_HPP
+#define RENDER_SCENE_GENERATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace render {
+
+  class scene;
+
+  // Distribución de los objetos en el espacio
+  enum class scene_layout {
+    uniform,    // Uniforme en una caja
+    clustered,  // Agrupados alrededor de centros uniformes
+    grid,       // Rejilla con desplazamiento aleatorio sobre el plano, como scene4
+  };
+
+  // Parámetros de una escena sintética. La misma semilla y los mismos parámetros dan siempre la
+  // misma escena.
+  struct scene_generator_options {
+    std::size_t object_count{1'000};
+    std::uint64_t seed{1};
+    double cylinder_fraction{0.5};                // Proporción de cilindros entre los objetos
+    std::array<double, 3> material_mix{1, 1, 1};  // Pesos de matte, metal y refractive
+    std::size_t material_count{64};               // 0: un material por objeto, como scene4
+    scene_layout layout{scene_layout::uniform};
+  };
+
+  // Interpreta "uniform", "clustered" o "grid". Lanza std::invalid_argument con otro valor.
+  [[nodiscard]] scene_layout parse_scene_layout(std::string const & name);
+
+  // Añade a la escena los materiales y objetos generados. Lanza std::invalid_argument si los
+  // parámetros no son válidos.
+  void generate_scene(scene_generator_options const & options, scene & scn);
+
+  // Escribe la escena en el formato de texto de las escenas, con los valores de modo que al
+  // leerla se obtengan exactamente los mismos
+  void write_scene_text(scene const & scn, std::ostream & out);
+
+}  // namespace render
+
+#endif
@@ -2,6 +2,7 @@
 #define RENDER_SCENE_PARSER_HPP
 
 #include <string>
+#include <string_view>
 
 namespace render {
 
@@ -14,6 +15,9 @@ namespace render {
   // Carga una escena desde un archivo de texto con materiales y objetos
   void parse_scene_file(std::string const & path, scene & scn);
 
+  // Igual que parse_scene_file, a partir del texto completo de la escena ya en memoria
+  void parse_scene_text(std::string_view text, scene & scn);
+
 }  // namespace render
 
 #endif
@@ -0,0 +1,79 @@
+#ifndef RENDER_SHARD_HPP
+#define RENDER_SHARD_HPP
+
+#include "sampling.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Parte index de count de un fotograma repartido entre procesos. Se queda con las bandas
+  // index, index + count, index + 2 * count... de modo que las zonas caras de la escena se
+  // reparten entre todas las partes. 0/1 es el fotograma completo.
+  struct shard_spec {
+    int index{0};
+    int count{1};
+  };
+
+  // Interpreta "i/N" con 0 <= i < N
+  [[nodiscard]] shard_spec parse_shard_spec(std::string const & text);
+
+  [[nodiscard]] bool shard_owns_band(shard_spec spec, std::size_t band);
+
+  // Datos comunes a todas las partes de un mismo render
+  struct shard_header {
+    int width{0};
+    int height{0};
+    int band_height{0};
+    shard_spec part;
+    std::uint64_t fingerprint{0};
+    std::string output_format;  // output_format de la configuración
+    // Estrategia ya resuelta y ray_streams: deciden los flujos aleatorios de cada píxel, así
+    // que partes renderizadas con valores distintos no forman la imagen de un único render
+    parallel_strategy strategy{parallel_strategy::rows};
+    int ray_streams{1};
+  };
+
+  // Filas de las bandas que tiene la parte
+  [[nodiscard]] int shard_rows(shard_header const & header);
+
+  // Una parte leída de disco: los bytes cuantizados de sus bandas, seguidas y en orden, y si el
+  // render guarda color lineal, sus float RGB intercalados
+  struct shard {
+    shard_header header;
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    std::vector<float> linear;
+  };
+
+  // Cada canal tiene shard_rows(header) * width bytes y linear está vacío o tiene tres float
+  // por píxel
+  void write_shard(std::ostream & out, shard_header const & header,
+                   std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                   std::span<std::uint8_t const> b, std::span<float const> linear);
+  void write_shard_file(std::string const & filename, shard_header const & header,
+                        std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                        std::span<std::uint8_t const> b, std::span<float const> linear);
+
+  [[nodiscard]] shard read_shard(std::istream & in);
+  [[nodiscard]] shard read_shard_file(std::string const & filename);
+
+  // Junta todas las partes de un render en el fotograma completo (parte 0/1). Falla si falta o
+  // se repite alguna parte o si no vienen del mismo render.
+  [[nodiscard]] shard merge_shards(std::span<shard const> shards);
+
+  // Escribe un fotograma completo en output_path, banda a banda como render-par, así que el
+  // fichero es idéntico al de un render en un solo proceso. Si lleva color lineal escribe
+  // también su PFM.
+  void write_shard_image(shard const & frame, std::string const & output_path);
+
+}  // namespace render
+
+#endif
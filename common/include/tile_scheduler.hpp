@@ -0,0 +1,99 @@
+#ifndef RENDER_TILE_SCHEDULER_HPP
+#define RENDER_TILE_SCHEDULER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace render {
+
+  // Cola Chase-Lev de capacidad fija. El propietario inserta y extrae por abajo (LIFO) y los
+  // demás hilos roban por arriba (FIFO) sin bloqueos. No crece: todas las inserciones se hacen
+  // antes de empezar a extraer, así que la capacidad es el número de elementos asignados.
+  class work_stealing_deque {
+  public:
+    explicit work_stealing_deque(std::size_t capacity);
+
+    // Inserta un elemento (sólo el propietario)
+    void push(std::size_t item);
+
+    // Extrae el último elemento insertado (sólo el propietario)
+    [[nodiscard]] std::optional<std::size_t> pop();
+
+    // Roba el elemento más antiguo (cualquier hilo). Devuelve nullopt si está vacía o si otro
+    // hilo ganó la carrera por el mismo elemento.
+    [[nodiscard]] std::optional<std::size_t> steal();
+
+    // Número aproximado de elementos pendientes
+    [[nodiscard]] std::size_t size_hint() const;
+
+  private:
+    // Índices en líneas de caché distintas: los ladrones escriben top_ y el propietario bottom_
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::vector<std::atomic<std::size_t>> buffer_;
+  };
+
+  // Estadísticas de una ejecución del planificador
+  struct tile_schedule_stats {
+    std::size_t steals{0};                  // Tiles ejecutados por un hilo distinto del asignado
+    std::vector<std::size_t> tiles_done;    // Tiles ejecutados por cada hilo
+    std::vector<double> busy_seconds;       // Tiempo ocupado de cada hilo
+    double elapsed_seconds{0.0};            // Tiempo total de la ejecución
+
+    // Desequilibrio relativo: (máximo - media) / media del tiempo ocupado
+    [[nodiscard]] double imbalance() const;
+  };
+
+  // Planificador de tiles con robo de trabajo. Reparte los tiles entre los hilos por coste
+  // estimado (mayor coste primero al hilo menos cargado) y, cuando un hilo se queda sin
+  // trabajo, roba al hilo con más coste pendiente. Los num_workers - 1 hilos auxiliares se
+  // crean con el planificador y esperan entre una ejecución y la siguiente, así que varias
+  // llamadas a run no vuelven a lanzar hilos.
+  class tile_scheduler {
+  public:
+    explicit tile_scheduler(int num_workers);
+    ~tile_scheduler();
+
+    tile_scheduler(tile_scheduler const &)             = delete;
+    tile_scheduler & operator=(tile_scheduler const &) = delete;
+    tile_scheduler(tile_scheduler &&)                  = delete;
+    tile_scheduler & operator=(tile_scheduler &&)      = delete;
+
+    [[nodiscard]] int get_num_workers() const { return num_workers; }
+
+    // Ejecuta body(tile, worker) una vez por cada tile de [0, costs.size()). El hilo que llama
+    // actúa como trabajador 0. Si body lanza, el resto de tiles se descarta y la excepción se
+    // relanza al terminar. No admite llamadas simultáneas desde varios hilos.
+    tile_schedule_stats run(std::span<double const> costs,
+                            std::function<void(std::size_t, int)> const & body);
+
+    // Reparto inicial por coste (LPT): para cada hilo, sus tiles en orden creciente de coste
+    [[nodiscard]] static std::vector<std::vector<std::size_t>>
+        initial_assignment(std::span<double const> costs, int num_workers);
+
+  private:
+    // Bucle de un hilo auxiliar: espera a cada ejecución y trabaja en ella como worker
+    void worker_main(std::size_t worker);
+
+    int num_workers;
+    std::mutex mutex;
+    std::condition_variable wake;      // Nueva ejecución o fin del planificador
+    std::condition_variable finished;  // Los hilos auxiliares terminaron la ejecución
+    std::function<void(std::size_t)> const * work{nullptr};
+    std::uint64_t generation{0};
+    int running{0};
+    bool stopping{false};
+    std::vector<std::jthread> threads;  // Se declara el último: los hilos usan todo lo anterior
+  };
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RENDER_TONEMAP_HPP
+#define RENDER_TONEMAP_HPP
+
+#include "color.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace render {
+
+  // Conversión por lotes de color lineal a canales de 8 bits con corrección gamma. Produce los
+  // mismos bytes que color::to_discrete_r/g/b: para el gamma dado se precalcula, con búsqueda
+  // binaria sobre los double, el menor valor lineal que da cada byte. Cada canal se resuelve
+  // después con esa tabla de umbrales, sin pow ni clamp por píxel. Una interpolación sobre una
+  // tabla de gamma no garantizaría los mismos bytes.
+  class tonemapper {
+  public:
+    explicit tonemapper(double gamma);
+
+    [[nodiscard]] double get_gamma() const { return gamma; }
+
+    // Número de tramos uniformes de [0, 1] con byte inicial precalculado
+    static constexpr std::size_t buckets = 4'096;
+
+    // Byte de un valor lineal, igual que to_discrete_*(gamma). El tramo da el primer byte
+    // candidato y se avanza por la tabla de umbrales (pocos pasos salvo cerca de 0).
+    [[nodiscard]] std::uint8_t to_discrete(double linear) const {
+      if (not(linear > 0.0)) {
+        return 0;
+      }
+      if (linear >= 1.0) {
+        return last_byte;
+      }
+      auto const bucket = static_cast<std::size_t>(linear * static_cast<double>(buckets));
+      std::size_t k     = bucket_start[bucket];
+      while (k < 255 and thresholds[k + 1] <= linear) {
+        ++k;
+      }
+      return static_cast<std::uint8_t>(k);
+    }
+
+    // Convierte los colores de pixels en los canales r, g y b (mismo tamaño que pixels)
+    void map(std::span<color const> pixels, std::span<std::uint8_t> r, std::span<std::uint8_t> g,
+             std::span<std::uint8_t> b) const;
+
+    // Igual que map, pero escribe los bytes RGB intercalados (3 * pixels.size()), como en P6
+    void map_interleaved(std::span<color const> pixels, std::span<char> rgb) const;
+
+  private:
+    double gamma;
+
+    // thresholds[k] es el menor valor lineal que produce el byte k (thresholds[0] no se usa)
+    std::array<double, 256> thresholds{};
+
+    // Byte del extremo inferior de cada tramo y byte de 1.0
+    std::array<std::uint8_t, buckets> bucket_start{};
+    std::uint8_t last_byte{255};
+  };
+
+}  // namespace render
+
+#endif
@@ -0,0 +1,54 @@
+#include "batch_file.hpp"
+
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace render {
+
+  std::vector<batch_job> parse_batch_jobs(std::istream & in) {
+    constexpr std::string_view output_command = "output";
+    std::vector<batch_job> jobs;
+    std::string line;
+    while (std::getline(in, line)) {
+      auto const first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos or line[first] == '#') {
+        continue;
+      }
+      std::string_view const text{line.data() + first, line.size() - first};
+      if (text.starts_with(output_command) and
+          (text.size() == output_command.size() or text[output_command.size()] == ' '))
+      {
+        auto const path_begin = text.find_first_not_of(' ', output_command.size());
+        auto const path_end   = text.find_last_not_of(" \t\r");
+        if (path_begin == std::string_view::npos) {
+          throw std::invalid_argument("Error: Batch job without output path: " + line);
+        }
+        jobs.push_back(batch_job{
+            .output_path = std::string{text.substr(path_begin, path_end + 1 - path_begin)},
+            .overrides   = {}});
+      } else if (jobs.empty()) {
+        throw std::invalid_argument("Error: Batch key before the first output: " + line);
+      } else {
+        jobs.back().overrides += line;
+        jobs.back().overrides += '\n';
+      }
+    }
+    if (jobs.empty()) {
+      throw std::invalid_argument("Error: Batch file has no jobs");
+    }
+    return jobs;
+  }
+
+  std::vector<batch_job> read_batch_file(std::string const & path) {
+    std::ifstream in{path};
+    if (not in) {
+      throw std::runtime_error("Error: Cannot open batch file: " + path);
+    }
+    return parse_batch_jobs(in);
+  }
+
+}  // namespace render
@@ -0,0 +1,130 @@
+#include "bench_plan.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+  constexpr std::array<std::string_view, 3> known_frontends{"aos", "soa", "par"};
+  constexpr std::array<std::string_view, 3> known_partitioners{"auto", "simple", "static"};
+
+  std::vector<std::string> split_values(std::string const & text) {
+    std::istringstream in{text};
+    std::vector<std::string> values;
+    std::string value;
+    while (in >> value) {
+      values.push_back(value);
+    }
+    return values;
+  }
+
+  int parse_int(std::string const & key, std::string const & value) {
+    int result{};
+    auto const * const end = value.data() + value.size();
+    auto const [ptr, ec]   = std::from_chars(value.data(), end, result);
+    if (ec != std::errc{} or ptr != end) {
+      throw std::invalid_argument("Error: Invalid value for bench key: [" + key + ":] " + value);
+    }
+    return result;
+  }
+
+  template <typename Known>
+  void check_known(std::string const & key, std::vector<std::string> const & values,
+                   Known const & known) {
+    for (auto const & value : values) {
+      if (std::ranges::find(known, value) == known.end()) {
+        throw std::invalid_argument("Error: Invalid value for bench key: [" + key + ":] " +
+                                    value);
+      }
+    }
+  }
+
+  void apply_key(std::string const & key, std::vector<std::string> const & values,
+                 render::bench_plan & plan) {
+    if (values.empty()) {
+      throw std::invalid_argument("Error: Bench key without values: [" + key + ":]");
+    }
+    bool const single = values.size() == 1;
+    if (key == "config" and single) {
+      plan.config_path = values[0];
+    } else if (key == "scene" and single) {
+      plan.scene_paths.push_back(values[0]);
+    } else if (key == "frontends") {
+      check_known(key, values, known_frontends);
+      plan.frontends = values;
+    } else if (key == "threads") {
+      plan.thread_counts.clear();
+      for (auto const & value : values) {
+        int const threads = parse_int(key, value);
+        if (threads != -1 and threads <= 0) {
+          throw std::invalid_argument("Error: Invalid value for bench key: [threads:] " + value);
+        }
+        plan.thread_counts.push_back(threads);
+      }
+    } else if (key == "partitioners") {
+      check_known(key, values, known_partitioners);
+      plan.partitioners = values;
+    } else if (key == "repetitions" and single) {
+      plan.repetitions = parse_int(key, values[0]);
+      if (plan.repetitions <= 0) {
+        throw std::invalid_argument("Error: Invalid value for bench key: [repetitions:] " +
+                                    values[0]);
+      }
+    } else if (key == "reference" and single) {
+      plan.reference = values[0];
+    } else {
+      throw std::invalid_argument("Error: Invalid bench key: [" + key + ":]");
+    }
+  }
+
+}  // namespace
+
+namespace render {
+
+  bench_plan parse_bench_plan(std::istream & in) {
+    bench_plan plan;
+    std::string line;
+    while (std::getline(in, line)) {
+      auto const first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos or line[first] == '#') {
+        continue;
+      }
+      auto const colon = line.find(':', first);
+      if (colon == std::string::npos) {
+        throw std::invalid_argument("Error: Bench line without key: " + line);
+      }
+      apply_key(line.substr(first, colon - first), split_values(line.substr(colon + 1)), plan);
+    }
+
+    if (plan.config_path.empty()) {
+      throw std::invalid_argument("Error: Bench plan without config");
+    }
+    if (plan.scene_paths.empty()) {
+      throw std::invalid_argument("Error: Bench plan without scenes");
+    }
+    if (plan.reference.empty()) {
+      plan.reference = plan.frontends.front();
+    } else if (std::ranges::find(plan.frontends, plan.reference) == plan.frontends.end()) {
+      throw std::invalid_argument("Error: Bench reference is not one of the front ends: " +
+                                  plan.reference);
+    }
+    return plan;
+  }
+
+  bench_plan read_bench_plan(std::string const & path) {
+    std::ifstream in{path};
+    if (not in) {
+      throw std::runtime_error("Error: Cannot open bench plan: " + path);
+    }
+    return parse_bench_plan(in);
+  }
+
+}  // namespace render
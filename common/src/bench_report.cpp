@@ -0,0 +1,248 @@
+#include "bench_report.hpp"
+#include "image_io.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  constexpr std::string_view csv_header = "frontend,scene,threads,partitioner,wall_seconds,"
+                                          "rays_per_second,peak_rss_kib,rmse,max_error";
+
+  constexpr std::size_t csv_columns = 9;
+
+  // Añade el número con la representación más corta que se vuelve a leer igual
+  template <typename Number>
+  void append_number(std::string & out, Number const value) {
+    std::array<char, 32> buffer{};
+    auto const result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    out.append(buffer.data(), result.ptr);
+  }
+
+  void append_json_string(std::string & out, std::string_view const text) {
+    constexpr std::string_view hex = "0123456789abcdef";
+    out += '"';
+    for (char const c : text) {
+      auto const code = static_cast<unsigned char>(c);
+      if (c == '"' or c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (code < 0x20) {
+        out += "\\u00";
+        out += hex[code >> 4U];
+        out += hex[code & 0xFU];
+      } else {
+        out += c;
+      }
+    }
+    out += '"';
+  }
+
+  // Campo CSV entre comillas solo si lleva comas, comillas o saltos de línea
+  void append_csv_field(std::string & out, std::string_view const text) {
+    if (text.find_first_of(",\"\n\r") == std::string_view::npos) {
+      out += text;
+      return;
+    }
+    out += '"';
+    for (char const c : text) {
+      if (c == '"') {
+        out += '"';
+      }
+      out += c;
+    }
+    out += '"';
+  }
+
+  std::vector<std::string> split_csv_line(std::string_view const line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (std::size_t i = 0; i < line.size(); ++i) {
+      char const c = line[i];
+      if (quoted) {
+        if (c == '"' and i + 1 < line.size() and line[i + 1] == '"') {
+          fields.back() += '"';
+          ++i;
+        } else if (c == '"') {
+          quoted = false;
+        } else {
+          fields.back() += c;
+        }
+      } else if (c == '"') {
+        quoted = true;
+      } else if (c == ',') {
+        fields.emplace_back();
+      } else if (c != '\r') {
+        fields.back() += c;
+      }
+    }
+    return fields;
+  }
+
+  template <typename Number>
+  Number parse_number(std::string const & field, std::string const & line) {
+    Number value{};
+    auto const * const end = field.data() + field.size();
+    auto const [ptr, ec]   = std::from_chars(field.data(), end, value);
+    if (ec != std::errc{} or ptr != end) {
+      throw std::invalid_argument("Error: Invalid number in bench results: " + line);
+    }
+    return value;
+  }
+
+  // Identifica un caso de la matriz: front end, escena, hilos y partitioner
+  using result_key = std::tuple<std::string, std::string, int, std::string>;
+
+  result_key key_of(render::bench_result const & r) {
+    return {r.frontend, r.scene, r.threads, r.partitioner};
+  }
+
+}  // namespace
+
+namespace render {
+
+  image_difference compare_images(ppm_image const & a, ppm_image const & b) {
+    if (a.width != b.width or a.height != b.height or a.rgb.size() != b.rgb.size()) {
+      throw std::invalid_argument("Error: Images to compare have different sizes");
+    }
+    image_difference result;
+    if (a.rgb.empty()) {
+      return result;
+    }
+    double squares = 0.0;
+    for (std::size_t i = 0; i < a.rgb.size(); ++i) {
+      int const diff   = std::abs(int{a.rgb[i]} - int{b.rgb[i]});
+      squares         += static_cast<double>(diff * diff);
+      result.max_error = std::max(result.max_error, diff);
+    }
+    result.rmse = std::sqrt(squares / static_cast<double>(a.rgb.size()));
+    return result;
+  }
+
+  std::string bench_results_json(std::span<bench_result const> results) {
+    std::string out = "[";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      auto const & r = results[i];
+      out += i == 0 ? "\n" : ",\n";
+      out += "  {\"frontend\": ";
+      append_json_string(out, r.frontend);
+      out += ", \"scene\": ";
+      append_json_string(out, r.scene);
+      out += ", \"threads\": ";
+      append_number(out, r.threads);
+      out += ", \"partitioner\": ";
+      append_json_string(out, r.partitioner);
+      out += ", \"wall_seconds\": ";
+      append_number(out, r.wall_seconds);
+      out += ", \"rays_per_second\": ";
+      append_number(out, r.rays_per_second);
+      out += ", \"peak_rss_kib\": ";
+      append_number(out, r.peak_rss_kib);
+      out += ", \"rmse\": ";
+      append_number(out, r.rmse);
+      out += ", \"max_error\": ";
+      append_number(out, r.max_error);
+      out += "}";
+    }
+    out += results.empty() ? "]\n" : "\n]\n";
+    return out;
+  }
+
+  std::string bench_results_csv(std::span<bench_result const> results) {
+    std::string out{csv_header};
+    out += '\n';
+    for (auto const & r : results) {
+      append_csv_field(out, r.frontend);
+      out += ',';
+      append_csv_field(out, r.scene);
+      out += ',';
+      append_number(out, r.threads);
+      out += ',';
+      append_csv_field(out, r.partitioner);
+      out += ',';
+      append_number(out, r.wall_seconds);
+      out += ',';
+      append_number(out, r.rays_per_second);
+      out += ',';
+      append_number(out, r.peak_rss_kib);
+      out += ',';
+      append_number(out, r.rmse);
+      out += ',';
+      append_number(out, r.max_error);
+      out += '\n';
+    }
+    return out;
+  }
+
+  std::vector<bench_result> parse_bench_results_csv(std::istream & in) {
+    std::string line;
+    if (not std::getline(in, line) or split_csv_line(line) != split_csv_line(csv_header)) {
+      throw std::invalid_argument("Error: Bench results without the expected header");
+    }
+    std::vector<bench_result> results;
+    while (std::getline(in, line)) {
+      if (line.find_first_not_of(" \t\r") == std::string::npos) {
+        continue;
+      }
+      auto const fields = split_csv_line(line);
+      if (fields.size() != csv_columns) {
+        throw std::invalid_argument("Error: Invalid bench results line: " + line);
+      }
+      results.push_back(bench_result{
+          .frontend        = fields[0],
+          .scene           = fields[1],
+          .threads         = parse_number<int>(fields[2], line),
+          .partitioner     = fields[3],
+          .wall_seconds    = parse_number<double>(fields[4], line),
+          .rays_per_second = parse_number<double>(fields[5], line),
+          .peak_rss_kib    = parse_number<long>(fields[6], line),
+          .rmse            = parse_number<double>(fields[7], line),
+          .max_error       = parse_number<int>(fields[8], line)});
+    }
+    return results;
+  }
+
+  std::vector<bench_result> read_bench_results_csv(std::string const & path) {
+    std::ifstream in{path};
+    if (not in) {
+      throw std::runtime_error("Error: Cannot open bench results: " + path);
+    }
+    return parse_bench_results_csv(in);
+  }
+
+  std::vector<bench_regression> find_regressions(std::span<bench_result const> current,
+                                                 std::span<bench_result const> baseline,
+                                                 double const threshold) {
+    std::map<result_key, double> reference;
+    for (auto const & r : baseline) {
+      reference.emplace(key_of(r), r.wall_seconds);
+    }
+    std::vector<bench_regression> regressions;
+    for (auto const & r : current) {
+      auto const found = reference.find(key_of(r));
+      if (found == reference.end() or found->second <= 0.0) {
+        continue;
+      }
+      double const slowdown = r.wall_seconds / found->second - 1.0;
+      if (slowdown > threshold) {
+        regressions.push_back(bench_regression{
+            .current = r, .baseline_seconds = found->second, .slowdown = slowdown});
+      }
+    }
+    return regressions;
+  }
+
+}  // namespace render
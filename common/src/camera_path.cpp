@@ -0,0 +1,71 @@
+#include "camera_path.hpp"
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <string>
+
+namespace {
+
+  render::vector lerp(render::vector const & a, render::vector const & b, double const t) {
+    return (1.0 - t) * a + t * b;
+  }
+
+  // Número con ceros a la izquierda hasta width cifras
+  std::string padded(int const value, std::size_t const width) {
+    std::string digits = std::to_string(value);
+    if (digits.size() < width) {
+      digits.insert(0, width - digits.size(), '0');
+    }
+    return digits;
+  }
+
+  constexpr std::size_t default_frame_digits = 4;
+
+}  // namespace
+
+namespace render {
+
+  config frame_config(config const & cfg, int const frame) {
+    auto const & keys = cfg.get_camera_keyframes();
+    if (keys.empty()) {
+      return cfg;
+    }
+    auto const time = static_cast<double>(frame);
+    // Primer fotograma clave posterior a time
+    auto const next = std::ranges::upper_bound(keys, time, {}, &camera_keyframe::time);
+    camera_keyframe key = next == keys.begin() ? keys.front() : *std::prev(next);
+    if (next != keys.begin() and next != keys.end()) {
+      auto const & before = *std::prev(next);
+      double const t      = (time - before.time) / (next->time - before.time);
+      key.position        = lerp(before.position, next->position, t);
+      key.target          = lerp(before.target, next->target, t);
+      key.north           = lerp(before.north, next->north, t);
+      key.field_of_view   = (1.0 - t) * before.field_of_view + t * next->field_of_view;
+    }
+
+    config out = cfg;
+    out.set_camera_position(key.position);
+    out.set_camera_target(key.target);
+    out.set_camera_north(key.north);
+    out.set_field_of_view(key.field_of_view);
+    return out;
+  }
+
+  std::string frame_output_path(std::string const & pattern, int const frame) {
+    auto const last = pattern.find_last_of('#');
+    if (last != std::string::npos) {
+      auto const first = pattern.find_last_not_of('#', last);
+      auto const begin = first == std::string::npos ? 0 : first + 1;
+      return pattern.substr(0, begin) + padded(frame, last + 1 - begin) + pattern.substr(last + 1);
+    }
+    std::filesystem::path path{pattern};
+    auto const extension = path.extension().string();
+    path.replace_extension();
+    return path.string() + "_" + padded(frame, default_frame_digits) + extension;
+  }
+
+}  // namespace render
@@ -0,0 +1,147 @@
+#include "checkpoint.hpp"
+#include "binary_io.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Marca y versión del formato. El fichero se lee en la misma máquina que lo escribe, así que
+    // los enteros y float van en su orden de bytes.
+    constexpr std::array<char, 4> magic{'R', 'C', 'K', 'P'};
+    constexpr std::uint32_t version = 2;
+
+    constexpr std::uint64_t fnv_offset = 0xcbf2'9ce4'8422'2325ULL;
+    constexpr std::uint64_t fnv_prime  = 0x0000'0100'0000'01b3ULL;
+
+    constexpr std::size_t fingerprint_block = std::size_t{1} << 20U;
+
+    std::size_t pixel_count(checkpoint_header const & header) {
+      return static_cast<std::size_t>(header.rows_done) * static_cast<std::size_t>(header.width);
+    }
+
+  }  // namespace
+
+  std::string checkpoint_path_for(std::string const & output_path) {
+    return output_path + ".ckpt";
+  }
+
+  std::uint64_t fingerprint_files(std::span<std::string const> filenames) {
+    std::uint64_t hash = fnv_offset;
+    std::vector<char> buffer(fingerprint_block);
+    for (auto const & filename : filenames) {
+      std::ifstream in(filename, std::ios::binary);
+      if (!in.is_open()) {
+        throw std::runtime_error("Error: Cannot open file: " + filename);
+      }
+      // Se lee por bloques: recorrer el flujo carácter a carácter es varias veces más lento
+      while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto const bytes = static_cast<std::size_t>(in.gcount());
+        for (std::size_t i = 0; i < bytes; ++i) {
+          hash ^= static_cast<std::uint8_t>(buffer[i]);
+          hash *= fnv_prime;
+        }
+      }
+      // Separador para que mover bytes de un fichero a otro cambie la huella
+      hash ^= 0xFFU;
+      hash *= fnv_prime;
+    }
+    return hash;
+  }
+
+  void write_checkpoint(std::string const & filename, checkpoint_header const & header,
+                        std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                        std::span<std::uint8_t const> b, std::span<float const> linear) {
+    std::size_t const pixels = pixel_count(header);
+    if (header.width <= 0 or header.height <= 0 or header.band_height <= 0 or
+        header.rows_done < 0 or header.rows_done > header.height or
+        (header.ray_streams != 1 and header.ray_streams != 2) or r.size() != pixels or
+        g.size() != pixels or b.size() != pixels or
+        (not linear.empty() and linear.size() != 3 * pixels))
+    {
+      throw std::invalid_argument("Error: Invalid checkpoint: " + filename);
+    }
+
+    std::string const temp_name = filename + ".tmp";
+    {
+      std::ofstream out(temp_name, std::ios::binary);
+      if (!out.is_open()) {
+        throw std::runtime_error("Error: Cannot open file for writing: " + temp_name);
+      }
+      out.write(magic.data(), magic.size());
+      write_raw(out, version);
+      write_raw(out, header.width);
+      write_raw(out, header.height);
+      write_raw(out, header.band_height);
+      write_raw(out, header.rows_done);
+      write_raw(out, header.fingerprint);
+      write_raw(out, static_cast<std::uint32_t>(header.strategy));
+      write_raw(out, header.ray_streams);
+      write_raw(out, static_cast<std::uint32_t>(linear.empty() ? 0 : 1));
+      write_raw_span(out, r);
+      write_raw_span(out, g);
+      write_raw_span(out, b);
+      write_raw_span(out, linear);
+      out.close();
+      if (!out) {
+        throw std::runtime_error("Error: Cannot write to file: " + temp_name);
+      }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_name, filename, error);
+    if (error) {
+      throw std::runtime_error("Error: Cannot write to file: " + filename);
+    }
+  }
+
+  checkpoint read_checkpoint(std::string const & filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+      throw std::runtime_error("Error: Cannot open file: " + filename);
+    }
+    std::array<char, 4> file_magic{};
+    in.read(file_magic.data(), file_magic.size());
+    auto const file_version = read_raw<std::uint32_t>(in);
+
+    checkpoint state;
+    state.header.width       = read_raw<int>(in);
+    state.header.height      = read_raw<int>(in);
+    state.header.band_height = read_raw<int>(in);
+    state.header.rows_done   = read_raw<int>(in);
+    state.header.fingerprint = read_raw<std::uint64_t>(in);
+    auto const strategy      = read_raw<std::uint32_t>(in);
+    state.header.ray_streams = read_raw<int>(in);
+    auto const has_linear    = read_raw<std::uint32_t>(in);
+    auto const & header      = state.header;
+    if (!in or file_magic != magic or file_version != version or header.width <= 0 or
+        header.height <= 0 or header.band_height <= 0 or header.rows_done < 0 or
+        header.rows_done > header.height or
+        strategy > static_cast<std::uint32_t>(parallel_strategy::samples) or
+        (header.ray_streams != 1 and header.ray_streams != 2) or has_linear > 1)
+    {
+      throw std::runtime_error("Error: Invalid checkpoint file: " + filename);
+    }
+    state.header.strategy = static_cast<parallel_strategy>(strategy);
+
+    std::size_t const pixels = pixel_count(header);
+    read_raw_vector(in, state.r, pixels);
+    read_raw_vector(in, state.g, pixels);
+    read_raw_vector(in, state.b, pixels);
+    read_raw_vector(in, state.linear, has_linear == 1 ? 3 * pixels : 0);
+    if (!in or in.peek() != std::ifstream::traits_type::eof()) {
+      throw std::runtime_error("Error: Invalid checkpoint file: " + filename);
+    }
+    return state;
+  }
+
+}  // namespace render
@@ -0,0 +1,505 @@
+#include "compiled_scene.hpp"
+#include "binary_io.hpp"
+#include "material.hpp"
+#include "object.hpp"
+#include "scene.hpp"
+#include "scene_parser.hpp"
+#include "vector.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <oneapi/tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+  constexpr std::size_t section_alignment = 64;
+  constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+  enum material_kind : std::uint32_t { matte_kind, metal_kind, refractive_kind };
+
+  enum object_kind : std::uint8_t { sphere_kind, cylinder_kind };
+
+  struct compiled_header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t file_size;
+    std::uint64_t material_count;
+    std::uint64_t names_size;
+    std::uint64_t sphere_count;
+    std::uint64_t cylinder_count;
+    std::uint64_t acceleration_size;  // Reservado para una estructura de aceleración; siempre 0
+    std::uint64_t source_fingerprint;  // Huella del texto de origen; 0 si no se conoce
+    std::array<std::uint64_t, 7> reserved;
+  };
+
+  static_assert(sizeof(compiled_header) == 128);
+
+  // Entrada de la tabla de materiales. params es la reflectancia y el coeficiente de difusión
+  // (metal), o el índice de refracción en params[0] (refractive).
+  struct material_record {
+    std::uint32_t kind;
+    std::uint32_t name_size;
+    std::uint64_t name_offset;
+    std::array<double, 4> params;
+  };
+
+  static_assert(sizeof(material_record) == 48);
+
+  // Secciones del fichero, en orden
+  enum section : std::size_t {
+    materials_section,
+    names_section,
+    kinds_section,
+    sphere_x,
+    sphere_y,
+    sphere_z,
+    sphere_radius,
+    sphere_material,
+    cylinder_x,
+    cylinder_y,
+    cylinder_z,
+    cylinder_radius,
+    cylinder_axis_x,
+    cylinder_axis_y,
+    cylinder_axis_z,
+    cylinder_material,
+    section_count
+  };
+
+  struct section_layout {
+    std::array<std::size_t, section_count> offset;
+    std::size_t end;
+  };
+
+  constexpr std::size_t align_up(std::size_t const value) {
+    return (value + section_alignment - 1) / section_alignment * section_alignment;
+  }
+
+  // Posición de cada sección a partir de los tamaños de la cabecera
+  section_layout layout_for(compiled_header const & header) {
+    std::size_t const spheres   = header.sphere_count;
+    std::size_t const cylinders = header.cylinder_count;
+    std::array<std::size_t, section_count> sizes{};
+    sizes[materials_section] = header.material_count * sizeof(material_record);
+    sizes[names_section]     = header.names_size;
+    sizes[kinds_section]     = spheres + cylinders;
+    for (std::size_t i = sphere_x; i < sphere_material; ++i) {
+      sizes.at(i) = spheres * sizeof(double);
+    }
+    sizes[sphere_material] = spheres * sizeof(std::uint32_t);
+    for (std::size_t i = cylinder_x; i < cylinder_material; ++i) {
+      sizes.at(i) = cylinders * sizeof(double);
+    }
+    sizes[cylinder_material] = cylinders * sizeof(std::uint32_t);
+
+    section_layout layout{};
+    std::size_t pos = sizeof(compiled_header);
+    for (std::size_t i = 0; i < section_count; ++i) {
+      pos                   = align_up(pos);
+      layout.offset.at(i) = pos;
+      pos += sizes.at(i);
+    }
+    layout.end = pos;
+    return layout;
+  }
+
+  // Rellena con ceros hasta la posición dada
+  void pad_to(std::ostream & out, std::size_t & written, std::size_t const offset) {
+    std::array<char, section_alignment> const zeros{};
+    out.write(zeros.data(), static_cast<std::streamsize>(offset - written));
+    written = offset;
+  }
+
+  template <typename T>
+  void write_section(std::ostream & out, std::size_t & written, std::size_t const offset,
+                     std::vector<T> const & values) {
+    pad_to(out, written, offset);
+    render::write_raw_span(out, std::span<T const>{values});
+    written += values.size() * sizeof(T);
+  }
+
+  // Fichero proyectado en memoria en solo lectura
+  class mapped_file {
+  public:
+    explicit mapped_file(std::string const & path) {
+      int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "Error: Cannot open scene file: " + path);
+      }
+      struct stat info{};
+      if (::fstat(fd, &info) != 0) {
+        int const error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Error: Cannot read scene file: " + path);
+      }
+      size = static_cast<std::size_t>(info.st_size);
+      if (size > 0) {
+        void * const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+          int const error = errno;
+          ::close(fd);
+          throw std::system_error(error, std::generic_category(),
+                                  "Error: Cannot map scene file: " + path);
+        }
+        data = static_cast<std::byte const *>(mapping);
+      }
+      ::close(fd);
+    }
+
+    ~mapped_file() {
+      if (data != nullptr) {
+        // munmap no modifica los datos; solo pide el puntero sin const
+        ::munmap(const_cast<std::byte *>(data), size);
+      }
+    }
+
+    mapped_file(mapped_file const &)             = delete;
+    mapped_file & operator=(mapped_file const &) = delete;
+    mapped_file(mapped_file &&)                  = delete;
+    mapped_file & operator=(mapped_file &&)      = delete;
+
+    [[nodiscard]] std::span<std::byte const> bytes() const { return {data, size}; }
+
+  private:
+    std::byte const * data{nullptr};
+    std::size_t size{0};
+  };
+
+  // Valor en la posición dada. Se copia byte a byte para no reinterpretar punteros.
+  template <typename T>
+  T load_raw(std::span<std::byte const> const bytes, std::size_t const offset) {
+    T value{};
+    std::memcpy(&value, bytes.subspan(offset, sizeof(T)).data(), sizeof(T));
+    return value;
+  }
+
+  // Elemento index de un array que empieza en offset
+  template <typename T>
+  T load_element(std::span<std::byte const> const bytes, std::size_t const offset,
+                 std::size_t const index) {
+    return load_raw<T>(bytes, offset + index * sizeof(T));
+  }
+
+  render::vector load_vector(std::span<std::byte const> const bytes, section_layout const & layout,
+                             std::size_t const first_section, std::size_t const index) {
+    return render::vector{load_element<double>(bytes, layout.offset.at(first_section), index),
+                          load_element<double>(bytes, layout.offset.at(first_section + 1), index),
+                          load_element<double>(bytes, layout.offset.at(first_section + 2), index)};
+  }
+
+  bool is_finite(render::vector const & v) {
+    return std::isfinite(v.x) and std::isfinite(v.y) and std::isfinite(v.z);
+  }
+
+  // Los mismos límites que impone el intérprete de texto, más que los valores sean finitos
+  bool valid_reflectance(render::vector const & r) {
+    return is_finite(r) and r.x >= 0.0 and r.x <= 1.0 and r.y >= 0.0 and r.y <= 1.0 and
+           r.z >= 0.0 and r.z <= 1.0;
+  }
+
+  bool valid_material(std::uint32_t const kind, render::vector const & reflectance,
+                      std::array<double, 4> const & params) {
+    switch (kind) {
+      case matte_kind:
+        return valid_reflectance(reflectance);
+      case metal_kind:
+        return valid_reflectance(reflectance) and std::isfinite(params[3]) and params[3] >= 0.0;
+      case refractive_kind:
+        return std::isfinite(params[0]) and params[0] > 0.0;
+      default:
+        return true;  // El tipo desconocido se rechaza al crear el material
+    }
+  }
+
+  bool valid_shape(render::vector const & center, double const radius) {
+    return is_finite(center) and std::isfinite(radius) and radius > 0.0;
+  }
+
+  // Comprueba la cabecera contra el tamaño real del fichero y devuelve la posición de las
+  // secciones
+  section_layout validate_header(compiled_header const & header, std::size_t const size,
+                                 std::string const & path) {
+    if (header.magic != render::compiled_scene_magic) {
+      throw std::runtime_error("Error: Not a compiled scene file: " + path);
+    }
+    if (header.version != render::compiled_scene_version) {
+      throw std::runtime_error("Error: Unsupported compiled scene version " +
+                               std::to_string(header.version) + ": " + path);
+    }
+    if (header.byte_order != byte_order_mark) {
+      throw std::runtime_error("Error: Compiled scene has a different byte order: " + path);
+    }
+    if (header.acceleration_size != 0) {
+      throw std::runtime_error("Error: Unsupported compiled scene section: " + path);
+    }
+    // Con estos límites el cálculo de las secciones no puede desbordarse
+    if (header.material_count > size or header.names_size > size or header.sphere_count > size or
+        header.cylinder_count > size)
+    {
+      throw std::runtime_error("Error: Truncated compiled scene file: " + path);
+    }
+    auto const layout = layout_for(header);
+    if (header.file_size != layout.end) {
+      throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+    }
+    if (size < layout.end) {
+      throw std::runtime_error("Error: Truncated compiled scene file: " + path);
+    }
+    return layout;
+  }
+
+  // Añade los materiales de la tabla y devuelve un puntero a cada uno, en el orden de la tabla
+  std::vector<render::material const *> load_materials(std::span<std::byte const> const bytes,
+                                                       compiled_header const & header,
+                                                       section_layout const & layout,
+                                                       render::scene & scn,
+                                                       std::string const & path) {
+    std::vector<render::material const *> table;
+    table.reserve(header.material_count);
+    for (std::size_t i = 0; i < header.material_count; ++i) {
+      auto const record =
+          load_element<material_record>(bytes, layout.offset[materials_section], i);
+      if (record.name_size == 0 or record.name_offset > header.names_size or
+          record.name_size > header.names_size - record.name_offset)
+      {
+        throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+      std::string name(record.name_size, '\0');
+      std::memcpy(name.data(),
+                  bytes.subspan(layout.offset[names_section] + record.name_offset).data(),
+                  name.size());
+      if (scn.find_material(name) != render::scene::no_material) {
+        throw std::runtime_error("Error: Material with name [" + name + "] already exists");
+      }
+
+      render::vector const reflectance{record.params[0], record.params[1], record.params[2]};
+      if (not valid_material(record.kind, reflectance, record.params)) {
+        throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+      std::unique_ptr<render::material> value;
+      switch (record.kind) {
+        case matte_kind:
+          value = std::make_unique<render::matte_material>(reflectance);
+          break;
+        case metal_kind:
+          value = std::make_unique<render::metal_material>(reflectance, record.params[3]);
+          break;
+        case refractive_kind:
+          value = std::make_unique<render::refractive_material>(record.params[0]);
+          break;
+        default:
+          throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+      table.push_back(value.get());
+      scn.add_material(name, std::move(value));
+    }
+    return table;
+  }
+
+}  // namespace
+
+namespace render {
+
+  void write_compiled_scene(std::string const & path, scene const & scn,
+                            std::uint64_t const source_fingerprint) {
+    std::vector<material_record> materials;
+    std::string names;
+    std::unordered_map<material const *, std::uint32_t> material_index;
+    for (scene::material_id id = 0; id < scn.material_count(); ++id) {
+      auto const & name = scn.get_material_name(id);
+      auto const * mat  = scn.get_material(id);
+      material_record record{.kind        = matte_kind,
+                             .name_size   = static_cast<std::uint32_t>(name.size()),
+                             .name_offset = names.size(),
+                             .params      = {}};
+      auto const reflectance = mat->get_reflectance();
+      record.params          = {reflectance.x, reflectance.y, reflectance.z, 0.0};
+      if (auto const * metal = dynamic_cast<metal_material const *>(mat)) {
+        record.kind      = metal_kind;
+        record.params[3] = metal->get_diffusion();
+      } else if (auto const * glass = dynamic_cast<refractive_material const *>(mat)) {
+        record.kind   = refractive_kind;
+        record.params = {glass->get_refraction_index(), 0.0, 0.0, 0.0};
+      }
+      material_index.emplace(mat, id);
+      materials.push_back(record);
+      names += name;
+    }
+
+    std::vector<std::uint8_t> kinds;
+    std::array<std::vector<double>, 4> spheres;
+    std::vector<std::uint32_t> sphere_materials;
+    std::array<std::vector<double>, 7> cylinders;
+    std::vector<std::uint32_t> cylinder_materials;
+    for (auto const & obj : scn.get_objects()) {
+      auto const found = material_index.find(obj->get_material());
+      if (found == material_index.end()) {
+        throw std::runtime_error("Error: Object material is not part of the scene");
+      }
+      auto const center = obj->get_center();
+      if (auto const * cyl = dynamic_cast<cylinder const *>(obj.get())) {
+        auto const axis = cyl->get_axis();
+        std::array const values{center.x, center.y, center.z, cyl->get_radius(),
+                                axis.x,   axis.y,   axis.z};
+        for (std::size_t i = 0; i < values.size(); ++i) {
+          cylinders.at(i).push_back(values.at(i));
+        }
+        cylinder_materials.push_back(found->second);
+        kinds.push_back(cylinder_kind);
+      } else {
+        std::array const values{center.x, center.y, center.z, obj->get_radius()};
+        for (std::size_t i = 0; i < values.size(); ++i) {
+          spheres.at(i).push_back(values.at(i));
+        }
+        sphere_materials.push_back(found->second);
+        kinds.push_back(sphere_kind);
+      }
+    }
+
+    compiled_header header{.magic              = compiled_scene_magic,
+                           .version            = compiled_scene_version,
+                           .byte_order         = byte_order_mark,
+                           .file_size          = 0,
+                           .material_count     = materials.size(),
+                           .names_size         = names.size(),
+                           .sphere_count       = sphere_materials.size(),
+                           .cylinder_count     = cylinder_materials.size(),
+                           .acceleration_size  = 0,
+                           .source_fingerprint = source_fingerprint,
+                           .reserved           = {}};
+    auto const layout = layout_for(header);
+    header.file_size  = layout.end;
+
+    std::ofstream out(path, std::ios::binary);
+    if (not out) {
+      throw std::runtime_error("Error: Cannot open file for writing: " + path);
+    }
+    write_raw(out, header);
+    std::size_t written = sizeof(header);
+    write_section(out, written, layout.offset[materials_section], materials);
+    write_section(out, written, layout.offset[names_section],
+                  std::vector<char>(names.begin(), names.end()));
+    write_section(out, written, layout.offset[kinds_section], kinds);
+    for (std::size_t i = 0; i < spheres.size(); ++i) {
+      write_section(out, written, layout.offset.at(sphere_x + i), spheres.at(i));
+    }
+    write_section(out, written, layout.offset[sphere_material], sphere_materials);
+    for (std::size_t i = 0; i < cylinders.size(); ++i) {
+      write_section(out, written, layout.offset.at(cylinder_x + i), cylinders.at(i));
+    }
+    write_section(out, written, layout.offset[cylinder_material], cylinder_materials);
+    if (not out.flush()) {
+      throw std::runtime_error("Error: Cannot write to file: " + path);
+    }
+  }
+
+  void load_compiled_scene(std::string const & path, scene & scn) {
+    mapped_file const file{path};
+    auto const bytes = file.bytes();
+    if (bytes.size() < sizeof(compiled_header)) {
+      throw std::runtime_error("Error: Truncated compiled scene file: " + path);
+    }
+    auto const header = load_raw<compiled_header>(bytes, 0);
+    auto const layout = validate_header(header, bytes.size(), path);
+    auto const table  = load_materials(bytes, header, layout, scn, path);
+
+    auto material_at = [&](std::size_t const section, std::size_t const index) {
+      auto const entry = load_element<std::uint32_t>(bytes, layout.offset.at(section), index);
+      if (entry >= table.size()) {
+        throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+      return table[entry];
+    };
+
+    // Cada tipo de objeto se construye en paralelo a partir de sus arrays
+    std::vector<std::unique_ptr<object>> spheres(header.sphere_count);
+    tbb::parallel_for(std::size_t{0}, spheres.size(), [&](std::size_t const i) {
+      auto const center = load_vector(bytes, layout, sphere_x, i);
+      auto const radius = load_element<double>(bytes, layout.offset[sphere_radius], i);
+      if (not valid_shape(center, radius)) {
+        throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+      spheres[i] = std::make_unique<sphere>(center, radius, material_at(sphere_material, i));
+    });
+    std::vector<std::unique_ptr<object>> cylinders(header.cylinder_count);
+    tbb::parallel_for(std::size_t{0}, cylinders.size(), [&](std::size_t const i) {
+      auto const center = load_vector(bytes, layout, cylinder_x, i);
+      auto const radius = load_element<double>(bytes, layout.offset[cylinder_radius], i);
+      auto const axis   = load_vector(bytes, layout, cylinder_axis_x, i);
+      if (not valid_shape(center, radius) or not is_finite(axis) or axis.is_near_zero()) {
+        throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+      cylinders[i] =
+          std::make_unique<cylinder>(center, radius, axis, material_at(cylinder_material, i));
+    });
+
+    // Se añaden en el orden original de la escena
+    auto const kinds = bytes.subspan(layout.offset[kinds_section], spheres.size() + cylinders.size());
+    std::size_t next_sphere   = 0;
+    std::size_t next_cylinder = 0;
+    for (auto const kind : kinds) {
+      if (kind == std::byte{sphere_kind} and next_sphere < spheres.size()) {
+        scn.add_object(std::move(spheres[next_sphere++]));
+      } else if (kind == std::byte{cylinder_kind} and next_cylinder < cylinders.size()) {
+        scn.add_object(std::move(cylinders[next_cylinder++]));
+      } else {
+        throw std::runtime_error("Error: Corrupt compiled scene file: " + path);
+      }
+    }
+  }
+
+  std::uint64_t compiled_scene_source(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    if (not in) {
+      throw std::runtime_error("Error: Cannot open file: " + path);
+    }
+    auto const header = read_raw<compiled_header>(in);
+    if (not in) {
+      throw std::runtime_error("Error: Truncated compiled scene file: " + path);
+    }
+    if (header.magic != compiled_scene_magic or header.version != compiled_scene_version or
+        header.byte_order != byte_order_mark)
+    {
+      throw std::runtime_error("Error: Not a compiled scene file: " + path);
+    }
+    return header.source_fingerprint;
+  }
+
+  bool is_compiled_scene(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    std::array<char, compiled_scene_magic.size()> magic{};
+    return in.read(magic.data(), magic.size()) and magic == compiled_scene_magic;
+  }
+
+  void load_scene_file(std::string const & path, scene & scn) {
+    if (is_compiled_scene(path)) {
+      load_compiled_scene(path, scn);
+    } else {
+      parse_scene_file(path, scn);
+    }
+  }
+
+}  // namespace render
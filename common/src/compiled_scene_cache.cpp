@@ -0,0 +1,104 @@
+#include "compiled_scene_cache.hpp"
+#include "checkpoint.hpp"
+#include "compiled_scene.hpp"
+#include "scene.hpp"
+#include "scene_parser.hpp"
+
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+  // Guarda la escena compilada con un nombre temporal único y la renombra, así que ningún otro
+  // proceso o hilo ve una entrada a medio escribir
+  void store_entry(std::string const & entry_path, render::scene const & scn,
+                   std::uint64_t const fingerprint) {
+    static std::atomic<unsigned> next_temp{0};
+    std::filesystem::create_directories(std::filesystem::path{entry_path}.parent_path());
+    std::string const temp_name = entry_path + ".tmp." + std::to_string(::getpid()) + "." +
+                                  std::to_string(next_temp++);
+    render::write_compiled_scene(temp_name, scn, fingerprint);
+    std::error_code error;
+    std::filesystem::rename(temp_name, entry_path, error);
+    if (error) {
+      std::filesystem::remove(temp_name, error);
+      throw std::runtime_error("Error: Cannot write to file: " + entry_path);
+    }
+  }
+
+}  // namespace
+
+namespace render {
+
+  std::string_view to_string(scene_cache_status const status) {
+    switch (status) {
+      case scene_cache_status::hit:
+        return "hit";
+      case scene_cache_status::miss:
+        return "miss";
+      case scene_cache_status::off:
+        break;
+    }
+    return "off";
+  }
+
+  std::string compiled_scene_cache_path(std::string const & cache_dir,
+                                        std::uint64_t const fingerprint) {
+    std::ostringstream name;
+    name << "scene-" << std::hex << std::setw(16) << std::setfill('0') << fingerprint << std::dec
+         << "-v" << compiled_scene_version << ".bin";
+    return (std::filesystem::path{cache_dir} / name.str()).string();
+  }
+
+  scene_cache_status load_scene_cached(std::string const & path, std::string const & cache_dir,
+                                       scene & scn) {
+    if (cache_dir.empty() or is_compiled_scene(path)) {
+      load_scene_file(path, scn);
+      return scene_cache_status::off;
+    }
+
+    auto const fingerprint = fingerprint_files(std::array{path});
+    auto const entry_path  = compiled_scene_cache_path(cache_dir, fingerprint);
+    if (is_compiled_scene(entry_path)) {
+      // La entrada sólo vale si guarda la huella de esta escena; una dañada o de otra escena se
+      // descarta y se vuelve a generar
+      try {
+        if (compiled_scene_source(entry_path) == fingerprint) {
+          scene cached;
+          load_compiled_scene(entry_path, cached);
+          scn = std::move(cached);
+          return scene_cache_status::hit;
+        }
+      } catch (std::runtime_error const &) {
+      }
+      std::error_code error;
+      std::filesystem::remove(entry_path, error);
+    }
+
+    scene parsed;
+    parse_scene_file(path, parsed);
+    // La caché es sólo una ayuda: si no se puede escribir, el render sigue con la escena leída
+    try {
+      store_entry(entry_path, parsed, fingerprint);
+    } catch (std::exception const & e) {
+      std::cerr << "Caché de escenas: no se puede guardar la entrada, se sigue sin ella ("
+                << e.what() << ")\n";
+    }
+    scn = std::move(parsed);
+    return scene_cache_status::miss;
+  }
+
+}  // namespace render
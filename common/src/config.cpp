@@ -1,5 +1,6 @@
 #include "config.hpp"
 #include "vector.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <fstream>
 #include <istream>
@@ -159,6 +160,120 @@ namespace render {
       cfg.set_partitioner(parts[1]);
     }
 
+    void handle_parallel_strategy(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [parallel_strategy:]");
+      }
+      cfg.set_parallel_strategy(parts[1]);
+    }
+
+    void handle_numa(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [numa:]");
+      }
+      cfg.set_numa(parts[1]);
+    }
+
+    void handle_numa_scene(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [numa_scene:]");
+      }
+      cfg.set_numa_scene(parts[1]);
+    }
+
+    void handle_tile_height(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [tile_height:]");
+      }
+      cfg.set_tile_height(to_int(parts[1]));
+    }
+
+    void handle_scheduler(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [scheduler:]");
+      }
+      cfg.set_scheduler(parts[1]);
+    }
+
+    void handle_thread_affinity(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [thread_affinity:]");
+      }
+      cfg.set_thread_affinity(parts[1]);
+    }
+
+    void handle_ray_streams(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [ray_streams:]");
+      }
+      cfg.set_ray_streams(to_int(parts[1]));
+    }
+
+    void handle_output_format(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [output_format:]");
+      }
+      cfg.set_output_format(parts[1]);
+    }
+
+    void handle_framebuffer(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [framebuffer:]");
+      }
+      cfg.set_framebuffer(parts[1]);
+    }
+
+    void handle_stream_window(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [stream_window:]");
+      }
+      cfg.set_stream_window(to_int(parts[1]));
+    }
+
+    void handle_mmap_output(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [mmap_output:]");
+      }
+      cfg.set_mmap_output(parts[1]);
+    }
+
+    void handle_checkpoint_interval(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [checkpoint_interval:]");
+      }
+      cfg.set_checkpoint_interval(to_double(parts[1]));
+    }
+
+    void handle_frame_count(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [frame_count:]");
+      }
+      cfg.set_frame_count(to_int(parts[1]));
+    }
+
+    // camera_keyframe: <fotograma> <posición xyz> <objetivo xyz> <norte xyz> <campo de visión>
+    void handle_camera_keyframe(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 12) {
+        throw std::runtime_error("Error: Invalid value for key: [camera_keyframe:]");
+      }
+      auto const at = [&](std::size_t const first) {
+        return vector{to_double(parts[first]), to_double(parts[first + 1]),
+                      to_double(parts[first + 2])};
+      };
+      cfg.add_camera_keyframe(camera_keyframe{.time          = to_double(parts[1]),
+                                              .position      = at(2),
+                                              .target        = at(5),
+                                              .north         = at(8),
+                                              .field_of_view = to_double(parts[11])});
+    }
+
+    void handle_scene_cache_dir(std::vector<std::string> const & parts, config & cfg) {
+      if (parts.size() != 2) {
+        throw std::runtime_error("Error: Invalid value for key: [scene_cache_dir:]");
+      }
+      cfg.set_scene_cache_dir(parts[1]);
+    }
+
     void handle_background_dark_color(std::vector<std::string> const & parts, config & cfg) {
       if (parts.size() != 4) {
         throw std::runtime_error("Error: Invalid value for key: [background_dark_color:]");
@@ -309,6 +424,114 @@ namespace render {
     partitioner = p;
   }
 
+  void config::set_parallel_strategy(std::string const & s) {
+    if (s != "auto" and s != "rows" and s != "samples") {
+      throw std::runtime_error("Error: Invalid value for key: [parallel_strategy:]");
+    }
+    parallel_strategy = s;
+  }
+
+  void config::set_numa(std::string const & value) {
+    if (value != "off" and value != "on") {
+      throw std::runtime_error("Error: Invalid value for key: [numa:]");
+    }
+    numa = value;
+  }
+
+  void config::set_numa_scene(std::string const & value) {
+    if (value != "shared" and value != "replicated") {
+      throw std::runtime_error("Error: Invalid value for key: [numa_scene:]");
+    }
+    numa_scene = value;
+  }
+
+  void config::set_tile_height(int const value) {
+    if (value <= 0) {
+      throw std::runtime_error("Error: Invalid value for key: [tile_height:]");
+    }
+    tile_height = value;
+  }
+
+  void config::set_scheduler(std::string const & value) {
+    if (value != "tbb" and value != "worksteal") {
+      throw std::runtime_error("Error: Invalid value for key: [scheduler:]");
+    }
+    scheduler = value;
+  }
+
+  void config::set_thread_affinity(std::string const & value) {
+    if (value != "none" and value != "cores" and value != "smt") {
+      throw std::runtime_error("Error: Invalid value for key: [thread_affinity:]");
+    }
+    thread_affinity = value;
+  }
+
+  void config::set_ray_streams(int const value) {
+    if (value < 1 or value > 2) {
+      throw std::runtime_error("Error: Invalid value for key: [ray_streams:]");
+    }
+    ray_streams = value;
+  }
+
+  void config::set_output_format(std::string const & value) {
+    if (value != "auto" and value != "p3" and value != "p6" and value != "qoi") {
+      throw std::runtime_error("Error: Invalid value for key: [output_format:]");
+    }
+    output_format = value;
+  }
+
+  void config::set_framebuffer(std::string const & value) {
+    if (value != "ldr" and value != "hdr") {
+      throw std::runtime_error("Error: Invalid value for key: [framebuffer:]");
+    }
+    framebuffer = value;
+  }
+
+  void config::set_stream_window(int const value) {
+    if (value < 0) {
+      throw std::runtime_error("Error: Invalid value for key: [stream_window:]");
+    }
+    stream_window = value;
+  }
+
+  void config::set_mmap_output(std::string const & value) {
+    if (value != "off" and value != "on") {
+      throw std::runtime_error("Error: Invalid value for key: [mmap_output:]");
+    }
+    mmap_output = value;
+  }
+
+  void config::set_checkpoint_interval(double const value) {
+    if (value < 0) {
+      throw std::runtime_error("Error: Invalid value for key: [checkpoint_interval:]");
+    }
+    checkpoint_interval = value;
+  }
+
+  void config::set_frame_count(int const value) {
+    if (value <= 0) {
+      throw std::runtime_error("Error: Invalid value for key: [frame_count:]");
+    }
+    frame_count = value;
+  }
+
+  void config::add_camera_keyframe(camera_keyframe const & key) {
+    bool const ordered = camera_keyframes.empty() or key.time > camera_keyframes.back().time;
+    if (key.time < 0.0 or not ordered or key.north.is_near_zero() or
+        key.field_of_view <= 0.0 or key.field_of_view >= 180.0)
+    {
+      throw std::runtime_error("Error: Invalid value for key: [camera_keyframe:]");
+    }
+    camera_keyframes.push_back(key);
+  }
+
+  void config::set_scene_cache_dir(std::string const & value) {
+    if (value.empty()) {
+      throw std::runtime_error("Error: Invalid value for key: [scene_cache_dir:]");
+    }
+    scene_cache_dir = value;
+  }
+
   void config::set_background_dark_color(vector const & color) {
     if (color.x < 0.0 or
         color.x > 1.0 or
@@ -335,34 +558,62 @@ namespace render {
     background_light_color = color;
   }
 
+  namespace {
+
+    // Aplica las líneas "clave: valores" de in sobre out
+    void apply_config(std::istream & in, config & out) {
+      using Handler = void (*)(std::vector<std::string> const &, config &);
+      std::unordered_map<std::string, Handler> const handlers = {
+        {          "aspect_ratio",           handle_aspect_ratio},
+        {           "image_width",            handle_image_width},
+        {                 "gamma",                  handle_gamma},
+        {       "camera_position",        handle_camera_position},
+        {         "camera_target",          handle_camera_target},
+        {          "camera_north",           handle_camera_north},
+        {         "field_of_view",          handle_field_of_view},
+        {     "samples_per_pixel",      handle_samples_per_pixel},
+        {             "max_depth",              handle_max_depth},
+        {     "material_rng_seed",      handle_material_rng_seed},
+        {          "ray_rng_seed",           handle_ray_rng_seed},
+        {           "num_threads",            handle_num_threads},
+        {            "grain_size",             handle_grain_size},
+        {           "partitioner",            handle_partitioner},
+        {     "parallel_strategy",      handle_parallel_strategy},
+        {                  "numa",                   handle_numa},
+        {            "numa_scene",             handle_numa_scene},
+        {           "tile_height",            handle_tile_height},
+        {             "scheduler",              handle_scheduler},
+        {       "thread_affinity",        handle_thread_affinity},
+        {           "ray_streams",            handle_ray_streams},
+        {         "output_format",          handle_output_format},
+        {           "framebuffer",            handle_framebuffer},
+        {         "stream_window",          handle_stream_window},
+        {           "mmap_output",            handle_mmap_output},
+        {   "checkpoint_interval",    handle_checkpoint_interval},
+        {           "frame_count",            handle_frame_count},
+        {       "camera_keyframe",        handle_camera_keyframe},
+        {       "scene_cache_dir",        handle_scene_cache_dir},
+        { "background_dark_color",  handle_background_dark_color},
+        {"background_light_color", handle_background_light_color},
+      };
+
+      process_lines(in, handlers, out);
+    }
+
+  }  // namespace
+
   // Carga configuración desde archivo
   void load_config(std::string const & path, config & out) {
-    using Handler = void (*)(std::vector<std::string> const &, config &);
-    std::unordered_map<std::string, Handler> const handlers = {
-      {          "aspect_ratio",           handle_aspect_ratio},
-      {           "image_width",            handle_image_width},
-      {                 "gamma",                  handle_gamma},
-      {       "camera_position",        handle_camera_position},
-      {         "camera_target",          handle_camera_target},
-      {          "camera_north",           handle_camera_north},
-      {         "field_of_view",          handle_field_of_view},
-      {     "samples_per_pixel",      handle_samples_per_pixel},
-      {             "max_depth",              handle_max_depth},
-      {     "material_rng_seed",      handle_material_rng_seed},
-      {          "ray_rng_seed",           handle_ray_rng_seed},
-      {           "num_threads",            handle_num_threads},
-      {            "grain_size",             handle_grain_size},
-      {           "partitioner",            handle_partitioner},
-      { "background_dark_color",  handle_background_dark_color},
-      {"background_light_color", handle_background_light_color},
-    };
-
     std::ifstream ifs(path);
     if (!ifs) {
       throw std::runtime_error("Error: Cannot open config file: " + path);
     }
+    apply_config(ifs, out);
+  }
 
-    process_lines(ifs, handlers, out);
+  void apply_config_text(std::string const & text, config & out) {
+    std::istringstream in{text};
+    apply_config(in, out);
   }
 
 }  // namespace render
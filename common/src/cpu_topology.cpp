@@ -0,0 +1,116 @@
+#include "cpu_topology.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    int parse_cpu_number(std::string_view const text) {
+      int value        = 0;
+      auto const first = text.data();
+      auto const last  = text.data() + text.size();
+      auto const [ptr, ec] = std::from_chars(first, last, value);
+      if (text.empty() or ec != std::errc{} or ptr != last or value < 0) {
+        throw std::runtime_error("Error: Invalid CPU list: [" + std::string{text} + "]");
+      }
+      return value;
+    }
+
+    std::optional<int> read_topology_value(std::filesystem::path const & file) {
+      std::ifstream in(file);
+      int value = 0;
+      if (not(in >> value)) {
+        return std::nullopt;
+      }
+      return value;
+    }
+
+  }  // namespace
+
+  std::vector<int> parse_cpu_list(std::string_view text) {
+    while (not text.empty() and (text.back() == '\n' or text.back() == ' ')) {
+      text.remove_suffix(1);
+    }
+
+    std::vector<int> cpus;
+    while (not text.empty()) {
+      auto const comma       = text.find(',');
+      std::string_view range = text.substr(0, comma);
+      text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+
+      auto const dash = range.find('-');
+      if (dash == std::string_view::npos) {
+        cpus.push_back(parse_cpu_number(range));
+        continue;
+      }
+      int const first = parse_cpu_number(range.substr(0, dash));
+      int const last  = parse_cpu_number(range.substr(dash + 1));
+      if (last < first) {
+        throw std::runtime_error("Error: Invalid CPU list: [" + std::string{range} + "]");
+      }
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  std::vector<cpu_core> read_cpu_topology(std::filesystem::path const & sysfs_root,
+                                          std::span<int const> allowed_cpus) {
+    std::map<std::pair<int, int>, std::vector<int>> grouped;
+    for (int const cpu : allowed_cpus) {
+      auto const topology = sysfs_root / ("cpu" + std::to_string(cpu)) / "topology";
+      auto const package  = read_topology_value(topology / "physical_package_id");
+      auto const core     = read_topology_value(topology / "core_id");
+      if (package and core) {
+        grouped[{*package, *core}].push_back(cpu);
+      } else {
+        // Sin topología: núcleo propio en un paquete ficticio -1
+        grouped[{-1, cpu}].push_back(cpu);
+      }
+    }
+
+    std::vector<cpu_core> cores;
+    cores.reserve(grouped.size());
+    for (auto & [key, cpus] : grouped) {
+      std::ranges::sort(cpus);
+      cores.push_back(cpu_core{key.first, key.second, std::move(cpus)});
+    }
+    return cores;
+  }
+
+  std::vector<int> affinity_plan(std::span<cpu_core const> cores, std::string const & policy) {
+    std::vector<int> plan;
+    if (policy == "cores") {
+      for (auto const & core : cores) {
+        plan.push_back(core.cpus.front());
+      }
+    } else if (policy == "smt") {
+      std::size_t max_siblings = 0;
+      for (auto const & core : cores) {
+        max_siblings = std::max(max_siblings, core.cpus.size());
+      }
+      for (std::size_t sibling = 0; sibling < max_siblings; ++sibling) {
+        for (auto const & core : cores) {
+          if (sibling < core.cpus.size()) {
+            plan.push_back(core.cpus[sibling]);
+          }
+        }
+      }
+    }
+    return plan;
+  }
+
+}  // namespace render
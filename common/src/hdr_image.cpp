@@ -0,0 +1,222 @@
+#include "hdr_image.hpp"
+#include "color.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    constexpr std::size_t channels = 3;
+
+    std::uint32_t swap_bytes(std::uint32_t const value) {
+      return ((value & 0x0000'00FFU) << 24U) | ((value & 0x0000'FF00U) << 8U) |
+             ((value & 0x00FF'0000U) >> 8U) | ((value & 0xFF00'0000U) >> 24U);
+    }
+
+    std::size_t row_floats(int const width) {
+      return channels * static_cast<std::size_t>(width);
+    }
+
+  }  // namespace
+
+  hdr_image::hdr_image(int const width_value, int const height_value)
+      : width{width_value}, height{height_value} {
+    if (width < 0 or height < 0) {
+      throw std::invalid_argument("Error: Invalid HDR image size");
+    }
+    values.resize(row_floats(width) * static_cast<std::size_t>(height));
+  }
+
+  std::size_t hdr_image::offset(int const x, int const y) const {
+    if (x < 0 or x >= width or y < 0 or y >= height) {
+      throw std::out_of_range("Pixel out of range");
+    }
+    return static_cast<std::size_t>(y) * row_floats(width) +
+           channels * static_cast<std::size_t>(x);
+  }
+
+  color hdr_image::get_pixel(int const x, int const y) const {
+    std::size_t const base = offset(x, y);
+    return color{values[base], values[base + 1], values[base + 2]};
+  }
+
+  void hdr_image::set_pixel(int const x, int const y, color const & value) {
+    std::size_t const base = offset(x, y);
+    values[base]           = static_cast<float>(value.get_r());
+    values[base + 1]       = static_cast<float>(value.get_g());
+    values[base + 2]       = static_cast<float>(value.get_b());
+  }
+
+  void hdr_image::set_rows(int const row_begin, std::span<color const> pixels) {
+    auto const row_width = static_cast<std::size_t>(width);
+    if (row_width == 0 or pixels.size() % row_width != 0 or row_begin < 0 or
+        static_cast<std::size_t>(row_begin) + pixels.size() / row_width >
+            static_cast<std::size_t>(height))
+    {
+      throw std::out_of_range("Rows out of range");
+    }
+    auto out = std::span{values}.subspan(static_cast<std::size_t>(row_begin) * row_floats(width),
+                                         channels * pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      out[channels * i]     = static_cast<float>(pixels[i].get_r());
+      out[channels * i + 1] = static_cast<float>(pixels[i].get_g());
+      out[channels * i + 2] = static_cast<float>(pixels[i].get_b());
+    }
+  }
+
+  void hdr_image::get_rows(int const row_begin, int const row_end, std::span<color> out) const {
+    if (row_begin < 0 or row_end < row_begin or row_end > height or
+        out.size() != static_cast<std::size_t>(row_end - row_begin) * row_floats(width) / channels)
+    {
+      throw std::out_of_range("Rows out of range");
+    }
+    auto const in = std::span{values}.subspan(static_cast<std::size_t>(row_begin) *
+                                              row_floats(width), channels * out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      out[i] = color{in[channels * i], in[channels * i + 1], in[channels * i + 2]};
+    }
+  }
+
+  weighted_hdr parse_weighted_hdr(std::string const & argument) {
+    auto const at = argument.rfind('@');
+    if (at == std::string::npos) {
+      return {.path = argument, .weight = 1.0};
+    }
+    std::string const weight_text = argument.substr(at + 1);
+    std::size_t used              = 0;
+    double weight                 = 0.0;
+    try {
+      weight = std::stod(weight_text, &used);
+    } catch (std::exception const &) {
+      used = 0;
+    }
+    if (at == 0 or weight_text.empty() or used != weight_text.size() or not(weight > 0.0)) {
+      throw std::invalid_argument("Error: Invalid weighted input: " + argument);
+    }
+    return {.path = argument.substr(0, at), .weight = weight};
+  }
+
+  hdr_image merge_hdr(std::span<hdr_image const> images, std::span<double const> weights) {
+    if (images.empty() or images.size() != weights.size()) {
+      throw std::invalid_argument("Error: merge_hdr needs one weight per image");
+    }
+    double total = 0.0;
+    for (std::size_t i = 0; i < images.size(); ++i) {
+      if (images[i].get_width() != images[0].get_width() or
+          images[i].get_height() != images[0].get_height())
+      {
+        throw std::invalid_argument("Error: HDR images have different sizes");
+      }
+      if (not(weights[i] > 0.0)) {
+        throw std::invalid_argument("Error: HDR weights must be positive");
+      }
+      total += weights[i];
+    }
+
+    std::vector<double> sum(images[0].data().size(), 0.0);
+    for (std::size_t i = 0; i < images.size(); ++i) {
+      auto const in = images[i].data();
+      for (std::size_t k = 0; k < sum.size(); ++k) {
+        sum[k] += weights[i] * static_cast<double>(in[k]);
+      }
+    }
+
+    hdr_image merged{images[0].get_width(), images[0].get_height()};
+    auto out = merged.data();
+    for (std::size_t k = 0; k < sum.size(); ++k) {
+      out[k] = static_cast<float>(sum[k] / total);
+    }
+    return merged;
+  }
+
+  std::string hdr_path_for(std::string const & output_path) {
+    auto const slash = output_path.find_last_of('/');
+    auto const dot   = output_path.rfind('.');
+    if (dot == std::string::npos or (slash != std::string::npos and dot < slash)) {
+      return output_path + ".pfm";
+    }
+    // Con la salida ya en .pfm, cambiar la extensión daría la misma ruta y el PFM
+    // sobrescribiría la imagen de 8 bits
+    if (output_path.compare(dot, std::string::npos, ".pfm") == 0) {
+      return output_path.substr(0, dot) + ".hdr.pfm";
+    }
+    return output_path.substr(0, dot) + ".pfm";
+  }
+
+  void write_pfm(std::string const & filename, hdr_image const & image) {
+    std::string const header = "PF\n" + std::to_string(image.get_width()) + " " +
+                               std::to_string(image.get_height()) + "\n" +
+                               (std::endian::native == std::endian::little ? "-1.0\n" : "1.0\n");
+    std::size_t const row_bytes = row_floats(image.get_width()) * sizeof(float);
+    std::size_t const pixel_bytes = row_bytes * static_cast<std::size_t>(image.get_height());
+    std::vector<char> buffer(header.size() + pixel_bytes);
+    std::ranges::copy(header, buffer.begin());
+
+    // PFM guarda primero la fila inferior
+    auto const data = image.data();
+    char * pos      = buffer.data() + header.size();
+    for (int y = image.get_height() - 1; y >= 0; --y) {
+      std::memcpy(pos, data.subspan(static_cast<std::size_t>(y) * row_floats(image.get_width()))
+                           .data(),
+                  row_bytes);
+      pos += row_bytes;
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+      throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.close();
+    if (!out) {
+      throw std::runtime_error("Error: Cannot write to file: " + filename);
+    }
+  }
+
+  hdr_image read_pfm(std::string const & filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+      throw std::runtime_error("Error: Cannot open file: " + filename);
+    }
+    std::string magic;
+    int width    = 0;
+    int height   = 0;
+    double scale = 0.0;
+    in >> magic >> width >> height >> scale;
+    // Un único blanco separa la cabecera de los datos
+    in.get();
+    if (!in or magic != "PF" or width <= 0 or height <= 0 or scale == 0.0) {
+      throw std::runtime_error("Error: Invalid PFM header: " + filename);
+    }
+
+    hdr_image image{width, height};
+    std::size_t const row_count = row_floats(width);
+    std::vector<char> row(row_count * sizeof(float));
+    bool const swap = (scale < 0.0) != (std::endian::native == std::endian::little);
+    auto data       = image.data();
+    for (int y = height - 1; y >= 0; --y) {
+      in.read(row.data(), static_cast<std::streamsize>(row.size()));
+      if (!in) {
+        throw std::runtime_error("Error: Truncated PFM file: " + filename);
+      }
+      auto out = data.subspan(static_cast<std::size_t>(y) * row_count, row_count);
+      for (std::size_t k = 0; k < row_count; ++k) {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, row.data() + k * sizeof(float), sizeof(float));
+        out[k] = std::bit_cast<float>(swap ? swap_bytes(bits) : bits);
+      }
+    }
+    return image;
+  }
+
+}  // namespace render
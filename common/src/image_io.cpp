@@ -0,0 +1,518 @@
+#include "image_io.hpp"
+
+#include <oneapi/tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Representación decimal de un byte sin ceros a la izquierda, rellenada hasta 4 bytes para
+    // copiarla siempre con un tamaño fijo
+    struct decimal_entry {
+      std::array<char, 4> digits;
+      std::size_t length;
+    };
+
+    constexpr std::array<decimal_entry, 256> make_decimal_table() {
+      std::array<decimal_entry, 256> table{};
+      for (int value = 0; value < 256; ++value) {
+        auto & entry = table[static_cast<std::size_t>(value)];
+        if (value >= 100) {
+          entry.digits[entry.length++] = static_cast<char>('0' + value / 100);
+        }
+        if (value >= 10) {
+          entry.digits[entry.length++] = static_cast<char>('0' + (value / 10) % 10);
+        }
+        entry.digits[entry.length++] = static_cast<char>('0' + value % 10);
+      }
+      return table;
+    }
+
+    constexpr auto decimal_table = make_decimal_table();
+
+    // Copia 4 bytes y coloca el separador tras los dígitos. Puede escribir hasta 2 bytes de más,
+    // que sobrescribe el valor siguiente, así que no sirve para el último valor del búfer.
+    char * put_decimal_fast(char * pos, std::uint8_t const value, char const separator) {
+      auto const & entry = decimal_table[value];
+      std::memcpy(pos, entry.digits.data(), entry.digits.size());
+      pos[entry.length] = separator;
+      return pos + entry.length + 1;
+    }
+
+    char * put_decimal(char * pos, std::uint8_t const value, char const separator) {
+      auto const & entry = decimal_table[value];
+      std::memcpy(pos, entry.digits.data(), entry.length);
+      pos[entry.length] = separator;
+      return pos + entry.length + 1;
+    }
+
+    // Operaciones QOI
+    constexpr unsigned qoi_op_index = 0x00;
+    constexpr unsigned qoi_op_diff  = 0x40;
+    constexpr unsigned qoi_op_luma  = 0x80;
+    constexpr unsigned qoi_op_run   = 0xC0;
+    constexpr unsigned qoi_op_rgb   = 0xFE;
+    constexpr int qoi_max_run       = 62;
+
+    // Un píxel puede cerrar una racha (1 byte) y ocupar después una operación RGB (4 bytes)
+    constexpr std::ptrdiff_t qoi_max_step_bytes = 5;
+    constexpr std::size_t qoi_buffer_bytes      = 16'384;
+
+    // Posición en la tabla de 64 colores. El alfa es siempre 255.
+    constexpr std::size_t qoi_slot(unsigned const r, unsigned const g, unsigned const b) {
+      return (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+    }
+
+    // Diferencia con signo entre dos bytes, con desbordamiento circular como en QOI
+    constexpr int wrapped_difference(std::uint8_t const value, std::uint8_t const previous) {
+      return static_cast<std::int8_t>(static_cast<std::uint8_t>(value - previous));
+    }
+
+    // Búfer con la cabecera P6 seguida de pixel_bytes bytes para los píxeles
+    std::vector<char> header_buffer(int width, int height, std::size_t pixel_bytes) {
+      std::string const header = ppm_header(image_format::p6, width, height);
+      std::vector<char> buffer(header.size() + pixel_bytes);
+      std::ranges::copy(header, buffer.begin());
+      return buffer;
+    }
+
+    // Cabecera y píxeles van en el mismo búfer para emitir una sola escritura
+    void write_buffer(std::string const & filename, std::span<char const> buffer) {
+      std::ofstream out(filename, std::ios::binary);
+      if (!out.is_open()) {
+        throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+      }
+      out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      out.close();
+      if (!out) {
+        throw std::runtime_error("Error: Cannot write to file: " + filename);
+      }
+    }
+
+  }  // namespace
+
+  image_format resolve_image_format(std::string const & setting, std::string const & path) {
+    if (setting == "p3") {
+      return image_format::p3;
+    }
+    if (setting == "p6") {
+      return image_format::p6;
+    }
+    if (setting == "qoi") {
+      return image_format::qoi;
+    }
+    auto const has_extension = [&](std::string_view const extension) {
+      return path.size() >= extension.size() and
+             path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    };
+    if (has_extension(".pnm")) {
+      return image_format::p6;
+    }
+    return has_extension(".qoi") ? image_format::qoi : image_format::p3;
+  }
+
+  std::string ppm_header(image_format const format, int const width, int const height) {
+    return std::string{format == image_format::p6 ? "P6\n" : "P3\n"} + std::to_string(width) +
+           " " + std::to_string(height) + "\n255\n";
+  }
+
+  void interleave_rgb(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                      std::span<std::uint8_t const> b, std::span<char> out) {
+    if (g.size() != r.size() or b.size() != r.size() or out.size() != 3 * r.size()) {
+      throw std::invalid_argument("interleave_rgb: channel sizes do not match");
+    }
+    for (std::size_t i = 0; i < r.size(); ++i) {
+      out[3 * i]     = static_cast<char>(r[i]);
+      out[3 * i + 1] = static_cast<char>(g[i]);
+      out[3 * i + 2] = static_cast<char>(b[i]);
+    }
+  }
+
+  std::size_t p3_text_length(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                             std::span<std::uint8_t const> b) {
+    std::size_t length = 3 * r.size();
+    for (std::size_t i = 0; i < r.size(); ++i) {
+      length += decimal_table[r[i]].length + decimal_table[g[i]].length +
+                decimal_table[b[i]].length;
+    }
+    return length;
+  }
+
+  std::size_t encode_p3_pixels(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                               std::span<std::uint8_t const> b, std::span<char> out) {
+    if (out.size() < p3_text_length(r, g, b)) {
+      throw std::invalid_argument("encode_p3_pixels: output buffer too small");
+    }
+    if (r.empty()) {
+      return 0;
+    }
+    char * const first     = out.data();
+    char * pos             = first;
+    std::size_t const last = r.size() - 1;
+    for (std::size_t i = 0; i < last; ++i) {
+      pos = put_decimal_fast(pos, r[i], ' ');
+      pos = put_decimal_fast(pos, g[i], ' ');
+      pos = put_decimal_fast(pos, b[i], '\n');
+    }
+    pos = put_decimal_fast(pos, r[last], ' ');
+    pos = put_decimal_fast(pos, g[last], ' ');
+    pos = put_decimal(pos, b[last], '\n');
+    return static_cast<std::size_t>(pos - first);
+  }
+
+  std::string encode_p3(int const width, int const height, std::span<std::uint8_t const> r,
+                        std::span<std::uint8_t const> g, std::span<std::uint8_t const> b) {
+    if (g.size() != r.size() or b.size() != r.size()) {
+      throw std::invalid_argument("encode_p3: channel sizes do not match");
+    }
+    std::string const header = ppm_header(image_format::p3, width, height);
+    std::size_t const pixels = r.size();
+    std::size_t const chunks = (pixels + p3_chunk_pixels - 1) / p3_chunk_pixels;
+
+    auto chunk_of = [&](std::span<std::uint8_t const> channel, std::size_t const chunk) {
+      std::size_t const first = chunk * p3_chunk_pixels;
+      return channel.subspan(first, std::min(p3_chunk_pixels, pixels - first));
+    };
+
+    // Primera pasada: longitud de cada bloque. Después, suma de prefijos para sus posiciones.
+    std::vector<std::size_t> offsets(chunks + 1);
+    offsets[0] = header.size();
+    tbb::parallel_for(std::size_t{0}, chunks, [&](std::size_t const chunk) {
+      offsets[chunk + 1] = p3_text_length(chunk_of(r, chunk), chunk_of(g, chunk),
+                                          chunk_of(b, chunk));
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // Segunda pasada: cada bloque se codifica directamente en su posición final
+    std::string out(offsets.back(), '\0');
+    std::ranges::copy(header, out.begin());
+    tbb::parallel_for(std::size_t{0}, chunks, [&](std::size_t const chunk) {
+      std::span<char> const target{out.data() + offsets[chunk],
+                                   offsets[chunk + 1] - offsets[chunk]};
+      encode_p3_pixels(chunk_of(r, chunk), chunk_of(g, chunk), chunk_of(b, chunk), target);
+    });
+    return out;
+  }
+
+  void write_p3(std::string const & filename, int const width, int const height,
+                std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                std::span<std::uint8_t const> b) {
+    std::string const text = encode_p3(width, height, r, g, b);
+    write_buffer(filename, text);
+  }
+
+  void write_p6(std::string const & filename, int const width, int const height,
+                std::span<char const> rgb) {
+    std::vector<char> buffer = header_buffer(width, height, rgb.size());
+    std::ranges::copy(rgb, buffer.end() - static_cast<std::ptrdiff_t>(rgb.size()));
+    write_buffer(filename, buffer);
+  }
+
+  void write_p6(std::string const & filename, int const width, int const height,
+                std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                std::span<std::uint8_t const> b) {
+    std::vector<char> buffer = header_buffer(width, height, 3 * r.size());
+    interleave_rgb(r, g, b, std::span{buffer}.last(3 * r.size()));
+    write_buffer(filename, buffer);
+  }
+
+  ppm_image read_ppm(std::string const & filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+      throw std::runtime_error("Error: Cannot open file: " + filename);
+    }
+    std::string magic;
+    ppm_image image;
+    int max_value = 0;
+    in >> magic >> image.width >> image.height >> max_value;
+    if (!in or (magic != "P3" and magic != "P6") or image.width <= 0 or image.height <= 0 or
+        max_value != 255)
+    {
+      throw std::runtime_error("Error: Invalid PPM header: " + filename);
+    }
+
+    image.rgb.resize(3 * static_cast<std::size_t>(image.width) *
+                     static_cast<std::size_t>(image.height));
+    if (magic == "P6") {
+      // Un único blanco separa la cabecera de los datos
+      in.get();
+      std::vector<char> bytes(image.rgb.size());
+      in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+      std::ranges::transform(bytes, image.rgb.begin(),
+                             [](char const c) { return static_cast<std::uint8_t>(c); });
+    } else {
+      int value = 0;
+      for (auto & channel : image.rgb) {
+        if (!(in >> value)) {
+          break;
+        }
+        if (value < 0 or value > max_value) {
+          throw std::runtime_error("Error: Invalid PPM value in file: " + filename);
+        }
+        channel = static_cast<std::uint8_t>(value);
+      }
+    }
+    if (!in) {
+      throw std::runtime_error("Error: Truncated PPM file: " + filename);
+    }
+    return image;
+  }
+
+  std::string qoi_header(int const width, int const height) {
+    if (width < 0 or height < 0) {
+      throw std::invalid_argument("qoi_header: invalid image size");
+    }
+    std::string header{"qoif"};
+    for (int const size : {width, height}) {
+      auto const value = static_cast<std::uint32_t>(size);
+      header += static_cast<char>((value >> 24U) & 0xFFU);
+      header += static_cast<char>((value >> 16U) & 0xFFU);
+      header += static_cast<char>((value >> 8U) & 0xFFU);
+      header += static_cast<char>(value & 0xFFU);
+    }
+    header += '\x03';  // RGB
+    header += '\x00';  // sRGB con alfa lineal
+    return header;
+  }
+
+  std::string qoi_end_marker() {
+    return std::string{"\0\0\0\0\0\0\0\x01", 8};
+  }
+
+  void append_qoi_pixels(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                         std::span<std::uint8_t const> b, std::string & out) {
+    if (g.size() != r.size() or b.size() != r.size()) {
+      throw std::invalid_argument("append_qoi_pixels: channel sizes do not match");
+    }
+    if (r.empty()) {
+      return;
+    }
+    // Se codifica en un búfer pequeño que se vuelca a out al llenarse: reservar de golpe el
+    // peor caso (4 bytes por píxel) en cada franja cuesta más en fallos de página que codificar
+    std::array<char, qoi_buffer_bytes> buffer{};
+    char * pos = buffer.data();
+    out.reserve(out.size() + r.size());
+    auto flush = [&] {
+      out.append(buffer.data(), static_cast<std::size_t>(pos - buffer.data()));
+      pos = buffer.data();
+    };
+    auto put     = [&pos](unsigned const byte) { *pos++ = static_cast<char>(byte); };
+    auto put_rgb = [&](std::size_t const i) {
+      put(qoi_op_rgb);
+      put(r[i]);
+      put(g[i]);
+      put(b[i]);
+    };
+
+    // Los colores se guardan como 0x01RRGGBB, de modo que 0 marca una entrada vacía
+    auto pack = [&](std::size_t const i) {
+      return (1U << 24U) | (static_cast<std::uint32_t>(r[i]) << 16U) |
+             (static_cast<std::uint32_t>(g[i]) << 8U) | b[i];
+    };
+    std::array<std::uint32_t, 64> index{};
+
+    // El píxel anterior a la franja es desconocido, así que el primero va completo
+    put_rgb(0);
+    index[qoi_slot(r[0], g[0], b[0])] = pack(0);
+    std::uint32_t previous            = pack(0);
+    int run                           = 0;
+
+    for (std::size_t i = 1; i < r.size(); ++i) {
+      if (buffer.data() + buffer.size() - pos < qoi_max_step_bytes) {
+        flush();
+      }
+      std::uint32_t const pixel = pack(i);
+      if (pixel == previous) {
+        if (++run == qoi_max_run) {
+          put(qoi_op_run | static_cast<unsigned>(run - 1));
+          run = 0;
+        }
+        continue;
+      }
+      if (run > 0) {
+        put(qoi_op_run | static_cast<unsigned>(run - 1));
+        run = 0;
+      }
+
+      std::size_t const slot = qoi_slot(r[i], g[i], b[i]);
+      if (index[slot] == pixel) {
+        put(qoi_op_index | static_cast<unsigned>(slot));
+        previous = pixel;
+        continue;
+      }
+      index[slot] = pixel;
+
+      // Diferencias desplazadas a valores sin signo: cada rango se comprueba con una comparación
+      int const dr      = wrapped_difference(r[i], r[i - 1]);
+      int const dg      = wrapped_difference(g[i], g[i - 1]);
+      int const db      = wrapped_difference(b[i], b[i - 1]);
+      auto const diff_r = static_cast<unsigned>(dr + 2);
+      auto const diff_g = static_cast<unsigned>(dg + 2);
+      auto const diff_b = static_cast<unsigned>(db + 2);
+      auto const luma_g = static_cast<unsigned>(dg + 32);
+      auto const luma_r = static_cast<unsigned>(dr - dg + 8);
+      auto const luma_b = static_cast<unsigned>(db - dg + 8);
+      if ((diff_r | diff_g | diff_b) < 4) {
+        put(qoi_op_diff | (diff_r << 4U) | (diff_g << 2U) | diff_b);
+      } else if (luma_g < 64 and (luma_r | luma_b) < 16) {
+        put(qoi_op_luma | luma_g);
+        put((luma_r << 4U) | luma_b);
+      } else {
+        put_rgb(i);
+      }
+      previous = pixel;
+    }
+    if (run > 0) {
+      put(qoi_op_run | static_cast<unsigned>(run - 1));
+    }
+    flush();
+  }
+
+  std::string encode_qoi(int const width, int const height, std::span<std::uint8_t const> r,
+                         std::span<std::uint8_t const> g, std::span<std::uint8_t const> b) {
+    if (g.size() != r.size() or b.size() != r.size()) {
+      throw std::invalid_argument("encode_qoi: channel sizes do not match");
+    }
+    std::size_t const pixels = r.size();
+    std::size_t const chunks = (pixels + qoi_chunk_pixels - 1) / qoi_chunk_pixels;
+
+    // Cada franja se comprime por separado y después se concatenan en orden
+    std::vector<std::string> strips(chunks);
+    tbb::parallel_for(std::size_t{0}, chunks, [&](std::size_t const chunk) {
+      std::size_t const first = chunk * qoi_chunk_pixels;
+      std::size_t const count = std::min(qoi_chunk_pixels, pixels - first);
+      append_qoi_pixels(r.subspan(first, count), g.subspan(first, count),
+                        b.subspan(first, count), strips[chunk]);
+    });
+
+    std::string out       = qoi_header(width, height);
+    std::string const end = qoi_end_marker();
+    out.reserve(std::accumulate(strips.begin(), strips.end(), out.size() + end.size(),
+                                [](std::size_t const total, std::string const & strip) {
+                                  return total + strip.size();
+                                }));
+    for (auto const & strip : strips) {
+      out += strip;
+    }
+    out += end;
+    return out;
+  }
+
+  void write_qoi(std::string const & filename, int const width, int const height,
+                 std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                 std::span<std::uint8_t const> b) {
+    std::string const data = encode_qoi(width, height, r, g, b);
+    write_buffer(filename, data);
+  }
+
+  void write_image(std::string const & filename, image_format const format, int const width,
+                   int const height, std::span<std::uint8_t const> r,
+                   std::span<std::uint8_t const> g, std::span<std::uint8_t const> b) {
+    switch (format) {
+      case image_format::p3:
+        write_p3(filename, width, height, r, g, b);
+        return;
+      case image_format::p6:
+        write_p6(filename, width, height, r, g, b);
+        return;
+      case image_format::qoi:
+        write_qoi(filename, width, height, r, g, b);
+        return;
+    }
+  }
+
+  std::string image_header(image_format const format, int const width, int const height) {
+    return format == image_format::qoi ? qoi_header(width, height)
+                                       : ppm_header(format, width, height);
+  }
+
+  std::string image_trailer(image_format const format) {
+    return format == image_format::qoi ? qoi_end_marker() : std::string{};
+  }
+
+  void append_encoded_pixels(image_format const format, std::span<std::uint8_t const> r,
+                             std::span<std::uint8_t const> g, std::span<std::uint8_t const> b,
+                             std::string & out) {
+    if (g.size() != r.size() or b.size() != r.size()) {
+      throw std::invalid_argument("append_encoded_pixels: channel sizes do not match");
+    }
+    std::size_t const offset = out.size();
+    switch (format) {
+      case image_format::qoi:
+        append_qoi_pixels(r, g, b, out);
+        break;
+      case image_format::p6:
+        out.resize(offset + 3 * r.size());
+        interleave_rgb(r, g, b, std::span{out}.subspan(offset));
+        break;
+      case image_format::p3:
+        out.resize(offset + p3_text_length(r, g, b));
+        encode_p3_pixels(r, g, b, std::span{out}.subspan(offset));
+        break;
+    }
+  }
+
+  image_stream_writer::image_stream_writer(std::string filename_value,
+                                           image_format const format_value, int const width_value,
+                                           int const height_value)
+      : filename{std::move(filename_value)}, format{format_value}, width{width_value},
+        height{height_value}, out{filename, std::ios::binary} {
+    if (!out.is_open()) {
+      throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+    }
+    write(image_header(format, width, height));
+  }
+
+  void image_stream_writer::write_rows(std::span<std::uint8_t const> r,
+                                       std::span<std::uint8_t const> g,
+                                       std::span<std::uint8_t const> b) {
+    auto const row_width = static_cast<std::size_t>(width);
+    if (row_width == 0 or r.size() % row_width != 0) {
+      throw std::invalid_argument("image_stream_writer: rows must be complete");
+    }
+    scratch.clear();
+    append_encoded_pixels(format, r, g, b, scratch);
+    write_encoded(static_cast<int>(r.size() / row_width), scratch);
+  }
+
+  void image_stream_writer::write_encoded(int const rows, std::string_view const bytes) {
+    if (rows < 0 or rows > height - rows_written) {
+      throw std::invalid_argument("image_stream_writer: more rows than the image height");
+    }
+    write(bytes);
+    rows_written += rows;
+  }
+
+  void image_stream_writer::finish() {
+    if (rows_written != height) {
+      throw std::runtime_error("Error: Incomplete image written to: " + filename);
+    }
+    write(image_trailer(format));
+    out.close();
+    if (!out) {
+      throw std::runtime_error("Error: Cannot write to file: " + filename);
+    }
+  }
+
+  void image_stream_writer::write(std::string_view const bytes) {
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+      throw std::runtime_error("Error: Cannot write to file: " + filename);
+    }
+  }
+
+}  // namespace render
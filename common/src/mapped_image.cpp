@@ -0,0 +1,106 @@
+#include "mapped_image.hpp"
+#include "image_io.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace render {
+
+  mapped_p6_file::mapped_p6_file(std::string filename_value, int const width_value,
+                                 int const height_value)
+      : filename{std::move(filename_value)}, width{width_value}, height{height_value} {
+    if (width < 0 or height < 0) {
+      throw std::invalid_argument("mapped_p6_file: invalid image size");
+    }
+    std::string const header = ppm_header(image_format::p6, width, height);
+    header_size              = header.size();
+    file_size =
+        header_size + 3 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+    // La proyección compartida con escritura necesita el fichero abierto en lectura y escritura
+    file = std::fopen(filename.c_str(), "w+b");
+    if (file == nullptr) {
+      fail("Error: Cannot open file for writing: " + filename);
+    }
+    int const fd = ::fileno(file);
+    if (::ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+      fail("Error: Cannot resize file: " + filename);
+    }
+    void * const mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      fail("Error: Cannot map file: " + filename);
+    }
+    data = static_cast<char *>(mapping);
+
+    // Las bandas llegan en el orden en que las termina cada hilo, no en orden de filas, así que
+    // no se pide MADV_SEQUENTIAL: el núcleo podría soltar páginas que aún se van a escribir.
+    // Tampoco MADV_WILLNEED, que sólo leería por adelantado los huecos recién creados.
+    ::madvise(mapping, file_size, MADV_NORMAL);
+    std::ranges::copy(header, data);
+  }
+
+  mapped_p6_file::~mapped_p6_file() {
+    release();
+  }
+
+  std::span<char> mapped_p6_file::rows(int const row_begin, int const row_end) {
+    if (data == nullptr or row_begin < 0 or row_end < row_begin or row_end > height) {
+      throw std::out_of_range("Rows out of range");
+    }
+    std::size_t const row_bytes = 3 * static_cast<std::size_t>(width);
+    return {data + header_size + static_cast<std::size_t>(row_begin) * row_bytes,
+            static_cast<std::size_t>(row_end - row_begin) * row_bytes};
+  }
+
+  void mapped_p6_file::flush_rows(int const row_begin, int const row_end) {
+    auto const range = rows(row_begin, row_end);
+    if (range.empty()) {
+      return;
+    }
+    // msync exige una dirección alineada a página
+    auto const page  = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    auto const first = std::bit_cast<std::uintptr_t>(range.data()) / page * page;
+    auto const last  = std::bit_cast<std::uintptr_t>(range.data() + range.size());
+    ::msync(std::bit_cast<void *>(first), last - first, MS_ASYNC);
+  }
+
+  void mapped_p6_file::finish() {
+    if (data == nullptr) {
+      throw std::runtime_error("Error: File already closed: " + filename);
+    }
+    if (::msync(data, file_size, MS_SYNC) != 0) {
+      fail("Error: Cannot write to file: " + filename);
+    }
+    release();
+  }
+
+  void mapped_p6_file::fail(std::string const & message) {
+    int const error = errno;
+    release();
+    throw std::system_error(error, std::generic_category(), message);
+  }
+
+  void mapped_p6_file::release() noexcept {
+    if (data != nullptr) {
+      ::munmap(data, file_size);
+      data = nullptr;
+    }
+    if (file != nullptr) {
+      std::fclose(file);
+      file = nullptr;
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,49 @@
+#include "sampling.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace render {
+
+  namespace {
+
+    // Paso de mezcla de splitmix64
+    std::uint64_t splitmix64(std::uint64_t x) {
+      x += 0x9E37'79B9'7F4A'7C15ULL;
+      x  = (x ^ (x >> 30U)) * 0xBF58'476D'1CE4'E5B9ULL;
+      x  = (x ^ (x >> 27U)) * 0x94D0'49BB'1331'11EBULL;
+      return x ^ (x >> 31U);
+    }
+
+  }  // namespace
+
+  parallel_strategy choose_parallel_strategy(std::string const & requested,
+                                             int const image_height,
+                                             int const samples_per_pixel) {
+    if (requested == "rows") {
+      return parallel_strategy::rows;
+    }
+    if (requested == "samples") {
+      return parallel_strategy::samples;
+    }
+
+    // Con un solo fragmento por píxel no hay nada que repartir dentro del píxel
+    if (image_height < few_rows and sample_chunk_count(samples_per_pixel) > 1) {
+      return parallel_strategy::samples;
+    }
+    return parallel_strategy::rows;
+  }
+
+  int sample_chunk_count(int const samples_per_pixel) {
+    if (samples_per_pixel <= 0) {
+      return 0;
+    }
+    return (samples_per_pixel + samples_per_chunk - 1) / samples_per_chunk;
+  }
+
+  std::uint64_t stream_seed(std::uint64_t const base, std::uint64_t const key,
+                            std::uint64_t const sub) {
+    return splitmix64(splitmix64(splitmix64(base) ^ key) ^ sub);
+  }
+
+}  // namespace render
@@ -4,24 +4,36 @@
 #include "ray.hpp"
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace render {
 
-  void scene::add_material(std::string const & name, std::unique_ptr<material> mat) {
-    materials[name] = std::move(mat);
+  scene::material_id scene::add_material(std::string_view const name,
+                                         std::unique_ptr<material> mat) {
+    auto const id = find_material(name);
+    if (id != no_material) {
+      materials[id] = std::move(mat);
+      return id;
+    }
+    auto const added = static_cast<material_id>(materials.size());
+    materials.push_back(std::move(mat));
+    material_ids.emplace(names.emplace_back(name), added);
+    return added;
   }
 
   void scene::add_object(std::unique_ptr<object> obj) {
     objects.push_back(std::move(obj));
   }
 
-  material const * scene::get_material(std::string const & name) const {
-    auto const it = materials.find(name);
-    if (it == materials.end()) {
-      return nullptr;
-    }
-    return it->second.get();
+  scene::material_id scene::find_material(std::string_view const name) const {
+    auto const it = material_ids.find(name);
+    return it == material_ids.end() ? no_material : it->second;
+  }
+
+  material const * scene::get_material(std::string_view const name) const {
+    auto const id = find_material(name);
+    return id == no_material ? nullptr : materials[id].get();
   }
 
   // Encuentra la intersección más cercana entre el rayo y cualquier objeto
@@ -0,0 +1,78 @@
+#include "scene_cache.hpp"
+#include "checkpoint.hpp"
+#include "compiled_scene_cache.hpp"
+#include "scene.hpp"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+  constexpr std::int64_t nanoseconds_per_second = 1'000'000'000;
+
+}  // namespace
+
+namespace render {
+
+  scene_cache::scene_cache(std::size_t const capacity_value) : capacity{capacity_value} {
+    if (capacity == 0) {
+      throw std::invalid_argument("Error: Scene cache capacity must be positive");
+    }
+  }
+
+  std::uint64_t scene_cache::key_for(std::string const & path) {
+    struct stat info{};
+    if (::stat(path.c_str(), &info) != 0) {
+      throw std::runtime_error("Error: Cannot open file: " + path);
+    }
+    file_stamp const stamp{.device   = static_cast<std::uint64_t>(info.st_dev),
+                           .inode    = static_cast<std::uint64_t>(info.st_ino),
+                           .size     = static_cast<std::int64_t>(info.st_size),
+                           .mtime_ns = info.st_mtim.tv_sec * nanoseconds_per_second +
+                                       info.st_mtim.tv_nsec};
+    auto const known = files.find(path);
+    if (known != files.end() and known->second.settled and known->second.stamp == stamp) {
+      return known->second.key;
+    }
+
+    auto const now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    auto const key = fingerprint_files(std::array{path});
+    files.insert_or_assign(
+        path, known_file{.stamp   = stamp,
+                         .key     = key,
+                         .settled = stamp.mtime_ns + nanoseconds_per_second <= now});
+    return key;
+  }
+
+  scene_cache::lookup scene_cache::get(std::string const & path,
+                                       std::string const & disk_cache_dir) {
+    auto const key = key_for(path);
+    auto const it  = std::ranges::find(entries, key, &entry::key);
+    if (it != entries.end()) {
+      entries.splice(entries.begin(), entries, it);
+      return {.value = entries.front().value, .hit = true};
+    }
+
+    auto parsed = std::make_shared<scene>();
+    auto const disk = load_scene_cached(path, disk_cache_dir, *parsed);
+    entries.push_front(entry{.key = key, .value = std::move(parsed)});
+    if (entries.size() > capacity) {
+      auto const evicted = entries.back().key;
+      std::erase_if(files, [&](auto const & known) { return known.second.key == evicted; });
+      entries.pop_back();
+    }
+    return {.value = entries.front().value, .hit = false, .disk = disk};
+  }
+
+}  // namespace render
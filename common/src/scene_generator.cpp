@@ -0,0 +1,248 @@
+#include "scene_generator.hpp"
+#include "material.hpp"
+#include "object.hpp"
+#include "scene.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  // Caja en la que se colocan los objetos: el suelo de scene4, visto desde la cámara de config4
+  constexpr double half_width = 11.0;
+  constexpr double box_height = 4.0;
+
+  // Objetos por grupo en la distribución agrupada
+  constexpr std::size_t objects_per_cluster = 1'000;
+
+  // Nombres de material como los de scene4
+  constexpr std::array<std::string_view, 3> material_prefixes{"matte", "metal", "bubble"};
+
+  void validate_options(render::scene_generator_options const & options) {
+    if (options.object_count == 0) {
+      throw std::invalid_argument("Error: Generated scene needs at least one object");
+    }
+    if (not(options.cylinder_fraction >= 0.0 and options.cylinder_fraction <= 1.0)) {
+      throw std::invalid_argument("Error: Cylinder fraction must be in [0, 1]");
+    }
+    bool const any_weight = std::ranges::any_of(options.material_mix,
+                                                [](double const w) { return w > 0.0; });
+    bool const negative   = std::ranges::any_of(options.material_mix,
+                                                [](double const w) { return not(w >= 0.0); });
+    if (negative or not any_weight) {
+      throw std::invalid_argument("Error: Material mix weights must be non-negative, not all 0");
+    }
+  }
+
+  class generator {
+  public:
+    explicit generator(render::scene_generator_options const & options_p)
+        : options{options_p}, rng{options_p.seed},
+          kind_dist{options_p.material_mix.begin(), options_p.material_mix.end()} { }
+
+    void run(render::scene & scn) {
+      if (options.material_count > 0) {
+        for (std::size_t i = 0; i < options.material_count; ++i) {
+          palette.push_back(add_material(scn, i));
+        }
+      }
+      place_clusters();
+      grid_side = static_cast<std::size_t>(
+          std::ceil(std::sqrt(static_cast<double>(options.object_count))));
+      for (std::size_t i = 0; i < options.object_count; ++i) {
+        render::material const * mat =
+            palette.empty()
+                ? add_material(scn, i)
+                : palette[std::uniform_int_distribution<std::size_t>{0, palette.size() - 1}(rng)];
+        scn.add_object(make_object(i, mat));
+      }
+    }
+
+  private:
+    double uniform(double const low, double const high) {
+      return std::uniform_real_distribution<double>{low, high}(rng);
+    }
+
+    render::vector uniform_color(double const low) {
+      return render::vector{uniform(low, 1.0), uniform(low, 1.0), uniform(low, 1.0)};
+    }
+
+    render::material const * add_material(render::scene & scn, std::size_t const index) {
+      std::size_t const kind = kind_dist(rng);
+      std::unique_ptr<render::material> mat;
+      if (kind == 0) {
+        mat = std::make_unique<render::matte_material>(uniform_color(0.0));
+      } else if (kind == 1) {
+        auto const reflectance = uniform_color(0.5);
+        mat = std::make_unique<render::metal_material>(reflectance, uniform(0.0, 0.5));
+      } else {
+        mat = std::make_unique<render::refractive_material>(uniform(1.1, 1.9));
+      }
+      std::string name{material_prefixes.at(kind)};
+      name += std::to_string(index);
+      return scn.get_material(scn.add_material(name, std::move(mat)));
+    }
+
+    void place_clusters() {
+      if (options.layout != render::scene_layout::clustered) {
+        return;
+      }
+      std::size_t const count =
+          std::max<std::size_t>(1, options.object_count / objects_per_cluster);
+      for (std::size_t i = 0; i < count; ++i) {
+        clusters.push_back(render::vector{uniform(-half_width, half_width),
+                                          uniform(0.0, box_height),
+                                          uniform(-half_width, half_width)});
+      }
+    }
+
+    // Radio típico para que los objetos ocupen una fracción parecida de la caja con cualquier
+    // número de objetos
+    [[nodiscard]] double typical_radius() const {
+      double const volume = 4.0 * half_width * half_width * box_height;
+      return 0.3 * std::cbrt(volume / static_cast<double>(options.object_count));
+    }
+
+    // Centro y radio del objeto index según la distribución
+    std::pair<render::vector, double> place(std::size_t const index) {
+      switch (options.layout) {
+        case render::scene_layout::grid: {
+          double const spacing = 2.0 * half_width / static_cast<double>(grid_side);
+          double const column  = static_cast<double>(index % grid_side) + uniform(0.0, 0.9);
+          double const row     = static_cast<double>(index / grid_side) + uniform(0.0, 0.9);
+          double const x       = -half_width + column * spacing;
+          double const z       = -half_width + row * spacing;
+          return {render::vector{x, 0.2 * spacing, z}, spacing * uniform(0.1, 0.3)};
+        }
+        case render::scene_layout::clustered: {
+          auto const & center = clusters[index % clusters.size()];
+          std::normal_distribution<double> spread{0.0, 1.0};
+          render::vector const offset{spread(rng), spread(rng), spread(rng)};
+          return {center + offset, 0.5 * typical_radius() * uniform(0.5, 1.0)};
+        }
+        case render::scene_layout::uniform:
+          break;
+      }
+      render::vector const center{uniform(-half_width, half_width), uniform(0.0, box_height),
+                                  uniform(-half_width, half_width)};
+      return {center, typical_radius() * uniform(0.5, 1.0)};
+    }
+
+    // Dirección aleatoria de longitud unidad
+    render::vector random_direction() {
+      for (;;) {
+        render::vector const v{uniform(-1.0, 1.0), uniform(-1.0, 1.0), uniform(-1.0, 1.0)};
+        double const length = v.magnitude();
+        if (length > 0.1 and length <= 1.0) {
+          return v / length;
+        }
+      }
+    }
+
+    std::unique_ptr<render::object> make_object(std::size_t const index,
+                                                render::material const * mat) {
+      auto const [center, radius] = place(index);
+      if (uniform(0.0, 1.0) < options.cylinder_fraction) {
+        return std::make_unique<render::cylinder>(center, 0.5 * radius,
+                                                  random_direction() * (2.0 * radius), mat);
+      }
+      return std::make_unique<render::sphere>(center, radius, mat);
+    }
+
+    render::scene_generator_options options;
+    std::mt19937_64 rng;
+    std::discrete_distribution<std::size_t> kind_dist;
+    std::vector<render::material const *> palette;
+    std::vector<render::vector> clusters;
+    std::size_t grid_side{1};
+  };
+
+  // Añade el número con la representación más corta que se vuelve a leer igual
+  void append_number(std::string & line, double const value) {
+    std::array<char, 32> buffer{};
+    auto const result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    line += ' ';
+    line.append(buffer.data(), result.ptr);
+  }
+
+  void append_vector(std::string & line, render::vector const & v) {
+    append_number(line, v.x);
+    append_number(line, v.y);
+    append_number(line, v.z);
+  }
+
+}  // namespace
+
+namespace render {
+
+  scene_layout parse_scene_layout(std::string const & name) {
+    if (name == "uniform") {
+      return scene_layout::uniform;
+    }
+    if (name == "clustered") {
+      return scene_layout::clustered;
+    }
+    if (name == "grid") {
+      return scene_layout::grid;
+    }
+    throw std::invalid_argument("Error: Unknown scene layout: " + name);
+  }
+
+  void generate_scene(scene_generator_options const & options, scene & scn) {
+    validate_options(options);
+    generator{options}.run(scn);
+  }
+
+  void write_scene_text(scene const & scn, std::ostream & out) {
+    std::unordered_map<material const *, std::string const *> names;
+    std::string line;
+    for (scene::material_id id = 0; id < scn.material_count(); ++id) {
+      auto const * mat  = scn.get_material(id);
+      auto const & name = scn.get_material_name(id);
+      names[mat]        = &name;
+      line              = mat->get_type() + ": " + name;
+      if (auto const * glass = dynamic_cast<refractive_material const *>(mat)) {
+        append_number(line, glass->get_refraction_index());
+      } else {
+        append_vector(line, mat->get_reflectance());
+        if (auto const * metal = dynamic_cast<metal_material const *>(mat)) {
+          append_number(line, metal->get_diffusion());
+        }
+      }
+      line += '\n';
+      out << line;
+    }
+
+    for (auto const & obj : scn.get_objects()) {
+      auto const found = names.find(obj->get_material());
+      if (found == names.end()) {
+        throw std::runtime_error("Error: Object material is not part of the scene");
+      }
+      line = obj->get_type() + ":";
+      append_vector(line, obj->get_center());
+      append_number(line, obj->get_radius());
+      if (auto const * cyl = dynamic_cast<cylinder const *>(obj.get())) {
+        append_vector(line, cyl->get_axis());
+      }
+      line += ' ';
+      line += *found->second;
+      line += '\n';
+      out << line;
+    }
+  }
+
+}  // namespace render
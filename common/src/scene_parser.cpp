@@ -3,39 +3,101 @@
 #include "object.hpp"
 #include "scene.hpp"
 #include "vector.hpp"
+
+#include <oneapi/tbb/parallel_for_each.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstddef>
+#include <exception>
 #include <fstream>
+#include <ios>
+#include <limits>
 #include <memory>
-#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace {
 
-  // Divide una cadena en tokens separados por espacios
-  std::vector<std::string> split_ws(std::string const & s) {
-    std::istringstream iss(s);
-    std::vector<std::string> tokens;
-    std::string tok;
-    while (iss >> tok) {
-      tokens.push_back(tok);
+  // Mayor número de tokens de una línea válida (cilindro)
+  constexpr std::size_t max_tokens = 9;
+
+  // Tokens de una línea, que apuntan dentro del texto de la escena. count cuenta todos los
+  // tokens de la línea aunque no quepan en parts.
+  struct line_tokens {
+    std::string_view line;
+    std::array<std::string_view, max_tokens> parts;
+    std::size_t count;
+  };
+
+  // Los mismos separadores que operator>> en la configuración regional "C"
+  constexpr bool is_space(char const c) {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\v' or c == '\f' or c == '\r';
+  }
+
+  // Siguiente token a partir de pos, o vacío si no quedan
+  std::string_view next_token(std::string_view const line, std::size_t & pos) {
+    while (pos < line.size() and is_space(line[pos])) {
+      ++pos;
+    }
+    std::size_t const begin = pos;
+    while (pos < line.size() and not is_space(line[pos])) {
+      ++pos;
+    }
+    return line.substr(begin, pos - begin);
+  }
+
+  line_tokens split_ws(std::string_view const line) {
+    line_tokens tokens{.line = line, .parts = {}, .count = 0};
+    std::size_t pos = 0;
+    for (auto token = next_token(line, pos); not token.empty(); token = next_token(line, pos)) {
+      if (tokens.count < max_tokens) {
+        tokens.parts.at(tokens.count) = token;
+      }
+      ++tokens.count;
     }
     return tokens;
   }
 
+  // Convierte un token como std::stod: admite un signo + inicial e ignora lo que siga al número.
+  // Los errores lanzan las mismas excepciones que std::stod.
+  double to_double(std::string_view const token, std::string_view const line) {
+    auto const * first = token.data();
+    auto const * last  = token.data() + token.size();
+    if (first != last and *first == '+' and first + 1 != last and *(first + 1) != '-') {
+      ++first;
+    }
+    double value         = 0.0;
+    auto const [ptr, ec] = std::from_chars(first, last, value);
+    if (ec == std::errc::invalid_argument) {
+      throw std::invalid_argument("Error: Invalid number [" + std::string{token} +
+                                  "]\nLine: " + std::string{line});
+    }
+    if (ec == std::errc::result_out_of_range) {
+      throw std::out_of_range("Error: Number out of range [" + std::string{token} +
+                              "]\nLine: " + std::string{line});
+    }
+    return value;
+  }
+
   // Parsea un vector 3D desde tres tokens consecutivos
-  render::vector parse_vector(std::vector<std::string> const & parts, size_t start_index) {
-    if (start_index + 2 >= parts.size()) {
+  render::vector parse_vector(line_tokens const & tokens, std::size_t start_index) {
+    if (start_index + 2 >= tokens.count) {
       throw std::runtime_error("Insufficient vector components");
     }
-    return render::vector{std::stod(parts[start_index]), std::stod(parts[start_index + 1]),
-                          std::stod(parts[start_index + 2])};
+    return render::vector{to_double(tokens.parts.at(start_index), tokens.line),
+                          to_double(tokens.parts.at(start_index + 1), tokens.line),
+                          to_double(tokens.parts.at(start_index + 2), tokens.line)};
   }
 
   // Verifica que todos los componentes de reflectancia estén en [0, 1]
   void validate_reflectance(render::vector const & reflectance, std::string const & material_type,
-                            std::string const & line) {
+                            std::string_view line) {
     if (reflectance.x < 0.0 or
         reflectance.x > 1.0 or
         reflectance.y < 0.0 or
@@ -44,24 +106,31 @@ namespace {
         reflectance.z > 1.0)
     {
       throw std::runtime_error(
-          "Error: Invalid " + material_type + " material parameters\nLine: " + line);
+          "Error: Invalid " + material_type + " material parameters\nLine: " + std::string{line});
     }
   }
 
   // Verifica que el número de parámetros sea exactamente el esperado
-  void check_exact_size(std::vector<std::string> const & parts, size_t expected,
-                        std::string const & entity_type, std::string const & line) {
-    if (parts.size() < expected) {
-      throw std::runtime_error("Error: Invalid " + entity_type + " parameters\nLine: " + line);
+  void check_exact_size(line_tokens const & tokens, std::size_t expected,
+                        std::string const & entity_type) {
+    if (tokens.count < expected) {
+      throw std::runtime_error("Error: Invalid " + entity_type + " parameters\nLine: " +
+                               std::string{tokens.line});
     }
 
-    if (parts.size() > expected) {
+    if (tokens.count > expected) {
+      // Solo en caso de error: se vuelve a recorrer la línea para recoger lo que sobra
       std::string extra;
-      for (size_t i = expected; i < parts.size(); ++i) {
+      std::size_t pos = 0;
+      for (std::size_t i = 0; i < tokens.count; ++i) {
+        auto const token = next_token(tokens.line, pos);
+        if (i < expected) {
+          continue;
+        }
         if (i > expected) {
           extra += " ";
         }
-        extra += parts[i];
+        extra += token;
       }
 
       throw std::runtime_error("Error: Extra data after configuration value for key " +
@@ -69,159 +138,352 @@ namespace {
                                "\nExtra: " +
                                extra +
                                "\nLine: " +
-                               line);
+                               std::string{tokens.line});
     }
   }
 
   // Verifica que el nombre del material sea único
-  void validate_material_unique(render::scene const & scn, std::string const & name,
-                                std::string const & line) {
+  void validate_material_unique(render::scene const & scn, std::string_view name,
+                                std::string_view line) {
     if (scn.get_material(name) != nullptr) {
-      throw std::runtime_error(
-          "Error: Material with name [" + name + "] already exists\nLine: " + line);
+      throw std::runtime_error("Error: Material with name [" + std::string{name} +
+                               "] already exists\nLine: " + std::string{line});
     }
   }
 
-  // PARSEADORES DE MATERIALES
-
-  void parse_matte(std::vector<std::string> const & parts, std::string const & line,
-                   render::scene & scn) {
-    check_exact_size(parts, 5, "matte", line);
+  // Error de un objeto cuyo material no está definido antes de su línea
+  std::runtime_error material_not_found(std::string_view name, std::string_view line) {
+    return std::runtime_error("Error: Material not found [" + std::string{name} +
+                              "]\nLine: " + std::string{line});
+  }
 
-    std::string const & name = parts[1];
-    validate_material_unique(scn, name, line);
+  // Material leído de una línea. Se añade a la escena, en orden, cuando ya se han leído todos
+  // los fragmentos. Sin value, los parámetros de la línea no eran válidos.
+  struct parsed_material {
+    std::string_view name;
+    std::unique_ptr<render::material> value;
+    std::size_t line;
+    std::string_view text;
+  };
+
+  // Objeto leído de una línea, con el material aún por resolver
+  struct parsed_object {
+    bool is_cylinder;
+    render::vector center;
+    double radius;
+    render::vector axis;
+    std::string_view material;
+    std::size_t line;
+    std::string_view text;
+  };
+
+  // Primer error de un fragmento o de una fase, con la línea en la que se produce
+  struct parse_error {
+    std::size_t line{std::numeric_limits<std::size_t>::max()};
+    std::exception_ptr error;
+
+    void keep_first(std::size_t const at, std::exception_ptr const & what) {
+      if (at < line) {
+        line  = at;
+        error = what;
+      }
+    }
+  };
+
+  // Fragmento del texto, que empieza en un principio de línea y acaba tras un salto de línea o
+  // al final del texto
+  struct scene_chunk {
+    std::string_view text;
+    std::size_t lines;  // Saltos de línea del fragmento
+    std::size_t first_line;
+    std::vector<parsed_material> materials;
+    std::vector<parsed_object> objects;
+    std::vector<std::unique_ptr<render::object>> built;
+    parse_error error;
+  };
 
-    auto const reflectance = parse_vector(parts, 2);
-    validate_reflectance(reflectance, "matte", line);
+  // PARSEADORES DE MATERIALES
 
-    scn.add_material(name, std::make_unique<render::matte_material>(reflectance));
+  // Lee los parámetros de un material. El tamaño se comprueba antes que el nombre, y el nombre
+  // (repetido o no) antes que los valores, como al leer la escena línea a línea.
+  template <typename Read>
+  void parse_material(line_tokens const & tokens, std::size_t const expected,
+                      std::string const & type, std::size_t const line, scene_chunk & chunk,
+                      Read const & read) {
+    check_exact_size(tokens, expected, type);
+    auto & parsed = chunk.materials.emplace_back(
+        parsed_material{.name = tokens.parts[1], .value = {}, .line = line, .text = tokens.line});
+    parsed.value = read();
   }
 
-  void parse_metal(std::vector<std::string> const & parts, std::string const & line,
-                   render::scene & scn) {
-    check_exact_size(parts, 6, "metal", line);
-
-    std::string const & name = parts[1];
-    validate_material_unique(scn, name, line);
+  std::unique_ptr<render::material> read_matte(line_tokens const & tokens) {
+    auto const reflectance = parse_vector(tokens, 2);
+    validate_reflectance(reflectance, "matte", tokens.line);
+    return std::make_unique<render::matte_material>(reflectance);
+  }
 
-    auto const reflectance = parse_vector(parts, 2);
-    validate_reflectance(reflectance, "metal", line);
+  std::unique_ptr<render::material> read_metal(line_tokens const & tokens) {
+    auto const reflectance = parse_vector(tokens, 2);
+    validate_reflectance(reflectance, "metal", tokens.line);
 
-    double const diffusion = std::stod(parts[5]);
+    double const diffusion = to_double(tokens.parts[5], tokens.line);
     if (diffusion < 0.0) {
-      throw std::runtime_error("Error: Invalid metal material parameters\nLine: " + line);
+      throw std::runtime_error("Error: Invalid metal material parameters\nLine: " +
+                               std::string{tokens.line});
     }
+    return std::make_unique<render::metal_material>(reflectance, diffusion);
+  }
 
-    scn.add_material(name, std::make_unique<render::metal_material>(reflectance, diffusion));
+  std::unique_ptr<render::material> read_refractive(line_tokens const & tokens) {
+    double const ior = to_double(tokens.parts[2], tokens.line);
+    if (ior <= 0.0) {
+      throw std::runtime_error("Error: Invalid refractive material parameters\nLine: " +
+                               std::string{tokens.line});
+    }
+    return std::make_unique<render::refractive_material>(ior);
   }
 
-  void parse_refractive(std::vector<std::string> const & parts, std::string const & line,
-                        render::scene & scn) {
-    check_exact_size(parts, 3, "refractive", line);
+  // PARSEADORES DE OBJETOS
 
-    std::string const & name = parts[1];
-    validate_material_unique(scn, name, line);
+  parsed_object parse_sphere(line_tokens const & tokens, std::size_t const line) {
+    check_exact_size(tokens, 6, "sphere");
 
-    double const ior = std::stod(parts[2]);
-    if (ior <= 0.0) {
-      throw std::runtime_error("Error: Invalid refractive material parameters\nLine: " + line);
+    auto const center   = parse_vector(tokens, 1);
+    double const radius = to_double(tokens.parts[4], tokens.line);
+
+    if (radius <= 0.0) {
+      throw std::runtime_error("Error: Invalid sphere parameters\nLine: " +
+                               std::string{tokens.line});
     }
 
-    scn.add_material(name, std::make_unique<render::refractive_material>(ior));
+    return parsed_object{.is_cylinder = false,
+                         .center      = center,
+                         .radius      = radius,
+                         .axis        = {},
+                         .material    = tokens.parts[5],
+                         .line        = line,
+                         .text        = tokens.line};
   }
 
-  // PARSEADORES DE OBJETOS
-
-  void parse_sphere(std::vector<std::string> const & parts, std::string const & line,
-                    render::scene & scn) {
-    check_exact_size(parts, 6, "sphere", line);
+  parsed_object parse_cylinder(line_tokens const & tokens, std::size_t const line) {
+    check_exact_size(tokens, 9, "cylinder");
 
-    auto const center            = parse_vector(parts, 1);
-    double const radius          = std::stod(parts[4]);
-    std::string const & mat_name = parts[5];
+    auto const center   = parse_vector(tokens, 1);
+    double const radius = to_double(tokens.parts[4], tokens.line);
+    auto const axis     = parse_vector(tokens, 5);
 
     if (radius <= 0.0) {
-      throw std::runtime_error("Error: Invalid sphere parameters\nLine: " + line);
+      throw std::runtime_error("Error: Invalid cylinder parameters\nLine: " +
+                               std::string{tokens.line});
     }
 
-    render::material const * mat = scn.get_material(mat_name);
-    if (mat == nullptr) {
-      throw std::runtime_error("Error: Material not found [" + mat_name + "]\nLine: " + line);
+    if (axis.is_near_zero()) {
+      throw std::runtime_error("Error: Invalid cylinder parameters\nLine: " +
+                               std::string{tokens.line});
     }
 
-    scn.add_object(std::make_unique<render::sphere>(center, radius, mat));
+    return parsed_object{.is_cylinder = true,
+                         .center      = center,
+                         .radius      = radius,
+                         .axis        = axis,
+                         .material    = tokens.parts[8],
+                         .line        = line,
+                         .text        = tokens.line};
   }
 
-  void parse_cylinder(std::vector<std::string> const & parts, std::string const & line,
-                      render::scene & scn) {
-    check_exact_size(parts, 9, "cylinder", line);
+  // Lee las líneas del fragmento hasta la primera con error
+  void parse_chunk(scene_chunk & chunk) {
+    std::size_t line_number = chunk.first_line;
+    std::size_t pos         = 0;
+    auto const text         = chunk.text;
+    chunk.objects.reserve(chunk.lines + 1);
+    try {
+      for (; pos < text.size(); ++line_number) {
+        auto const end  = text.find('\n', pos);
+        auto const line = text.substr(pos, end == std::string_view::npos ? end : end - pos);
+        pos             = end == std::string_view::npos ? text.size() : end + 1;
+
+        auto const tokens = split_ws(line);
+        if (tokens.count == 0) {
+          continue;
+        }
 
-    auto const center            = parse_vector(parts, 1);
-    double const radius          = std::stod(parts[4]);
-    auto const axis              = parse_vector(parts, 5);
-    std::string const & mat_name = parts[8];
+        // Eliminar ':' del final si existe
+        std::string_view tag = tokens.parts[0];
+        if (tag.back() == ':') {
+          tag.remove_suffix(1);
+        }
 
-    if (radius <= 0.0) {
-      throw std::runtime_error("Error: Invalid cylinder parameters\nLine: " + line);
+        // Parsear según tipo de entidad
+        if (tag == "matte") {
+          parse_material(tokens, 5, "matte", line_number, chunk,
+                         [&] { return read_matte(tokens); });
+        } else if (tag == "metal") {
+          parse_material(tokens, 6, "metal", line_number, chunk,
+                         [&] { return read_metal(tokens); });
+        } else if (tag == "refractive") {
+          parse_material(tokens, 3, "refractive", line_number, chunk,
+                         [&] { return read_refractive(tokens); });
+        } else if (tag == "sphere") {
+          chunk.objects.push_back(parse_sphere(tokens, line_number));
+        } else if (tag == "cylinder") {
+          chunk.objects.push_back(parse_cylinder(tokens, line_number));
+        } else {
+          throw std::runtime_error("Error on line " +
+                                   std::to_string(line_number) +
+                                   ": Unknown scene entity [" +
+                                   std::string{tag} +
+                                   "]");
+        }
+      }
+    } catch (...) {
+      chunk.error.keep_first(line_number, std::current_exception());
     }
+  }
 
-    if (axis.is_near_zero()) {
-      throw std::runtime_error("Error: Invalid cylinder parameters\nLine: " + line);
+  // Tamaño aproximado de cada fragmento que se lee en paralelo
+  constexpr std::size_t chunk_bytes = std::size_t{1} << 20;
+
+  // Divide el texto en fragmentos de unos chunk_bytes que acaban en un salto de línea y calcula
+  // el número de su primera línea
+  std::vector<scene_chunk> split_chunks(std::string_view const text) {
+    std::vector<scene_chunk> chunks;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+      auto end = std::min(text.size(), pos + chunk_bytes);
+      if (end < text.size()) {
+        end = text.find('\n', end - 1);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+      }
+      chunks.push_back(scene_chunk{.text       = text.substr(pos, end - pos),
+                                   .lines      = 0,
+                                   .first_line = 1,
+                                   .materials  = {},
+                                   .objects    = {},
+                                   .built      = {},
+                                   .error      = {}});
+      pos = end;
     }
 
-    render::material const * mat = scn.get_material(mat_name);
-    if (mat == nullptr) {
-      throw std::runtime_error("Error: Material not found [" + mat_name + "]\nLine: " + line);
+    tbb::parallel_for_each(chunks.begin(), chunks.end(), [](scene_chunk & chunk) {
+      chunk.lines = static_cast<std::size_t>(std::ranges::count(chunk.text, '\n'));
+    });
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+      chunks[i].first_line = chunks[i - 1].first_line + chunks[i - 1].lines;
     }
+    return chunks;
+  }
 
-    scn.add_object(std::make_unique<render::cylinder>(center, radius, axis, mat));
+  // Línea en la que se definió cada material del texto, por identificador a partir de first_id.
+  // Los identificadores anteriores son de materiales que ya estaban en la escena.
+  struct material_lines {
+    render::scene::material_id first_id;
+    std::vector<std::size_t> line;
+  };
+
+  // Añade a la escena los materiales de todos los fragmentos, en orden de archivo. Se detiene en
+  // el primer error, que puede ser un nombre repetido o unos parámetros no válidos.
+  void add_materials(std::vector<scene_chunk> & chunks, render::scene & scn,
+                     material_lines & defined, parse_error & first) {
+    for (auto & chunk : chunks) {
+      for (auto & parsed : chunk.materials) {
+        if (parsed.line > first.line) {
+          return;
+        }
+        try {
+          validate_material_unique(scn, parsed.name, parsed.text);
+        } catch (...) {
+          // Un nombre repetido se detecta antes que unos parámetros no válidos en la misma línea
+          first.line  = parsed.line;
+          first.error = std::current_exception();
+          return;
+        }
+        if (not parsed.value) {
+          return;
+        }
+        scn.add_material(parsed.name, std::move(parsed.value));
+        defined.line.push_back(parsed.line);
+      }
+    }
+  }
+
+  // Crea los objetos del fragmento con su material, que debe estar definido antes de su línea
+  void build_objects(scene_chunk & chunk, render::scene const & scn,
+                     material_lines const & defined, std::size_t const stop_line) {
+    chunk.built.reserve(chunk.objects.size());
+    for (auto const & parsed : chunk.objects) {
+      if (parsed.line >= stop_line) {
+        return;
+      }
+      auto const id = scn.find_material(parsed.material);
+      // Un material del texto solo se puede usar en las líneas que siguen a su definición
+      bool const defined_before =
+          id != render::scene::no_material and
+          (id < defined.first_id or defined.line[id - defined.first_id] < parsed.line);
+      if (not defined_before) {
+        chunk.error.keep_first(
+            parsed.line, std::make_exception_ptr(material_not_found(parsed.material, parsed.text)));
+        return;
+      }
+      render::material const * mat = scn.get_material(id);
+      if (parsed.is_cylinder) {
+        chunk.built.push_back(
+            std::make_unique<render::cylinder>(parsed.center, parsed.radius, parsed.axis, mat));
+      } else {
+        chunk.built.push_back(std::make_unique<render::sphere>(parsed.center, parsed.radius, mat));
+      }
+    }
   }
 
 }  // namespace
 
 namespace render {
 
-  // Lee archivo de escena línea por línea y parsea materiales y objetos
+  // La escena se lee en tres fases. Primero cada fragmento se lee en paralelo; los objetos
+  // quedan pendientes de su material. Después se añaden los materiales en orden de archivo, y
+  // por último se crean los objetos en paralelo y se añaden también en orden de archivo. Si hay
+  // errores se lanza el de la primera línea, como al leer línea a línea.
+  void parse_scene_text(std::string_view const text, scene & scn) {
+    auto chunks = split_chunks(text);
+    tbb::parallel_for_each(chunks.begin(), chunks.end(), parse_chunk);
+
+    parse_error first;
+    for (auto const & chunk : chunks) {
+      first.keep_first(chunk.error.line, chunk.error.error);
+    }
+    material_lines defined{.first_id = static_cast<scene::material_id>(scn.material_count()),
+                           .line     = {}};
+    add_materials(chunks, scn, defined, first);
+
+    std::size_t const stop_line = first.line;
+    tbb::parallel_for_each(chunks.begin(), chunks.end(), [&](scene_chunk & chunk) {
+      build_objects(chunk, scn, defined, stop_line);
+    });
+    for (auto const & chunk : chunks) {
+      first.keep_first(chunk.error.line, chunk.error.error);
+    }
+    if (first.error) {
+      std::rethrow_exception(first.error);
+    }
+
+    for (auto & chunk : chunks) {
+      for (auto & object : chunk.built) {
+        scn.add_object(std::move(object));
+      }
+    }
+  }
+  // Lee el archivo completo de una vez y lo parsea sin copiar cada línea
   void parse_scene_file(std::string const & path, scene & scn) {
-    std::ifstream ifs(path);
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
     if (!ifs) {
       throw std::runtime_error("Error: Cannot open scene file: " + path);
     }
-    std::string line;
-    int line_number = 0;
-    while (std::getline(ifs, line)) {
-      line_number++;
-      auto const parts = split_ws(line);
-      if (parts.empty()) {
-        continue;
-      }
-
-      std::string tag = parts[0];
-
-      // Eliminar ':' del final si existe
-      if (!tag.empty() and tag.back() == ':') {
-        tag.pop_back();
-      }
-
-      // Parsear según tipo de entidad
-      if (tag == "matte") {
-        parse_matte(parts, line, scn);
-      } else if (tag == "metal") {
-        parse_metal(parts, line, scn);
-      } else if (tag == "refractive") {
-        parse_refractive(parts, line, scn);
-      } else if (tag == "sphere") {
-        parse_sphere(parts, line, scn);
-      } else if (tag == "cylinder") {
-        parse_cylinder(parts, line, scn);
-      } else {
-        throw std::runtime_error("Error on line " +
-                                 std::to_string(line_number) +
-                                 ": Unknown scene entity [" +
-                                 tag +
-                                 "]");
-      }
+    std::string text(static_cast<std::size_t>(ifs.tellg()), '\0');
+    ifs.seekg(0);
+    if (not ifs.read(text.data(), static_cast<std::streamsize>(text.size()))) {
+      throw std::runtime_error("Error: Cannot read scene file: " + path);
     }
+    parse_scene_text(text, scn);
   }
 
 }  // namespace render
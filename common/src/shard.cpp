@@ -0,0 +1,282 @@
+#include "shard.hpp"
+#include "binary_io.hpp"
+#include "hdr_image.hpp"
+#include "image_io.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    constexpr std::array<char, 4> magic{'R', 'S', 'H', 'D'};
+    constexpr std::uint32_t version = 2;
+
+    // Límite de la cadena de formato, para no reservar memoria con una cabecera corrupta
+    constexpr std::uint32_t max_format_length = 64;
+
+    std::size_t band_count(shard_header const & header) {
+      return static_cast<std::size_t>((header.height + header.band_height - 1) /
+                                      header.band_height);
+    }
+
+    // Llama a visit(row_begin, row_end) por cada banda de la parte, en orden
+    template <typename Visit>
+    void for_each_band(shard_header const & header, Visit && visit) {
+      for (std::size_t band = 0; band < band_count(header); ++band) {
+        if (shard_owns_band(header.part, band)) {
+          int const row_begin = static_cast<int>(band) * header.band_height;
+          visit(row_begin, std::min(header.height, row_begin + header.band_height));
+        }
+      }
+    }
+
+    bool valid_header(shard_header const & header) {
+      return header.width > 0 and header.height > 0 and header.band_height > 0 and
+             header.part.count > 0 and header.part.index >= 0 and
+             header.part.index < header.part.count and
+             header.output_format.size() <= max_format_length and
+             (header.strategy == parallel_strategy::rows or
+              header.strategy == parallel_strategy::samples) and
+             (header.ray_streams == 1 or header.ray_streams == 2);
+    }
+
+    std::size_t pixel_count(shard_header const & header) {
+      return static_cast<std::size_t>(shard_rows(header)) *
+             static_cast<std::size_t>(header.width);
+    }
+
+    // Mismo render: todo igual salvo el número de parte
+    bool same_render(shard_header const & a, shard_header const & b) {
+      return a.width == b.width and a.height == b.height and a.band_height == b.band_height and
+             a.part.count == b.part.count and a.fingerprint == b.fingerprint and
+             a.output_format == b.output_format and a.strategy == b.strategy and
+             a.ray_streams == b.ray_streams;
+    }
+
+  }  // namespace
+
+  shard_spec parse_shard_spec(std::string const & text) {
+    auto const slash = text.find('/');
+    shard_spec spec{.index = -1, .count = 0};
+    try {
+      std::size_t index_used = 0;
+      std::size_t count_used = 0;
+      if (slash != std::string::npos) {
+        spec.index = std::stoi(text.substr(0, slash), &index_used);
+        spec.count = std::stoi(text.substr(slash + 1), &count_used);
+      }
+      if (index_used != slash or count_used != text.size() - slash - 1) {
+        spec.count = 0;
+      }
+    } catch (std::exception const &) {
+      spec.count = 0;
+    }
+    if (spec.count <= 0 or spec.index < 0 or spec.index >= spec.count) {
+      throw std::invalid_argument("Error: Invalid shard (expected i/N with 0 <= i < N): " + text);
+    }
+    return spec;
+  }
+
+  bool shard_owns_band(shard_spec const spec, std::size_t const band) {
+    return band % static_cast<std::size_t>(spec.count) == static_cast<std::size_t>(spec.index);
+  }
+
+  int shard_rows(shard_header const & header) {
+    int rows = 0;
+    for_each_band(header, [&](int const row_begin, int const row_end) {
+      rows += row_end - row_begin;
+    });
+    return rows;
+  }
+
+  void write_shard(std::ostream & out, shard_header const & header,
+                   std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                   std::span<std::uint8_t const> b, std::span<float const> linear) {
+    if (not valid_header(header)) {
+      throw std::invalid_argument("Error: Invalid shard header");
+    }
+    std::size_t const pixels = pixel_count(header);
+    if (r.size() != pixels or g.size() != pixels or b.size() != pixels or
+        (not linear.empty() and linear.size() != 3 * pixels))
+    {
+      throw std::invalid_argument("Error: Shard data does not match its bands");
+    }
+    out.write(magic.data(), magic.size());
+    write_raw(out, version);
+    write_raw(out, header.width);
+    write_raw(out, header.height);
+    write_raw(out, header.band_height);
+    write_raw(out, header.part.index);
+    write_raw(out, header.part.count);
+    write_raw(out, header.fingerprint);
+    write_raw(out, static_cast<std::uint32_t>(header.output_format.size()));
+    out.write(header.output_format.data(),
+              static_cast<std::streamsize>(header.output_format.size()));
+    write_raw(out, static_cast<std::uint32_t>(header.strategy));
+    write_raw(out, header.ray_streams);
+    write_raw(out, static_cast<std::uint32_t>(linear.empty() ? 0 : 1));
+    write_raw_span(out, r);
+    write_raw_span(out, g);
+    write_raw_span(out, b);
+    write_raw_span(out, linear);
+  }
+
+  void write_shard_file(std::string const & filename, shard_header const & header,
+                        std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                        std::span<std::uint8_t const> b, std::span<float const> linear) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+      throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+    }
+    write_shard(out, header, r, g, b, linear);
+    out.close();
+    if (!out) {
+      throw std::runtime_error("Error: Cannot write to file: " + filename);
+    }
+  }
+
+  shard read_shard(std::istream & in) {
+    std::array<char, 4> stream_magic{};
+    in.read(stream_magic.data(), stream_magic.size());
+    auto const stream_version = read_raw<std::uint32_t>(in);
+
+    shard part;
+    auto & header          = part.header;
+    header.width           = read_raw<int>(in);
+    header.height          = read_raw<int>(in);
+    header.band_height     = read_raw<int>(in);
+    header.part.index      = read_raw<int>(in);
+    header.part.count      = read_raw<int>(in);
+    header.fingerprint     = read_raw<std::uint64_t>(in);
+    auto const format_size = read_raw<std::uint32_t>(in);
+    if (!in or stream_magic != magic or stream_version != version or
+        format_size > max_format_length)
+    {
+      throw std::runtime_error("Error: Invalid shard data");
+    }
+    header.output_format.resize(format_size);
+    in.read(header.output_format.data(), static_cast<std::streamsize>(format_size));
+    auto const strategy   = read_raw<std::uint32_t>(in);
+    header.ray_streams    = read_raw<int>(in);
+    auto const has_linear = read_raw<std::uint32_t>(in);
+    if (strategy > static_cast<std::uint32_t>(parallel_strategy::samples)) {
+      throw std::runtime_error("Error: Invalid shard data");
+    }
+    header.strategy = static_cast<parallel_strategy>(strategy);
+    if (!in or not valid_header(header) or has_linear > 1) {
+      throw std::runtime_error("Error: Invalid shard data");
+    }
+
+    std::size_t const pixels = pixel_count(header);
+    read_raw_vector(in, part.r, pixels);
+    read_raw_vector(in, part.g, pixels);
+    read_raw_vector(in, part.b, pixels);
+    read_raw_vector(in, part.linear, has_linear == 1 ? 3 * pixels : 0);
+    if (!in) {
+      throw std::runtime_error("Error: Truncated shard data");
+    }
+    return part;
+  }
+
+  shard read_shard_file(std::string const & filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+      throw std::runtime_error("Error: Cannot open file: " + filename);
+    }
+    try {
+      return read_shard(in);
+    } catch (std::runtime_error const & e) {
+      throw std::runtime_error(std::string{e.what()} + ": " + filename);
+    }
+  }
+
+  shard merge_shards(std::span<shard const> shards) {
+    if (shards.empty()) {
+      throw std::invalid_argument("Error: No shards to merge");
+    }
+    shard_header const & first = shards.front().header;
+    if (shards.size() != static_cast<std::size_t>(first.part.count)) {
+      throw std::invalid_argument("Error: Expected " + std::to_string(first.part.count) +
+                                  " shards, got " + std::to_string(shards.size()));
+    }
+    std::vector<bool> seen(shards.size(), false);
+    for (auto const & part : shards) {
+      if (not same_render(part.header, first) or
+          part.linear.empty() != shards.front().linear.empty())
+      {
+        throw std::invalid_argument("Error: Shards come from different renders");
+      }
+      auto const index = static_cast<std::size_t>(part.header.part.index);
+      if (seen[index]) {
+        throw std::invalid_argument("Error: Repeated shard " + std::to_string(index));
+      }
+      seen[index] = true;
+    }
+
+    shard frame;
+    frame.header             = first;
+    frame.header.part        = shard_spec{};
+    std::size_t const pixels = pixel_count(frame.header);
+    frame.r.resize(pixels);
+    frame.g.resize(pixels);
+    frame.b.resize(pixels);
+    frame.linear.resize(shards.front().linear.empty() ? 0 : 3 * pixels);
+
+    auto const row_width = static_cast<std::size_t>(first.width);
+    for (auto const & part : shards) {
+      std::size_t source = 0;
+      for_each_band(part.header, [&](int const row_begin, int const row_end) {
+        std::size_t const target = static_cast<std::size_t>(row_begin) * row_width;
+        std::size_t const count  = static_cast<std::size_t>(row_end - row_begin) * row_width;
+        auto const copy_rows = [&](std::vector<std::uint8_t> const & from,
+                                   std::vector<std::uint8_t> & to) {
+          std::ranges::copy(std::span{from}.subspan(source, count),
+                            std::span{to}.subspan(target, count).begin());
+        };
+        copy_rows(part.r, frame.r);
+        copy_rows(part.g, frame.g);
+        copy_rows(part.b, frame.b);
+        if (not frame.linear.empty()) {
+          std::ranges::copy(std::span{part.linear}.subspan(3 * source, 3 * count),
+                            std::span{frame.linear}.subspan(3 * target, 3 * count).begin());
+        }
+        source += count;
+      });
+    }
+    return frame;
+  }
+
+  void write_shard_image(shard const & frame, std::string const & output_path) {
+    auto const & header = frame.header;
+    if (header.part.count != 1 or frame.r.size() != pixel_count(header)) {
+      throw std::invalid_argument("Error: write_shard_image needs a whole frame");
+    }
+    auto const format = resolve_image_format(header.output_format, output_path);
+    image_stream_writer writer{output_path, format, header.width, header.height};
+    auto const row_width = static_cast<std::size_t>(header.width);
+    for_each_band(header, [&](int const row_begin, int const row_end) {
+      std::size_t const first = static_cast<std::size_t>(row_begin) * row_width;
+      std::size_t const count = static_cast<std::size_t>(row_end - row_begin) * row_width;
+      writer.write_rows(std::span{frame.r}.subspan(first, count),
+                        std::span{frame.g}.subspan(first, count),
+                        std::span{frame.b}.subspan(first, count));
+    });
+    writer.finish();
+
+    if (not frame.linear.empty()) {
+      hdr_image hdr{header.width, header.height};
+      std::ranges::copy(frame.linear, hdr.data().begin());
+      write_pfm(hdr_path_for(output_path), hdr);
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,300 @@
+#include "tile_scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Escala del coste estimado en los contadores atómicos de trabajo pendiente
+    constexpr double cost_scale = 1e6;
+
+    std::uint64_t scaled_cost(double const cost) {
+      return static_cast<std::uint64_t>(std::max(cost, 0.0) * cost_scale) + 1;
+    }
+
+    using clock_type = std::chrono::steady_clock;
+
+  }  // namespace
+
+  // COLA CHASE-LEV
+
+  work_stealing_deque::work_stealing_deque(std::size_t const capacity) : buffer_(capacity) { }
+
+  void work_stealing_deque::push(std::size_t const item) {
+    std::int64_t const b = bottom_.load(std::memory_order_relaxed);
+    if (static_cast<std::size_t>(b) >= buffer_.size()) {
+      throw std::length_error("work_stealing_deque capacity exceeded");
+    }
+    buffer_[static_cast<std::size_t>(b)].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  std::optional<std::size_t> work_stealing_deque::pop() {
+    std::int64_t const b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // Vacía
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    std::optional<std::size_t> item =
+        buffer_[static_cast<std::size_t>(b)].load(std::memory_order_relaxed);
+    if (t == b) {
+      // Último elemento: competir con los ladrones
+      if (not top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+      {
+        item = std::nullopt;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  std::optional<std::size_t> work_stealing_deque::steal() {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t const b = bottom_.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return std::nullopt;
+    }
+
+    std::size_t const item = buffer_[static_cast<std::size_t>(t)].load(std::memory_order_relaxed);
+    if (not top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+    {
+      return std::nullopt;
+    }
+    return item;
+  }
+
+  std::size_t work_stealing_deque::size_hint() const {
+    std::int64_t const b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t const t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+  }
+
+  // ESTADÍSTICAS
+
+  double tile_schedule_stats::imbalance() const {
+    if (busy_seconds.empty()) {
+      return 0.0;
+    }
+    double const total = std::accumulate(busy_seconds.begin(), busy_seconds.end(), 0.0);
+    double const mean  = total / static_cast<double>(busy_seconds.size());
+    if (mean <= 0.0) {
+      return 0.0;
+    }
+    double const max = *std::ranges::max_element(busy_seconds);
+    return (max - mean) / mean;
+  }
+
+  // PLANIFICADOR
+
+  tile_scheduler::tile_scheduler(int const workers) : num_workers{workers} {
+    if (workers <= 0) {
+      throw std::invalid_argument("tile_scheduler needs at least one worker");
+    }
+    threads.reserve(static_cast<std::size_t>(workers - 1));
+    for (std::size_t w = 1; w < static_cast<std::size_t>(workers); ++w) {
+      threads.emplace_back([this, w] { worker_main(w); });
+    }
+  }
+
+  tile_scheduler::~tile_scheduler() {
+    {
+      std::scoped_lock const lock{mutex};
+      stopping = true;
+    }
+    wake.notify_all();
+  }
+
+  void tile_scheduler::worker_main(std::size_t const worker) {
+    std::uint64_t seen = 0;
+    std::unique_lock lock{mutex};
+    while (true) {
+      wake.wait(lock, [&] { return stopping or generation != seen; });
+      if (stopping) {
+        return;
+      }
+      seen              = generation;
+      auto const * task = work;
+      lock.unlock();
+      (*task)(worker);
+      lock.lock();
+      if (--running == 0) {
+        finished.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::vector<std::size_t>>
+      tile_scheduler::initial_assignment(std::span<double const> costs, int const workers) {
+    std::vector<std::size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::stable_sort(order, [&](std::size_t a, std::size_t b) {
+      return costs[a] > costs[b];
+    });
+
+    // Montículo de (carga asignada, hilo) con el hilo menos cargado arriba
+    using load_entry = std::pair<double, int>;
+    std::priority_queue<load_entry, std::vector<load_entry>, std::greater<>> loads;
+    for (int w = 0; w < workers; ++w) {
+      loads.emplace(0.0, w);
+    }
+
+    std::vector<std::vector<std::size_t>> assignment(static_cast<std::size_t>(workers));
+    for (std::size_t const tile : order) {
+      auto [load, worker] = loads.top();
+      loads.pop();
+      assignment[static_cast<std::size_t>(worker)].push_back(tile);
+      loads.emplace(load + std::max(costs[tile], 0.0), worker);
+    }
+
+    // Orden creciente: el propietario extrae por abajo y empieza por el tile más caro
+    for (auto & tiles : assignment) {
+      std::ranges::reverse(tiles);
+    }
+    return assignment;
+  }
+
+  tile_schedule_stats
+      tile_scheduler::run(std::span<double const> costs,
+                          std::function<void(std::size_t, int)> const & body) {
+    auto const workers    = static_cast<std::size_t>(num_workers);
+    auto const assignment = initial_assignment(costs, num_workers);
+
+    std::vector<std::unique_ptr<work_stealing_deque>> deques;
+    deques.reserve(workers);
+    std::vector<std::atomic<std::uint64_t>> pending_cost(workers);
+    std::vector<std::size_t> owner(costs.size());
+    for (std::size_t w = 0; w < workers; ++w) {
+      deques.push_back(std::make_unique<work_stealing_deque>(assignment[w].size()));
+      std::uint64_t total = 0;
+      for (std::size_t const tile : assignment[w]) {
+        deques[w]->push(tile);
+        owner[tile]  = w;
+        total       += scaled_cost(costs[tile]);
+      }
+      pending_cost[w].store(total, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::size_t> unclaimed{costs.size()};
+    std::atomic<std::size_t> steals{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr first_error;
+    std::mutex error_mutex;
+
+    tile_schedule_stats stats;
+    stats.tiles_done.assign(workers, 0);
+    stats.busy_seconds.assign(workers, 0.0);
+
+    auto claim = [&](std::size_t const tile) {
+      unclaimed.fetch_sub(1, std::memory_order_acq_rel);
+      pending_cost[owner[tile]].fetch_sub(scaled_cost(costs[tile]), std::memory_order_relaxed);
+    };
+
+    // Elige como víctima al hilo con más coste pendiente que aún tenga tiles
+    auto busiest_victim = [&](std::size_t const self) -> std::optional<std::size_t> {
+      std::optional<std::size_t> victim;
+      std::uint64_t best = 0;
+      for (std::size_t w = 0; w < workers; ++w) {
+        if (w == self or deques[w]->size_hint() == 0) {
+          continue;
+        }
+        std::uint64_t const pending = pending_cost[w].load(std::memory_order_relaxed);
+        if (not victim or pending > best) {
+          victim = w;
+          best   = pending;
+        }
+      }
+      return victim;
+    };
+
+    std::function<void(std::size_t)> const worker_loop = [&](std::size_t const self) {
+      while (not failed.load(std::memory_order_relaxed) and
+             unclaimed.load(std::memory_order_acquire) > 0)
+      {
+        std::optional<std::size_t> tile = deques[self]->pop();
+        bool stolen                     = false;
+        if (not tile) {
+          auto const victim = busiest_victim(self);
+          if (not victim) {
+            std::this_thread::yield();
+            continue;
+          }
+          tile   = deques[*victim]->steal();
+          stolen = tile.has_value();
+          if (not tile) {
+            continue;
+          }
+        }
+
+        claim(*tile);
+        if (stolen) {
+          steals.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto const start = clock_type::now();
+        try {
+          body(*tile, static_cast<int>(self));
+        } catch (...) {
+          std::scoped_lock const lock{error_mutex};
+          if (not first_error) {
+            first_error = std::current_exception();
+          }
+          failed.store(true, std::memory_order_relaxed);
+        }
+        std::chrono::duration<double> const busy  = clock_type::now() - start;
+        stats.busy_seconds[self]                 += busy.count();
+        ++stats.tiles_done[self];
+      }
+    };
+
+    auto const start = clock_type::now();
+    {
+      std::scoped_lock const lock{mutex};
+      work    = &worker_loop;
+      running = num_workers - 1;
+      ++generation;
+    }
+    wake.notify_all();
+    worker_loop(0);
+    {
+      std::unique_lock lock{mutex};
+      finished.wait(lock, [&] { return running == 0; });
+      work = nullptr;
+    }
+    stats.elapsed_seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    stats.steals          = steals.load();
+
+    if (first_error) {
+      std::rethrow_exception(first_error);
+    }
+    return stats;
+  }
+
+}  // namespace render
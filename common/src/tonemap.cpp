@@ -0,0 +1,72 @@
+#include "tonemap.hpp"
+#include "color.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace render {
+
+  namespace {
+
+    // Byte de referencia, calculado con la misma función que usa set_pixel
+    std::uint8_t reference_byte(double const linear, double const gamma) {
+      return color{linear, 0.0, 0.0}.to_discrete_r(gamma);
+    }
+
+    // Menor double en [0, 1] cuyo byte es al menos target. Los double positivos se ordenan
+    // igual que su representación binaria, así que se busca sobre los bits.
+    double lowest_input_for(std::uint8_t const target, double const gamma) {
+      auto lo = std::bit_cast<std::uint64_t>(0.0);
+      auto hi = std::bit_cast<std::uint64_t>(1.0);
+      while (lo < hi) {
+        std::uint64_t const mid = lo + (hi - lo) / 2;
+        if (reference_byte(std::bit_cast<double>(mid), gamma) >= target) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      return std::bit_cast<double>(lo);
+    }
+
+  }  // namespace
+
+  tonemapper::tonemapper(double const gamma_value) : gamma{gamma_value} {
+    thresholds[0] = -std::numeric_limits<double>::infinity();
+    for (std::size_t k = 1; k < thresholds.size(); ++k) {
+      thresholds[k] = lowest_input_for(static_cast<std::uint8_t>(k), gamma);
+    }
+    for (std::size_t i = 0; i < buckets; ++i) {
+      bucket_start[i] =
+          reference_byte(static_cast<double>(i) / static_cast<double>(buckets), gamma);
+    }
+    last_byte = reference_byte(1.0, gamma);
+  }
+
+  void tonemapper::map(std::span<color const> pixels, std::span<std::uint8_t> r,
+                       std::span<std::uint8_t> g, std::span<std::uint8_t> b) const {
+    if (r.size() != pixels.size() or g.size() != pixels.size() or b.size() != pixels.size()) {
+      throw std::invalid_argument("tonemapper::map: channel sizes do not match");
+    }
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      r[i] = to_discrete(pixels[i].get_r());
+      g[i] = to_discrete(pixels[i].get_g());
+      b[i] = to_discrete(pixels[i].get_b());
+    }
+  }
+
+  void tonemapper::map_interleaved(std::span<color const> pixels, std::span<char> rgb) const {
+    if (rgb.size() != 3 * pixels.size()) {
+      throw std::invalid_argument("tonemapper::map_interleaved: output size does not match");
+    }
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      rgb[3 * i]     = static_cast<char>(to_discrete(pixels[i].get_r()));
+      rgb[3 * i + 1] = static_cast<char>(to_discrete(pixels[i].get_g()));
+      rgb[3 * i + 2] = static_cast<char>(to_discrete(pixels[i].get_b()));
+    }
+  }
+
+}  // namespace render
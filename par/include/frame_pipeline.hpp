@@ -0,0 +1,39 @@
+#ifndef PAR_FRAME_PIPELINE_HPP
+#define PAR_FRAME_PIPELINE_HPP
+
+#include "numa_domains.hpp"
+#include "render_job.hpp"
+#include "sampling.hpp"
+#include "shard.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace render {
+
+// Puntos de control del fotograma. Con path no vacío se guarda en ese fichero, cada interval
+// segundos, el estado de las filas ya escritas. Las rows_done primeras filas vienen de un punto
+// de control anterior: ya están en job.image y job.hdr y no se vuelven a renderizar.
+struct CheckpointPlan {
+    std::string path;
+    double interval{0.0};
+    std::uint64_t fingerprint{0};
+    int rows_done{0};
+};
+
+// Renderiza el fotograma como un grafo TBB por bandas de filas:
+//   render (paralelo) -> tonemap (paralelo) -> codificación (paralelo) -> orden
+//   -> escritura (serie)
+// La escritura de una banda se solapa con el render de las siguientes. Con scheduler: worksteal
+// el render lo hace el planificador de robo de trabajo de common en lugar de TBB. Con
+// mmap_output: on cada banda se cuantiza directamente en el fichero proyectado en memoria, sin
+// pasar por codificación, orden ni escritura.
+//
+// Con shard distinto de 0/1 solo se renderizan las bandas de esa parte y no se escribe ninguna
+// imagen: quedan en job.image y job.hdr para guardarlas en un fichero de parte.
+void run_frame_pipeline(RenderJob & job, NumaDomains const & numa, parallel_strategy strategy,
+                        CheckpointPlan const & plan, shard_spec const & shard);
+
+} // namespace render
+
+#endif // PAR_FRAME_PIPELINE_HPP
@@ -2,17 +2,50 @@
 #define PAR_IMAGE_SOA_HPP
 
 #include "color.hpp"
+#include "image_io.hpp"
+#include "tonemap.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
 #include <iostream>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+// Asignador que no inicializa los elementos: las páginas del framebuffer no se tocan al
+// reservarlas, de modo que la primera escritura decide en qué nodo NUMA residen
+template <typename T>
+class default_init_allocator : public std::allocator<T> {
+public:
+    using std::allocator<T>::allocator;
+
+    template <typename U>
+    struct rebind {
+        using other = default_init_allocator<U>;
+    };
+
+    template <typename U>
+    void construct(U * ptr) noexcept {
+        ::new (static_cast<void *>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U * ptr, Args &&... args) {
+        std::allocator_traits<std::allocator<T>>::construct(
+            static_cast<std::allocator<T> &>(*this), ptr, std::forward<Args>(args)...);
+    }
+};
+
 class ImageSOA {
 public:
-    ImageSOA(int width, int height) : width_(width), height_(height) {
-        if (width > 0 and height > 0) {
+    // Sin allocate_pixels solo se guardan las dimensiones: la salida en flujo cuantiza cada
+    // banda por separado y no necesita los canales de la imagen completa
+    ImageSOA(int width, int height, bool allocate_pixels = true) : width_(width), height_(height) {
+        if (allocate_pixels and width > 0 and height > 0) {
             size_t const total_pixels = static_cast<size_t>(width_) * static_cast<size_t>(height_);
             r_channel_.resize(total_pixels);
             g_channel_.resize(total_pixels);
@@ -24,6 +57,21 @@ public:
 
     [[nodiscard]] int get_height() const { return height_; }
 
+    // Escribe las filas [row_begin, row_end) para fijar sus páginas en el nodo del hilo actual
+    void first_touch_rows(int row_begin, int row_end) {
+        if (r_channel_.empty() or row_begin >= row_end) {
+            return;
+        }
+        size_t const first = static_cast<size_t>(row_begin) * static_cast<size_t>(width_);
+        size_t const last  = static_cast<size_t>(row_end) * static_cast<size_t>(width_);
+        std::fill(r_channel_.begin() + static_cast<std::ptrdiff_t>(first),
+                  r_channel_.begin() + static_cast<std::ptrdiff_t>(last), uint8_t{0});
+        std::fill(g_channel_.begin() + static_cast<std::ptrdiff_t>(first),
+                  g_channel_.begin() + static_cast<std::ptrdiff_t>(last), uint8_t{0});
+        std::fill(b_channel_.begin() + static_cast<std::ptrdiff_t>(first),
+                  b_channel_.begin() + static_cast<std::ptrdiff_t>(last), uint8_t{0});
+    }
+
     void set_pixel(int x, int y, render::color const & color, double gamma) {
         if (width_ <= 0 or height_ <= 0) {
             return;
@@ -41,27 +89,74 @@ public:
         b_channel_[index] = color.to_discrete_b(gamma);
     }
 
-    void save_ppm(std::string const & filename) const {
-        std::ofstream out(filename);
-        if (!out.is_open()) {
-            throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+    // Convierte las filas [row_begin, row_end) desde sus colores lineales, fila a fila
+    void set_rows(int row_begin, int row_end, std::span<render::color const> pixels,
+                  render::tonemapper const & tonemap) {
+        if (r_channel_.empty() or row_begin >= row_end) {
+            return;
+        }
+        size_t const first = static_cast<size_t>(row_begin) * static_cast<size_t>(width_);
+        size_t const count = static_cast<size_t>(row_end - row_begin) * width_size();
+        if (row_begin < 0 or row_end > height_ or pixels.size() != count) {
+            return;
+        }
+        tonemap.map(pixels, std::span{r_channel_}.subspan(first, count),
+                    std::span{g_channel_}.subspan(first, count),
+                    std::span{b_channel_}.subspan(first, count));
+    }
+
+    // Añade a out las filas [row_begin, row_end) codificadas en el formato dado, sin cabecera
+    void append_rows(render::image_format format, int row_begin, int row_end,
+                     std::string & out) const {
+        if (r_channel_.empty() or row_begin >= row_end) {
+            return;
         }
+        size_t const first = static_cast<size_t>(row_begin) * static_cast<size_t>(width_);
+        size_t const count = static_cast<size_t>(row_end - row_begin) * width_size();
+        render::append_encoded_pixels(format, std::span{r_channel_}.subspan(first, count),
+                                      std::span{g_channel_}.subspan(first, count),
+                                      std::span{b_channel_}.subspan(first, count), out);
+    }
 
-        out << "P3\n" << width_ << " " << height_ << "\n255\n";
+    // Canales r, g y b de las filas [row_begin, row_end), para guardar o restaurar un punto de
+    // control. Vacíos si la imagen no tiene píxeles o las filas no son válidas.
+    [[nodiscard]] std::array<std::span<uint8_t>, 3> channel_rows(int row_begin, int row_end) {
+        if (r_channel_.empty() or row_begin < 0 or row_end <= row_begin or row_end > height_) {
+            return {};
+        }
+        size_t const first = static_cast<size_t>(row_begin) * width_size();
+        size_t const count = static_cast<size_t>(row_end - row_begin) * width_size();
+        return {std::span{r_channel_}.subspan(first, count),
+                std::span{g_channel_}.subspan(first, count),
+                std::span{b_channel_}.subspan(first, count)};
+    }
 
-        size_t const total_pixels = static_cast<size_t>(width_) * static_cast<size_t>(height_);
-        for (size_t i = 0; i < total_pixels; ++i) {
-            out << static_cast<int>(r_channel_[i]) << " " << static_cast<int>(g_channel_[i]) << " "
-                << static_cast<int>(b_channel_[i]) << "\n";
+    // Guarda la imagen como P3 (texto) o P6 (binario, una sola escritura)
+    void save_ppm(std::string const & filename,
+                  render::image_format format = render::image_format::p3) const {
+        if (format == render::image_format::p6) {
+            render::write_p6(filename, width_, height_, r_channel_, g_channel_, b_channel_);
+            return;
         }
+
+        render::write_p3(filename, width_, height_, r_channel_, g_channel_, b_channel_);
+    }
+
+    // Guarda la imagen comprimida sin pérdidas (QOI)
+    void save_qoi(std::string const & filename) const {
+        render::write_qoi(filename, width_, height_, r_channel_, g_channel_, b_channel_);
     }
 
 private:
+    [[nodiscard]] size_t width_size() const { return static_cast<size_t>(width_); }
+
     int width_{0};
     int height_{0};
-    std::vector<uint8_t> r_channel_;
-    std::vector<uint8_t> g_channel_;
-    std::vector<uint8_t> b_channel_;
+    using channel = std::vector<uint8_t, default_init_allocator<uint8_t>>;
+
+    channel r_channel_;
+    channel g_channel_;
+    channel b_channel_;
 };
 
 #endif // PAR_IMAGE_SOA_HPP
@@ -0,0 +1,59 @@
+#ifndef PAR_NUMA_DOMAINS_HPP
+#define PAR_NUMA_DOMAINS_HPP
+
+#include "render_job.hpp"
+#include "scene.hpp"
+
+#include <oneapi/tbb/info.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace render {
+
+// Arena de un nodo NUMA con su banda de filas y, opcionalmente, su copia de la escena
+struct NumaDomain {
+    tbb::numa_node_id node;
+    std::unique_ptr<tbb::task_arena> arena;
+    int row_begin;
+    int row_end;
+    std::unique_ptr<scene> scene_copy;
+};
+
+// Conjunto de arenas NUMA. Vacío si numa está desactivado o sólo hay un nodo, en cuyo caso
+// todo el trabajo se ejecuta en la arena global.
+class NumaDomains {
+public:
+    NumaDomains() = default;
+
+    // Crea una arena por nodo, reparte las filas en proporción a sus núcleos, toca primero
+    // cada banda del framebuffer desde su nodo y replica la escena si se ha pedido
+    static NumaDomains prepare(RenderJob & job);
+
+    [[nodiscard]] bool empty() const { return domains_.empty(); }
+
+    // Escena que deben usar los rayos de la fila dada
+    [[nodiscard]] scene const & scene_for(RenderJob const & job, int row) const;
+
+    // Ejecuta fn dentro de la arena del nodo propietario de la fila dada
+    template <typename Fn>
+    void execute_for_row(int row, Fn const & fn) const {
+        NumaDomain const * domain = find(row);
+        if (domain == nullptr) {
+            fn();
+            return;
+        }
+        domain->arena->execute(fn);
+    }
+
+private:
+    std::vector<NumaDomain> domains_;
+
+    [[nodiscard]] NumaDomain const * find(int row) const;
+};
+
+} // namespace render
+
+#endif // PAR_NUMA_DOMAINS_HPP
@@ -0,0 +1,26 @@
+#ifndef PAR_RENDER_FRAME_HPP
+#define PAR_RENDER_FRAME_HPP
+
+#include "config.hpp"
+#include "frame_pipeline.hpp"
+#include "render_job.hpp"
+#include "shard.hpp"
+
+#include <span>
+
+namespace render {
+
+// Renderiza el fotograma y lo escribe por bandas mediante el grafo de flujo. Aplica los límites
+// de hilos y la afinidad de la configuración solo mientras dura el render, así que puede
+// llamarse varias veces en el mismo proceso con configuraciones distintas.
+void render_frame(RenderJob & job, CheckpointPlan const & plan, shard_spec const & shard);
+
+// Renderiza a la vez varios fotogramas independientes, cada uno con su propio grafo de flujo
+// sobre los mismos hilos de TBB. Pensado para imágenes pequeñas, que por separado no ocupan
+// todos los hilos. Los límites de hilos y la afinidad son los de cfg; los fotogramas se
+// renderizan siempre con el planificador de TBB y sin NUMA, que no se pueden compartir.
+void render_frames(std::span<RenderJob> jobs, config const & cfg);
+
+} // namespace render
+
+#endif // PAR_RENDER_FRAME_HPP
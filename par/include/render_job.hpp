@@ -0,0 +1,77 @@
+#ifndef PAR_RENDER_JOB_HPP
+#define PAR_RENDER_JOB_HPP
+
+#include "camera.hpp"
+#include "color.hpp"
+#include "compiled_scene_cache.hpp"
+#include "config.hpp"
+#include "hdr_image.hpp"
+#include "image_soa_par.hpp"
+#include "sampling.hpp"
+#include "scene.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+
+namespace render {
+
+// Contiene toda la información necesaria para renderizar un fotograma
+struct RenderJob {
+    config cfg;
+    std::shared_ptr<scene const> scene_data;  // Puede compartirse entre trabajos
+    camera cam;
+    ImageSOA image;
+    hdr_image hdr;  // Color lineal; solo se reserva con framebuffer: hdr
+    std::string scene_path;
+    std::string output_path;
+    // Cómo se cargó la escena: off si no pasó por la caché en disco o ya venía leída
+    scene_cache_status scene_cache{scene_cache_status::off};
+    // Estrategia de reparto resuelta al crear el trabajo. Es la que se usa al renderizar y la
+    // que se guarda en las partes, para no volver a resolver parallel_strategy: auto.
+    parallel_strategy strategy{parallel_strategy::rows};
+
+    // Lee la configuración y la escena, esta a través de la caché en disco si scene_cache_dir
+    // está configurado
+    RenderJob(std::string const & config_path, std::string const & scene_path_p,
+              std::string output_path_p);
+
+    // Trabajo con una configuración ya cargada y una escena ya leída
+    RenderJob(config cfg_p, std::shared_ptr<scene const> scene_p, std::string scene_path_p,
+              std::string output_path_p);
+
+    // Generadores de un flujo aleatorio identificado por (key, sub). Cada fila o fragmento de
+    // muestras tiene su propio flujo, por lo que la imagen no depende del reparto entre hilos.
+    [[nodiscard]] std::mt19937_64 ray_stream(std::uint64_t key, std::uint64_t sub = 0) const {
+        return std::mt19937_64{stream_seed(cfg.get_ray_rng_seed(), key, sub)};
+    }
+
+    [[nodiscard]] std::mt19937_64 material_stream(std::uint64_t key, std::uint64_t sub = 0) const {
+        return std::mt19937_64{stream_seed(cfg.get_material_rng_seed(), key, sub)};
+    }
+};
+
+// Renderiza las filas [row_begin, row_end) y deja en out el color lineal medio de cada píxel,
+// fila a fila. out debe tener (row_end - row_begin) * ancho elementos.
+void render_band(RenderJob const & job, scene const & scn, parallel_strategy strategy,
+                 int row_begin, int row_end, std::span<color> out);
+
+// Igual que render_band, pero todo el trabajo se hace en el hilo que llama. Lo usan los
+// planificadores propios, que ya reparten las bandas entre sus hilos.
+void render_band_inline(RenderJob const & job, scene const & scn, parallel_strategy strategy,
+                        int row_begin, int row_end, std::span<color> out);
+
+// Separación en píxeles de la pasada de baja resolución y flujo aleatorio que usa
+inline constexpr int probe_stride           = 8;
+inline constexpr std::uint64_t probe_stream = ~std::uint64_t{0};
+
+// Coste estimado de las filas [row_begin, row_end) a partir de una pasada de baja resolución
+// (una muestra cada probe_stride píxeles en cada dirección) que cuenta los rebotes. Es
+// determinista y no altera los flujos aleatorios de la imagen.
+double estimate_band_cost(RenderJob const & job, scene const & scn, int row_begin, int row_end);
+
+} // namespace render
+
+#endif // PAR_RENDER_JOB_HPP
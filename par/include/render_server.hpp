@@ -0,0 +1,74 @@
+#ifndef PAR_RENDER_SERVER_HPP
+#define PAR_RENDER_SERVER_HPP
+
+#include "scene_cache.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace render {
+
+// Petición al servidor de render. Es texto, una orden por línea, y termina cuando el cliente
+// cierra su lado de escritura:
+//   config <ruta>           configuración de partida (opcional; si no, la de por defecto)
+//   set <clave>: <valores>  sobrescribe una clave, con el formato del fichero de configuración
+//   scene <ruta>            escena a renderizar
+//   output <ruta>           imagen de salida
+// o la única orden "shutdown", que detiene el servidor. Las rutas las resuelve el servidor, así
+// que conviene enviarlas absolutas.
+struct RenderRequest {
+    std::string config_path;
+    std::string overrides;  // Líneas "clave: valores" de las órdenes set
+    std::string scene_path;
+    std::string output_path;
+    bool shutdown{false};
+};
+
+// Interpreta el texto de una petición. Lanza std::invalid_argument si tiene una orden
+// desconocida o le falta la escena o la salida.
+RenderRequest parse_render_request(std::string const & text);
+
+// Texto de la petición, tal como lo interpreta parse_render_request
+std::string format_render_request(RenderRequest const & request);
+
+// Envía la petición al servidor que escucha en socket_path y devuelve su línea de respuesta,
+// sin el salto de línea final. Espera a que el render termine.
+std::string submit_render_request(std::string const & socket_path, RenderRequest const & request);
+
+// Servidor de render persistente. Escucha en un socket local de Unix y atiende las peticiones
+// de una en una, cada una en su propia conexión. Mantiene en memoria las últimas escenas leídas
+// y el conjunto de hilos de TBB, así que un trabajo pequeño no paga el arranque del proceso ni
+// la lectura de una escena ya conocida.
+//
+// A cada petición responde con una sola línea:
+//   ok scene=hit|miss [disk=hit|miss] load=<s> render=<s> total=<s>
+// disk aparece cuando la escena no estaba en memoria y se cargó a través de la caché en disco
+// (scene_cache_dir en la configuración de la petición).
+//   error <mensaje>
+class RenderServer {
+public:
+    // Crea el socket en socket_path. Si ya hay un socket en esa ruta se sustituye; si hay
+    // cualquier otro fichero lanza std::runtime_error.
+    RenderServer(std::string socket_path, std::size_t max_scenes);
+    ~RenderServer();
+
+    RenderServer(RenderServer const &)             = delete;
+    RenderServer & operator=(RenderServer const &) = delete;
+    RenderServer(RenderServer &&)                  = delete;
+    RenderServer & operator=(RenderServer &&)      = delete;
+
+    // Atiende peticiones hasta recibir shutdown
+    void run();
+
+private:
+    // Ejecuta una petición y devuelve la línea de respuesta
+    std::string handle(RenderRequest const & request);
+
+    std::string socket_path;
+    int listen_fd{-1};
+    scene_cache scenes;
+};
+
+} // namespace render
+
+#endif // PAR_RENDER_SERVER_HPP
@@ -0,0 +1,17 @@
+#ifndef PAR_SHARD_WORKERS_HPP
+#define PAR_SHARD_WORKERS_HPP
+
+#include <string>
+
+namespace render {
+
+// Coordinador local del render distribuido: lanza workers procesos de este mismo ejecutable con
+// --shard i/N, recibe cada parte por una tubería, las junta y escribe la imagen final (y su PFM
+// si la configuración lo pide). Hace el papel que en un clúster tendría copiar los ficheros de
+// parte a una máquina y ejecutar render-merge.
+void render_with_workers(int workers, std::string const & config_path,
+                         std::string const & scene_path, std::string const & output_path);
+
+} // namespace render
+
+#endif // PAR_SHARD_WORKERS_HPP
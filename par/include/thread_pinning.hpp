@@ -0,0 +1,51 @@
+#ifndef PAR_THREAD_PINNING_HPP
+#define PAR_THREAD_PINNING_HPP
+
+#include "config.hpp"
+
+#include <oneapi/tbb/task_scheduler_observer.h>
+
+#include <sched.h>
+#include <sys/types.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace render {
+
+// Fija cada hilo que entra en una arena TBB a una CPU lógica según thread_affinity. El hilo con
+// índice de arena k usa la CPU k del plan (cíclicamente si hay más hilos que CPU). Cada hilo
+// recupera la máscara original del proceso al salir de la arena, y los que siguen dentro al
+// destruir el observador, de modo que un render posterior sin afinidad no hereda la fijación.
+class ThreadPinning : public tbb::task_scheduler_observer {
+public:
+    explicit ThreadPinning(std::vector<int> cpus);
+    ~ThreadPinning() override;
+
+    ThreadPinning(ThreadPinning const &)             = delete;
+    ThreadPinning & operator=(ThreadPinning const &) = delete;
+    ThreadPinning(ThreadPinning &&)                  = delete;
+    ThreadPinning & operator=(ThreadPinning &&)      = delete;
+
+    // Lee la topología de /sys y activa el observador. Devuelve nullptr con thread_affinity: none,
+    // si no se puede obtener la máscara de CPU del proceso o con numa: on en una máquina con
+    // varios nodos, donde las arenas por nodo ya fijan sus hilos con set_numa_id.
+    static std::unique_ptr<ThreadPinning> create(config const & cfg);
+
+    [[nodiscard]] std::size_t cpu_count() const { return cpus_.size(); }
+
+    void on_scheduler_entry(bool is_worker) override;
+    void on_scheduler_exit(bool is_worker) override;
+
+private:
+    std::vector<int> cpus_;
+    cpu_set_t original_mask_{};
+    std::mutex pinned_mutex_;
+    std::vector<pid_t> pinned_;  // Hilos fijados que aún no han recuperado su máscara
+};
+
+} // namespace render
+
+#endif // PAR_THREAD_PINNING_HPP
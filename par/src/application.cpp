@@ -1,235 +1,371 @@
 #include "application.hpp"
-#include "camera.hpp"
-#include "color.hpp"
+#include "batch_file.hpp"
+#include "camera_path.hpp"
+#include "checkpoint.hpp"
+#include "compiled_scene_cache.hpp"
 #include "config.hpp"
-#include "image_soa_par.hpp" 
-#include "object.hpp"
-#include "ray.hpp"
+#include "frame_pipeline.hpp"
+#include "hdr_image.hpp"
+#include "render_frame.hpp"
+#include "render_job.hpp"
 #include "scene.hpp"
-#include "scene_parser.hpp"
-#include "vector.hpp"
+#include "shard.hpp"
+#include "shard_workers.hpp"
 
-#include <oneapi/tbb/enumerable_thread_specific.h>
-#include <oneapi/tbb/partitioner.h>
-#include <oneapi/tbb/blocked_range.h>
-#include <oneapi/tbb/parallel_for.h>
-#include <oneapi/tbb/global_control.h>
+#include <oneapi/tbb/task_group.h>
 
 #include <algorithm>
-#include <functional>
-#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
+#include <filesystem>
 #include <gsl/span>
 #include <iostream>
-#include <limits>
 #include <memory>
-#include <random>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace {
 
-  struct ThreadLocalRNGs {
-      std::mt19937_64 * ray;
-      std::mt19937_64 * material;
-  };
-
-  struct RenderJob {
-    render::config cfg;
-    render::scene scene_data;
-    render::camera cam;
-    ImageSOA image;
-    std::string output_path;
-
-    std::vector<std::uint64_t> ray_seeds;
-    std::vector<std::uint64_t> material_seeds;
-    tbb::enumerable_thread_specific<std::mt19937_64> ray_rngs;
-    tbb::enumerable_thread_specific<std::mt19937_64> material_rngs;
-
-    RenderJob(std::string const & config_path, std::string const & scene_path,
-              std::string output_path_p)
-        : cam{cfg}, image{1, 1}, output_path(std::move(output_path_p)) {
-      
-      load_resources(config_path, scene_path);
-      init_rngs();
-    }
-
-  private:
-    void load_resources(std::string const & config_path, std::string const & scene_path) {
-      render::load_config(config_path, cfg);
-      render::parse_scene_file(scene_path, scene_data);
-
-      int const image_width = cfg.get_image_width();
-      auto const aspect_ratio =
-          static_cast<double>(cfg.get_aspect_width()) / cfg.get_aspect_height();
-      int const image_height = static_cast<int>(image_width / aspect_ratio);
-
-      cam = render::camera{cfg};
-      image = ImageSOA{image_width, image_height};
-    }
-
-    void init_rngs() {
-      size_t const num_seeds = 256; 
-      ray_seeds.resize(num_seeds);
-      material_seeds.resize(num_seeds);
-
-    std::mt19937_64 master_ray_gen{
-        static_cast<std::mt19937_64::result_type>(cfg.get_ray_rng_seed())};
-    std::ranges::generate(ray_seeds, std::ref(master_ray_gen));
-
-    std::mt19937_64 master_mat_gen{
-        static_cast<std::mt19937_64::result_type>(cfg.get_material_rng_seed())};
-    std::ranges::generate(material_seeds, std::ref(master_mat_gen));
-
-      ray_rngs = tbb::enumerable_thread_specific<std::mt19937_64>{[this] {
-          static std::atomic<size_t> counter{0};
-          size_t const idx = counter++ % this->ray_seeds.size();
-          return std::mt19937_64{this->ray_seeds[idx]};
-      }};
-
-      material_rngs = tbb::enumerable_thread_specific<std::mt19937_64>{[this] {
-          static std::atomic<size_t> counter{0};
-          size_t const idx = counter++ % this->material_seeds.size();
-          return std::mt19937_64{this->material_seeds[idx]};
-      }};
-    }
-  };
-
-  // Calcula color de un rayo recursivamente
-  render::color ray_color(render::ray const & r, RenderJob const & job, int depth,
-                          std::mt19937_64 & mat_rng) {
-    if (depth <= 0) {
-      return render::color{0.0, 0.0, 0.0};
-    }
-
-    render::hit_record rec;
-    constexpr double min_t = 1e-3;
-
-    if (job.scene_data.hit(r, min_t, std::numeric_limits<double>::infinity(), rec)) {
-      render::ray scattered;
-      if (rec.mat_ptr != nullptr) {
-        auto const result = rec.mat_ptr->scatter(r, rec, scattered, mat_rng);
-        if (result.scattered) {
-          return render::color{result.attenuation} * ray_color(scattered, job, depth - 1, mat_rng);
-        }
+  // Prepara los puntos de control. Con resume restaura en job las filas que ya estaban terminadas
+  // en el último punto de control; si no lo hay, el render empieza desde el principio.
+  render::CheckpointPlan prepare_checkpoints(render::RenderJob & job,
+                                             std::string const & config_path, bool const resume) {
+    render::CheckpointPlan plan;
+    double const interval = job.cfg.get_checkpoint_interval();
+    if (interval <= 0.0 and not resume) {
+      return plan;
+    }
+    // Solo se puede guardar o restaurar lo ya escrito si la imagen completa está en memoria
+    if (job.cfg.get_stream_window() > 0 or job.cfg.get_mmap_output() == "on") {
+      if (resume) {
+        throw std::runtime_error(
+            "Error: --resume requires stream_window: 0 and mmap_output: off");
       }
-      return render::color{0.0, 0.0, 0.0};
+      std::cout << "Puntos de control: no se aplican a la salida en flujo ni proyectada.\n";
+      return plan;
+    }
+
+    plan.path        = render::checkpoint_path_for(job.output_path);
+    plan.interval    = interval;
+    plan.fingerprint = render::fingerprint_files(std::vector{config_path, job.scene_path});
+    if (interval > 0.0) {
+      std::cout << "Puntos de control: cada " << interval << " s en " << plan.path << "\n";
+    }
+    if (not resume) {
+      return plan;
+    }
+    if (not std::filesystem::exists(plan.path)) {
+      std::cout << "Reanudación: no hay punto de control, se empieza desde el principio.\n";
+      return plan;
     }
 
-    render::vector const unit_direction = r.get_direction().normalized();
-    auto const t = 0.5 * (unit_direction.y + 1.0);
-    return render::color{(1.0 - t) * job.cfg.get_background_light_color() +
-                         t * job.cfg.get_background_dark_color()};
+    auto const state    = render::read_checkpoint(plan.path);
+    auto const & header = state.header;
+    if (header.width != job.image.get_width() or header.height != job.image.get_height() or
+        header.band_height != job.cfg.get_tile_height() or
+        header.fingerprint != plan.fingerprint or state.linear.empty() != job.hdr.empty())
+    {
+      throw std::runtime_error("Error: Checkpoint does not match this render: " + plan.path);
+    }
+    // Cambiar de estrategia a mitad cambiaría los flujos aleatorios de las filas que faltan
+    if (header.strategy != job.strategy or header.ray_streams != job.cfg.get_ray_streams()) {
+      throw std::runtime_error(
+          "Error: Checkpoint was rendered with another parallel strategy: " + plan.path);
+    }
+    if (header.rows_done > 0) {
+      auto const channels = job.image.channel_rows(0, header.rows_done);
+      std::ranges::copy(state.r, channels[0].begin());
+      std::ranges::copy(state.g, channels[1].begin());
+      std::ranges::copy(state.b, channels[2].begin());
+      std::ranges::copy(state.linear, job.hdr.data().begin());
+    }
+    plan.rows_done = header.rows_done;
+    std::cout << "Reanudación: " << header.rows_done << " de " << header.height
+              << " filas restauradas.\n";
+    return plan;
   }
 
-  class RenderTask {
-    RenderJob * job;
-    int image_width;
-    int image_height;
-    int samples_per_pixel;
-    int max_depth;
-    double gamma;
-
-  public:
-    explicit RenderTask(RenderJob * j)
-      : job(j),
-        image_width(j->image.get_width()),
-        image_height(j->image.get_height()),
-        samples_per_pixel(j->cfg.get_samples_per_pixel()),
-        max_depth(j->cfg.get_max_depth()),
-        gamma(j->cfg.get_gamma()) {}
-
-    void operator()(tbb::blocked_range<int> const & r) const {
-      ThreadLocalRNGs const local_rngs{
-          &job->ray_rngs.local(),
-          &job->material_rngs.local()
-      };
-      
-      std::uniform_real_distribution<double> dist(-0.5, 0.5);
-
-      for (int j = r.begin(); j != r.end(); ++j) {
-        for (int i = 0; i < image_width; ++i) {
-          render::color accumulated{0.0, 0.0, 0.0};
-
-          for (int s = 0; s < samples_per_pixel; ++s) {
-            auto const u = (static_cast<double>(i) + 0.5 + dist(*local_rngs.ray)) / image_width;
-            auto const v = (static_cast<double>(j) + 0.5 + dist(*local_rngs.ray)) / image_height;
-
-            render::ray const ray_sample = job->cam.get_ray(u, v);
-            accumulated += ray_color(ray_sample, *job, max_depth, *local_rngs.material);
-          }
-
-          render::color const pixel_color = accumulated / static_cast<double>(samples_per_pixel);
-          job->image.set_pixel(i, j, pixel_color, gamma);
-        }
+  // Número de procesos de --workers
+  int parse_workers(std::string const & text) {
+    std::size_t used = 0;
+    int workers      = 0;
+    try {
+      workers = std::stoi(text, &used);
+    } catch (std::exception const &) {
+      used = 0;
+    }
+    if (used != text.size() or workers <= 0) {
+      throw std::invalid_argument("Error: Invalid number of workers: " + text);
+    }
+    return workers;
+  }
+
+  // Guarda en job.output_path las bandas de la parte, que el grafo ha dejado en job.image y
+  // job.hdr
+  void save_shard(render::RenderJob & job, render::shard_spec const spec,
+                  std::string const & config_path) {
+    render::shard_header const header{
+        .width         = job.image.get_width(),
+        .height        = job.image.get_height(),
+        .band_height   = job.cfg.get_tile_height(),
+        .part          = spec,
+        .fingerprint   = render::fingerprint_files(std::vector{config_path, job.scene_path}),
+        .output_format = job.cfg.get_output_format(),
+        .strategy      = job.strategy,
+        .ray_streams   = job.cfg.get_ray_streams()};
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    std::vector<float> linear;
+    auto const row_floats = 3 * static_cast<std::size_t>(header.width);
+    for (int row = 0; row < header.height; row += header.band_height) {
+      auto const band = static_cast<std::size_t>(row / header.band_height);
+      if (not render::shard_owns_band(spec, band)) {
+        continue;
       }
+      int const row_end   = std::min(header.height, row + header.band_height);
+      auto const channels = job.image.channel_rows(row, row_end);
+      r.insert(r.end(), channels[0].begin(), channels[0].end());
+      g.insert(g.end(), channels[1].begin(), channels[1].end());
+      b.insert(b.end(), channels[2].begin(), channels[2].end());
+      if (not job.hdr.empty()) {
+        auto const rows = job.hdr.data().subspan(static_cast<std::size_t>(row) * row_floats,
+                                                 static_cast<std::size_t>(row_end - row) *
+                                                     row_floats);
+        linear.insert(linear.end(), rows.begin(), rows.end());
+      }
+    }
+    render::write_shard_file(job.output_path, header, r, g, b, linear);
+  }
+
+  // Guarda la imagen lineal del trabajo, si la configuración la pide
+  void save_hdr(render::RenderJob const & job) {
+    if (job.hdr.empty()) {
+      return;
     }
-  };
+    std::string const hdr_path = render::hdr_path_for(job.output_path);
+    render::write_pfm(hdr_path, job.hdr);
+    std::cout << "Imagen lineal guardada como " << hdr_path << " ("
+              << job.cfg.get_samples_per_pixel() << " muestras/píxel)\n";
+  }
 
-  // Función auxiliar para configurar TBB
-  std::unique_ptr<tbb::global_control> setup_tbb(render::config const & cfg) {
-    int const n_threads = cfg.get_num_threads();
-    if (n_threads > 0) {
-      std::cout << "Configuración TBB: Limitando a " << n_threads << " hilos.\n";
-      return std::make_unique<tbb::global_control>(
-          tbb::global_control::max_allowed_parallelism,
-          static_cast<size_t>(n_threads)
-      );
+  void report_scene_cache(render::scene_cache_status const status, render::config const & cfg) {
+    if (status != render::scene_cache_status::off) {
+      std::cout << "Caché de escenas: " << render::to_string(status) << " en "
+                << cfg.get_scene_cache_dir() << "\n";
     }
-    std::cout << "Configuración TBB: Automático (todos los núcleos).\n";
-    return nullptr;
   }
 
-  void render_loop(RenderJob & job) {
-    auto global_limit = setup_tbb(job.cfg);
+  // Imágenes de un lote que se renderizan a la vez en lugar de una tras otra
+  constexpr std::size_t small_frame_pixels = 320 * 240;
+
+  // Los trabajos pequeños se renderizan juntos con los hilos y la afinidad de la configuración
+  // base, así que sólo pueden ir al grupo si no cambian ninguno de los dos
+  bool same_threading(render::config const & cfg, render::config const & base) {
+    return cfg.get_num_threads() == base.get_num_threads() and
+           cfg.get_thread_affinity() == base.get_thread_affinity();
+  }
 
-    int const width = job.image.get_width();
-    int const height = job.image.get_height();
+  // Renderiza todos los trabajos del fichero de lotes sobre una única copia de la escena. Las
+  // imágenes grandes, y las pequeñas que cambian num_threads o thread_affinity, se renderizan
+  // una tras otra; después, todas las demás pequeñas a la vez.
+  void run_batch(std::string const & config_path, std::string const & scene_path,
+                 std::string const & list_path) {
+    render::config base;
+    render::load_config(config_path, base);
+    auto const entries = render::read_batch_file(list_path);
+
+    // Las configuraciones se comprueban todas antes de empezar a renderizar
+    std::vector<render::config> configs;
+    std::set<std::string> outputs;
+    for (auto const & entry : entries) {
+      configs.push_back(base);
+      render::apply_config_text(entry.overrides, configs.back());
+      if (not outputs.insert(entry.output_path).second) {
+        throw std::invalid_argument("Error: Duplicate batch output: " + entry.output_path);
+      }
+    }
 
-    std::cout << "Renderizando escena (" << width << "x" << height 
-              << ") con TBB...\n";
+    auto parsed = std::make_shared<render::scene>();
+    report_scene_cache(render::load_scene_cached(scene_path, base.get_scene_cache_dir(), *parsed),
+                       base);
+    std::shared_ptr<render::scene const> const shared_scene = std::move(parsed);
+    std::cout << "Lote: " << entries.size() << " trabajos sobre " << scene_path << "\n";
+
+    std::vector<render::RenderJob> small;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      render::RenderJob job(configs[i], shared_scene, scene_path, entries[i].output_path);
+      if (static_cast<std::size_t>(job.image.get_width()) *
+                  static_cast<std::size_t>(job.image.get_height()) <=
+              small_frame_pixels and
+          same_threading(job.cfg, base))
+      {
+        small.push_back(std::move(job));
+        continue;
+      }
+      std::cout << "Trabajo " << i + 1 << " de " << entries.size() << ".\n";
+      render::render_frame(job, render::CheckpointPlan{}, render::shard_spec{});
+      std::cout << "Imagen guardada como " << job.output_path << "\n";
+      save_hdr(job);
+    }
 
-    RenderTask const task(&job);
-    
-    std::string const part_type = job.cfg.get_partitioner();
-    int const grain = job.cfg.get_grain_size();
-    tbb::blocked_range<int> const range(0, height, static_cast<size_t>(grain));
+    if (not small.empty()) {
+      render::render_frames(small, base);
+      for (auto const & job : small) {
+        std::cout << "Imagen guardada como " << job.output_path << "\n";
+        save_hdr(job);
+      }
+    }
+  }
 
-    if (part_type == "static") {
-      tbb::parallel_for(range, task, tbb::static_partitioner());
-    } else if (part_type == "simple") {
-      tbb::parallel_for(range, task, tbb::simple_partitioner());
-    } else {
-      tbb::parallel_for(range, task, tbb::auto_partitioner());
+  // Fotogramas pequeños de una secuencia que se renderizan a la vez
+  constexpr int frames_per_group = 16;
+
+  // Renderiza los frame_count fotogramas de la trayectoria de la cámara sobre una única copia de
+  // la escena. Todos tienen el mismo tamaño: si son pequeños se renderizan por grupos, varios a
+  // la vez; si no, uno tras otro, y la imagen lineal de cada fotograma se guarda mientras se
+  // renderiza el siguiente.
+  void run_sequence(std::string const & config_path, std::string const & scene_path,
+                    std::string const & output_pattern) {
+    render::config base;
+    render::load_config(config_path, base);
+    int const frames = base.get_frame_count();
+
+    auto parsed = std::make_shared<render::scene>();
+    report_scene_cache(render::load_scene_cached(scene_path, base.get_scene_cache_dir(), *parsed),
+                       base);
+    std::shared_ptr<render::scene const> const shared_scene = std::move(parsed);
+    std::cout << "Secuencia: " << frames << " fotogramas de " << scene_path << "\n";
+
+    auto make_job = [&](int const frame) {
+      return render::RenderJob(render::frame_config(base, frame), shared_scene, scene_path,
+                               render::frame_output_path(output_pattern, frame));
+    };
+    // Solo sirve para decidir el reparto, así que basta con un alto aproximado
+    auto const width         = static_cast<std::size_t>(base.get_image_width());
+    std::size_t const pixels = width * width * static_cast<std::size_t>(base.get_aspect_height()) /
+                               static_cast<std::size_t>(base.get_aspect_width());
+
+    if (pixels <= small_frame_pixels) {
+      for (int first = 0; first < frames; first += frames_per_group) {
+        std::vector<render::RenderJob> group;
+        for (int frame = first; frame < std::min(frames, first + frames_per_group); ++frame) {
+          group.push_back(make_job(frame));
+        }
+        render::render_frames(group, base);
+        for (auto const & job : group) {
+          std::cout << "Imagen guardada como " << job.output_path << "\n";
+          save_hdr(job);
+        }
+      }
+      return;
     }
 
-    std::cout << "Renderizado completado.\n";
+    // Como mucho hay un fotograma guardándose mientras se renderiza el siguiente
+    tbb::task_group saving;
+    std::shared_ptr<render::RenderJob> pending;
+    auto finish_pending = [&] {
+      saving.wait();
+      if (pending and not pending->hdr.empty()) {
+        std::cout << "Imagen lineal guardada como " << render::hdr_path_for(pending->output_path)
+                  << "\n";
+      }
+      pending.reset();
+    };
+    try {
+      for (int frame = 0; frame < frames; ++frame) {
+        std::cout << "Fotograma " << frame << " de " << frames << ".\n";
+        auto job = std::make_shared<render::RenderJob>(make_job(frame));
+        render::render_frame(*job, render::CheckpointPlan{}, render::shard_spec{});
+        std::cout << "Imagen guardada como " << job->output_path << "\n";
+        finish_pending();
+        if (not job->hdr.empty()) {
+          saving.run(
+              [job] { render::write_pfm(render::hdr_path_for(job->output_path), job->hdr); });
+        }
+        pending = std::move(job);
+      }
+    } catch (...) {
+      saving.wait();
+      throw;
+    }
+    finish_pending();
   }
 
 } // namespace
 
 int render::Application::run(gsl::span<char const * const> args) {
-  if (args.size() != 4) {
+  // render-par [--resume | --shard i/N | --workers N] <config> <escena> <salida>
+  // render-par --batch <config> <escena> <lista de trabajos>
+  // render-par --sequence <config> <escena> <salida con ###>
+  std::string_view const option = args.size() > 1 ? args[1] : "";
+  bool const resume             = option == "--resume";
+  bool const batch              = option == "--batch";
+  bool const sequence           = option == "--sequence";
+  bool const sharded            = option == "--shard";
+  bool const coordinated        = option == "--workers";
+  std::size_t const first =
+      (resume or batch or sequence) ? 2 : (sharded or coordinated) ? 3 : 1;
+  if (args.size() != first + 3) {
     std::cerr << "Error: Invalid number of arguments: " << args.size() - 1 << '\n';
     return EXIT_FAILURE;
   }
+  std::string const config_path = args[first];
 
   try {
-    RenderJob job(args[1], args[2], args[3]);
+    if (batch or sequence) {
+      auto const start_time = std::chrono::high_resolution_clock::now();
+      if (batch) {
+        run_batch(config_path, args[first + 1], args[first + 2]);
+      } else {
+        run_sequence(config_path, args[first + 1], args[first + 2]);
+      }
+      std::chrono::duration<double> const elapsed =
+          std::chrono::high_resolution_clock::now() - start_time;
+      std::cout << "Tiempo total: " << elapsed.count() << " segundos.\n";
+      return EXIT_SUCCESS;
+    }
+    if (coordinated) {
+      auto const start_time = std::chrono::high_resolution_clock::now();
+      render::render_with_workers(parse_workers(args[2]), config_path, args[first + 1],
+                                  args[first + 2]);
+      std::chrono::duration<double> const elapsed =
+          std::chrono::high_resolution_clock::now() - start_time;
+      std::cout << "Tiempo total: " << elapsed.count() << " segundos.\n";
+      std::cout << "Imagen guardada como " << args[first + 2] << "\n";
+      return EXIT_SUCCESS;
+    }
+
+    auto const shard = sharded ? render::parse_shard_spec(args[2]) : render::shard_spec{};
+    render::RenderJob job(config_path, args[first + 1], args[first + 2]);
+    report_scene_cache(job.scene_cache, job.cfg);
+    auto const plan = sharded ? render::CheckpointPlan{}
+                              : prepare_checkpoints(job, config_path, resume);
 
     auto const start_time = std::chrono::high_resolution_clock::now();
-    render_loop(job);
+    render::render_frame(job, plan, shard);
     auto const end_time = std::chrono::high_resolution_clock::now();
 
     std::chrono::duration<double> const elapsed = end_time - start_time;
     std::cout << "Tiempo total: " << elapsed.count() << " segundos.\n";
-
-    job.image.save_ppm(job.output_path);
+    if (sharded) {
+      save_shard(job, shard, config_path);
+      std::cout << "Parte guardada como " << job.output_path << "\n";
+      return EXIT_SUCCESS;
+    }
     std::cout << "Imagen guardada como " << job.output_path << "\n";
+    save_hdr(job);
+    // El render ha terminado: el punto de control ya no sirve
+    if (not plan.path.empty()) {
+      std::filesystem::remove(plan.path);
+    }
 
     return EXIT_SUCCESS;
   } catch (std::exception const & e) {
@@ -0,0 +1,81 @@
+// render-client: envía un trabajo a render-server y espera a que termine.
+//
+//   render-client <socket> <escena> <salida> [--config <fichero>] [--set "clave: valores"]...
+//   render-client <socket> --shutdown
+//
+// Escribe la respuesta del servidor, con los tiempos del trabajo, y termina con error si el
+// servidor no ha podido hacerlo.
+
+#include "render_server.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <gsl/span>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+  int usage() {
+    std::cerr << "Uso: render-client <socket> <escena> <salida> [--config <fichero>]"
+                 " [--set \"clave: valores\"]...\n"
+                 "     render-client <socket> --shutdown\n";
+    return EXIT_FAILURE;
+  }
+
+  // El servidor puede estar en otro directorio de trabajo
+  std::string absolute(std::string const & path) {
+    return std::filesystem::absolute(path).string();
+  }
+
+  int run(gsl::span<char const * const> args) {
+    if (args.size() < 3) {
+      return usage();
+    }
+    std::string const socket_path = args[1];
+    render::RenderRequest request;
+    if (std::string_view{args[2]} == "--shutdown") {
+      if (args.size() != 3) {
+        return usage();
+      }
+      request.shutdown = true;
+    } else {
+      if (args.size() < 4) {
+        return usage();
+      }
+      request.scene_path  = absolute(args[2]);
+      request.output_path = absolute(args[3]);
+      for (std::size_t i = 4; i < args.size(); i += 2) {
+        std::string_view const option = args[i];
+        if (i + 1 >= args.size()) {
+          return usage();
+        }
+        if (option == "--config") {
+          request.config_path = absolute(args[i + 1]);
+        } else if (option == "--set") {
+          request.overrides += args[i + 1];
+          request.overrides += '\n';
+        } else {
+          return usage();
+        }
+      }
+    }
+
+    auto const reply = render::submit_render_request(socket_path, request);
+    std::cout << reply << '\n';
+    return reply.starts_with("ok") ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  try {
+    return run({argv, static_cast<std::size_t>(argc)});
+  } catch (std::exception const & e) {
+    std::cerr << "Ha ocurrido una excepción: " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,310 @@
+#include "frame_pipeline.hpp"
+#include "checkpoint.hpp"
+#include "color.hpp"
+#include "image_io.hpp"
+#include "mapped_image.hpp"
+#include "numa_domains.hpp"
+#include "render_job.hpp"
+#include "sampling.hpp"
+#include "shard.hpp"
+#include "tile_scheduler.hpp"
+#include "tonemap.hpp"
+
+#include <oneapi/tbb/flow_graph.h>
+#include <oneapi/tbb/global_control.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // Banda de filas que recorre el grafo. sequence es su posición en el orden de escritura. En la
+  // salida en flujo lleva también sus propios canales de 8 bits, que se liberan al codificarla.
+  struct Band {
+    std::size_t index;
+    std::size_t sequence;
+    int row_begin;
+    int row_end;
+    std::vector<render::color> pixels;
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+  };
+
+  // Banda ya codificada en bytes de salida
+  struct EncodedBand {
+    std::size_t sequence;
+    int rows;
+    std::string bytes;
+  };
+
+  using band_ptr    = std::shared_ptr<Band>;
+  using encoded_ptr = std::shared_ptr<EncodedBand>;
+
+}  // namespace
+
+namespace render {
+
+  void run_frame_pipeline(RenderJob & job, NumaDomains const & numa,
+                          parallel_strategy const strategy, CheckpointPlan const & plan,
+                          shard_spec const & shard) {
+    namespace flow = tbb::flow;
+
+    int const width       = job.image.get_width();
+    int const height      = job.image.get_height();
+    int const band_height = job.cfg.get_tile_height();
+    auto const band_count =
+        static_cast<std::size_t>(height > 0 ? (height + band_height - 1) / band_height : 0);
+    // Las filas restauradas son siempre bandas completas, salvo que la imagen ya esté terminada
+    auto const first_band =
+        std::min(band_count, static_cast<std::size_t>(plan.rows_done / band_height));
+    // Bandas que se renderizan, en el orden en que se escriben
+    std::vector<std::size_t> bands;
+    for (std::size_t index = first_band; index < band_count; ++index) {
+      if (shard_owns_band(shard, index)) {
+        bands.push_back(index);
+      }
+    }
+    // Una parte de un render distribuido solo deja sus bandas en job.image y job.hdr
+    bool const whole_frame = shard.count == 1;
+
+    // Con mmap_output cada banda se cuantiza directamente en su sitio del fichero proyectado y
+    // no hace falta ordenar ni codificar. Solo P6 tiene un tamaño fijo por fila.
+    auto const format        = resolve_image_format(job.cfg.get_output_format(), job.output_path);
+    bool const mapped_output = job.cfg.get_mmap_output() == "on";
+    if (mapped_output and format != image_format::p6) {
+      throw std::runtime_error("Error: mmap_output requires P6 output: " + job.output_path);
+    }
+    std::optional<mapped_p6_file> mapped;
+    std::optional<image_stream_writer> writer;
+    if (not whole_frame) {
+      if (mapped_output or job.cfg.get_stream_window() > 0) {
+        throw std::runtime_error("Error: Shards require stream_window: 0 and mmap_output: off");
+      }
+    } else if (mapped_output) {
+      mapped.emplace(job.output_path, width, height);
+    } else {
+      writer.emplace(job.output_path, format, width, height);
+    }
+
+    // Las bandas restauradas se escriben tal cual, banda a banda como en un render completo
+    for (std::size_t index = 0; writer and index < first_band; ++index) {
+      int const row_begin = static_cast<int>(index) * band_height;
+      int const row_end   = std::min(height, row_begin + band_height);
+      std::string bytes;
+      job.image.append_rows(format, row_begin, row_end, bytes);
+      writer->write_encoded(row_end - row_begin, bytes);
+    }
+
+    // El punto de control recoge las filas ya escritas, que nadie vuelve a modificar. Se guarda
+    // desde el nodo de escritura, en serie, sin detener el render de las bandas siguientes.
+    bool const checkpoints = writer and not plan.path.empty() and plan.interval > 0.0;
+    auto last_checkpoint   = std::chrono::steady_clock::now();
+    auto save_checkpoint   = [&] {
+      int const rows      = writer->get_rows_written();
+      auto const channels = job.image.channel_rows(0, rows);
+      auto const linear   = job.hdr.empty() ? std::span<float const>{}
+                                            : job.hdr.data().first(3 * channels[0].size());
+      write_checkpoint(plan.path,
+                       checkpoint_header{.width       = width,
+                                         .height      = height,
+                                         .band_height = band_height,
+                                         .rows_done   = rows,
+                                         .fingerprint = plan.fingerprint,
+                                         .strategy    = strategy,
+                                         .ray_streams = job.cfg.get_ray_streams()},
+                       channels[0], channels[1], channels[2], linear);
+    };
+
+    // Limita las bandas en vuelo para acotar la memoria de los búferes intermedios. En la salida
+    // en flujo el límite lo fija stream_window y es lo único que se guarda de la imagen.
+    auto const threads = tbb::global_control::active_value(
+        tbb::global_control::max_allowed_parallelism);
+    bool const streaming            = job.cfg.get_stream_window() > 0;
+    std::size_t const max_in_flight = streaming
+                                          ? static_cast<std::size_t>(job.cfg.get_stream_window())
+                                          : std::max<std::size_t>(4, 4 * threads);
+
+    tonemapper const tonemap{job.cfg.get_gamma()};
+
+    // Con el planificador propio el render ya ocupa threads hilos fuera de TBB. Cada nodo
+    // posterior se limita entonces a una banda a la vez, para no sumar otros tantos hilos de
+    // TBB; tonemap y codificación cuestan muy poco frente al render de una banda.
+    bool const own_scheduler = job.cfg.get_scheduler() == "worksteal";
+    std::size_t const downstream =
+        own_scheduler ? std::size_t{1} : static_cast<std::size_t>(flow::unlimited);
+
+    flow::graph g;
+
+    auto make_band = [&](std::size_t const sequence) {
+      auto band       = std::make_shared<Band>();
+      band->index     = bands[sequence];
+      band->sequence  = sequence;
+      band->row_begin = static_cast<int>(band->index) * band_height;
+      band->row_end   = std::min(height, band->row_begin + band_height);
+      return band;
+    };
+
+    flow::function_node<band_ptr, band_ptr> tonemap_node(
+        g, downstream, [&](band_ptr band) {
+      numa.execute_for_row(band->row_begin, [&] {
+        if (streaming) {
+          band->r.resize(band->pixels.size());
+          band->g.resize(band->pixels.size());
+          band->b.resize(band->pixels.size());
+          tonemap.map(band->pixels, band->r, band->g, band->b);
+        } else {
+          job.image.set_rows(band->row_begin, band->row_end, band->pixels, tonemap);
+        }
+        if (not job.hdr.empty()) {
+          job.hdr.set_rows(band->row_begin, band->pixels);
+        }
+      });
+      band->pixels = {};
+      return band;
+    });
+
+    flow::function_node<band_ptr, encoded_ptr> encode_node(
+        g, downstream, [&](band_ptr const & band) {
+      auto encoded      = std::make_shared<EncodedBand>();
+      encoded->sequence = band->sequence;
+      encoded->rows     = band->row_end - band->row_begin;
+      if (streaming) {
+        append_encoded_pixels(format, band->r, band->g, band->b, encoded->bytes);
+      } else {
+        job.image.append_rows(format, band->row_begin, band->row_end, encoded->bytes);
+      }
+      return encoded;
+    });
+
+    flow::function_node<band_ptr, flow::continue_msg> mapped_node(
+        g, downstream, [&](band_ptr const & band) {
+      numa.execute_for_row(band->row_begin, [&] {
+        tonemap.map_interleaved(band->pixels, mapped->rows(band->row_begin, band->row_end));
+        if (not job.hdr.empty()) {
+          job.hdr.set_rows(band->row_begin, band->pixels);
+        }
+      });
+      band->pixels = {};
+      mapped->flush_rows(band->row_begin, band->row_end);
+      return flow::continue_msg{};
+    });
+
+    flow::sequencer_node<encoded_ptr> order(g, [](encoded_ptr const & encoded) {
+      return encoded->sequence;
+    });
+
+    flow::function_node<encoded_ptr, flow::continue_msg> write_node(
+        g, flow::serial, [&](encoded_ptr const & encoded) {
+      writer->write_encoded(encoded->rows, encoded->bytes);
+      auto const now = std::chrono::steady_clock::now();
+      if (checkpoints and writer->get_rows_written() < height and
+          std::chrono::duration<double>(now - last_checkpoint).count() >= plan.interval)
+      {
+        save_checkpoint();
+        last_checkpoint = now;
+      }
+      return flow::continue_msg{};
+    });
+
+    // Las bandas de una parte ya están en job.image al salir de tonemap_node
+    flow::function_node<band_ptr, flow::continue_msg> stored_node(
+        g, downstream, [](band_ptr const &) { return flow::continue_msg{}; });
+
+    if (whole_frame) {
+      flow::make_edge(tonemap_node, encode_node);
+      flow::make_edge(encode_node, order);
+      flow::make_edge(order, write_node);
+    } else {
+      flow::make_edge(tonemap_node, stored_node);
+    }
+
+    // Nodo al que llegan las bandas ya renderizadas
+    flow::receiver<band_ptr> & rendered =
+        mapped_output ? static_cast<flow::receiver<band_ptr> &>(mapped_node) : tonemap_node;
+
+    if (own_scheduler) {
+      // Las bandas se renderizan con el planificador propio y entran al grafo ya calculadas. Las
+      // dos ejecuciones (estimación de costes y render) usan los mismos hilos.
+      tile_scheduler scheduler(std::max(1, static_cast<int>(threads)));
+      try {
+        std::vector<double> costs(bands.size());
+        std::vector<double> const uniform(costs.size(), 1.0);
+        scheduler.run(uniform, [&](std::size_t const index, int) {
+          auto const band = make_band(index);
+          costs[index]    = estimate_band_cost(job, *job.scene_data, band->row_begin,
+                                               band->row_end);
+        });
+
+        auto const stats = scheduler.run(costs, [&](std::size_t const index, int) {
+          auto band = make_band(index);
+          band->pixels.resize(static_cast<std::size_t>(band->row_end - band->row_begin) *
+                              static_cast<std::size_t>(width));
+          render_band_inline(job, *job.scene_data, strategy, band->row_begin, band->row_end,
+                             std::span<color>{band->pixels});
+          rendered.try_put(band);
+        });
+
+        std::cout << "Planificador propio: " << costs.size() << " bandas en "
+                  << scheduler.get_num_workers() << " hilos, " << stats.steals
+                  << " robos, desequilibrio " << stats.imbalance() * 100.0 << " %.\n";
+      } catch (...) {
+        g.wait_for_all();
+        throw;
+      }
+      g.wait_for_all();
+    } else {
+      std::size_t next_band = 0;
+      flow::input_node<band_ptr> source(g, [&](tbb::flow_control & fc) -> band_ptr {
+        if (next_band >= bands.size()) {
+          fc.stop();
+          return nullptr;
+        }
+        return make_band(next_band++);
+      });
+
+      flow::limiter_node<band_ptr> limiter(g, max_in_flight);
+
+      flow::function_node<band_ptr, band_ptr> render_node(
+          g, flow::unlimited, [&](band_ptr band) {
+        band->pixels.resize(static_cast<std::size_t>(band->row_end - band->row_begin) *
+                            static_cast<std::size_t>(width));
+        numa.execute_for_row(band->row_begin, [&] {
+          render_band(job, numa.scene_for(job, band->row_begin), strategy, band->row_begin,
+                      band->row_end, std::span<color>{band->pixels});
+        });
+        return band;
+      });
+
+      flow::make_edge(source, limiter);
+      flow::make_edge(limiter, render_node);
+      flow::make_edge(render_node, rendered);
+      if (mapped) {
+        flow::make_edge(mapped_node, limiter.decrementer());
+      } else if (writer) {
+        flow::make_edge(write_node, limiter.decrementer());
+      } else {
+        flow::make_edge(stored_node, limiter.decrementer());
+      }
+
+      source.activate();
+      g.wait_for_all();
+    }
+
+    if (mapped) {
+      mapped->finish();
+    } else if (writer) {
+      writer->finish();
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,125 @@
+#include "numa_domains.hpp"
+#include "compiled_scene_cache.hpp"
+#include "render_job.hpp"
+#include "scene.hpp"
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/info.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+  // Ejecuta fn en los hilos de cada arena y espera a que terminen todas
+  template <typename Fn>
+  void run_on_domains(std::vector<render::NumaDomain> & domains, Fn const & fn) {
+    std::vector<std::future<void>> pending;
+    pending.reserve(domains.size());
+    for (auto & domain : domains) {
+      auto done = std::make_shared<std::promise<void>>();
+      pending.push_back(done->get_future());
+      domain.arena->enqueue([&domain, &fn, done] {
+        try {
+          fn(domain);
+          done->set_value();
+        } catch (...) {
+          done->set_exception(std::current_exception());
+        }
+      });
+    }
+    for (auto & result : pending) {
+      result.get();
+    }
+  }
+
+  // Crea una arena por nodo y reparte las filas en proporción a sus núcleos
+  std::vector<render::NumaDomain> make_domains(std::vector<tbb::numa_node_id> const & nodes,
+                                               int height) {
+    std::vector<int> weights;
+    weights.reserve(nodes.size());
+    for (auto const node : nodes) {
+      weights.push_back(std::max(1, tbb::info::default_concurrency(node)));
+    }
+    long const total_weight = std::accumulate(weights.begin(), weights.end(), 0L);
+
+    std::vector<render::NumaDomain> domains;
+    domains.reserve(nodes.size());
+    long accumulated = 0;
+    int row          = 0;
+    for (std::size_t n = 0; n < nodes.size(); ++n) {
+      accumulated += weights[n];
+      int const row_end = static_cast<int>(accumulated * height / total_weight);
+      domains.push_back(render::NumaDomain{
+          nodes[n],
+          std::make_unique<tbb::task_arena>(tbb::task_arena::constraints{}
+                                                .set_numa_id(nodes[n])
+                                                .set_max_concurrency(weights[n]),
+                                            0),
+          row, row_end, nullptr});
+      row = row_end;
+    }
+    return domains;
+  }
+
+}  // namespace
+
+namespace render {
+
+  NumaDomains NumaDomains::prepare(RenderJob & job) {
+    NumaDomains result;
+    if (job.cfg.get_numa() != "on") {
+      return result;
+    }
+
+    auto const nodes = tbb::info::numa_nodes();
+    if (nodes.size() <= 1) {
+      std::cout << "NUMA: un único nodo disponible, se usa la arena global.\n";
+      return result;
+    }
+
+    result.domains_      = make_domains(nodes, job.image.get_height());
+    bool const replicate = job.cfg.get_numa_scene() == "replicated";
+
+    run_on_domains(result.domains_, [&](NumaDomain & domain) {
+      tbb::parallel_for(tbb::blocked_range<int>(domain.row_begin, domain.row_end),
+                        [&](tbb::blocked_range<int> const & r) {
+        job.image.first_touch_rows(r.begin(), r.end());
+      });
+      if (replicate) {
+        domain.scene_copy = std::make_unique<scene>();
+        load_scene_cached(job.scene_path, job.cfg.get_scene_cache_dir(), *domain.scene_copy);
+      }
+    });
+
+    for (auto const & domain : result.domains_) {
+      std::cout << "NUMA: nodo " << domain.node << " -> filas [" << domain.row_begin << ", "
+                << domain.row_end << ")" << (replicate ? " con escena replicada" : "") << "\n";
+    }
+    return result;
+  }
+
+  NumaDomain const * NumaDomains::find(int const row) const {
+    auto const it = std::ranges::find_if(domains_, [row](NumaDomain const & domain) {
+      return row >= domain.row_begin and row < domain.row_end;
+    });
+    return it == domains_.end() ? nullptr : &*it;
+  }
+
+  scene const & NumaDomains::scene_for(RenderJob const & job, int const row) const {
+    NumaDomain const * domain = find(row);
+    if (domain == nullptr or domain->scene_copy == nullptr) {
+      return *job.scene_data;
+    }
+    return *domain->scene_copy;
+  }
+
+}  // namespace render
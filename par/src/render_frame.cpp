@@ -0,0 +1,118 @@
+#include "render_frame.hpp"
+#include "config.hpp"
+#include "frame_pipeline.hpp"
+#include "numa_domains.hpp"
+#include "render_job.hpp"
+#include "sampling.hpp"
+#include "shard.hpp"
+#include "thread_pinning.hpp"
+
+#include <oneapi/tbb/global_control.h>
+#include <oneapi/tbb/parallel_for_each.h>
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <span>
+
+namespace {
+
+  // Función auxiliar para configurar TBB
+  std::unique_ptr<tbb::global_control> setup_tbb(render::config const & cfg) {
+    int const n_threads = cfg.get_num_threads();
+    if (n_threads > 0) {
+      std::cout << "Configuración TBB: Limitando a " << n_threads << " hilos.\n";
+      return std::make_unique<tbb::global_control>(
+          tbb::global_control::max_allowed_parallelism,
+          static_cast<size_t>(n_threads)
+      );
+    }
+    std::cout << "Configuración TBB: Automático (todos los núcleos).\n";
+    return nullptr;
+  }
+
+  // Fija los hilos TBB a CPU concretas. Con thread_affinity: cores y sin num_threads explícito
+  // se lanza un hilo por núcleo físico.
+  std::unique_ptr<render::ThreadPinning>
+      setup_affinity(render::config const & cfg, std::unique_ptr<tbb::global_control> & limit) {
+    auto pinning = render::ThreadPinning::create(cfg);
+    if (pinning and cfg.get_thread_affinity() == "cores" and cfg.get_num_threads() <= 0) {
+      limit = std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism,
+                                                    pinning->cpu_count());
+    }
+    if (pinning and cfg.get_scheduler() == "worksteal") {
+      std::cout << "Afinidad: sólo se aplica a los hilos TBB, no al planificador propio.\n";
+    }
+    return pinning;
+  }
+
+}  // namespace
+
+namespace render {
+
+  void render_frame(RenderJob & job, CheckpointPlan const & plan, shard_spec const & shard) {
+    auto global_limit = setup_tbb(job.cfg);
+    auto const pinning = setup_affinity(job.cfg, global_limit);
+
+    int const width = job.image.get_width();
+    int const height = job.image.get_height();
+
+    auto const strategy = job.strategy;
+
+    std::cout << "Renderizando escena (" << width << "x" << height 
+              << ") con TBB...\n";
+
+    if (strategy == parallel_strategy::samples) {
+      std::cout << "Estrategia: reparto por muestras ("
+                << sample_chunk_count(job.cfg.get_samples_per_pixel())
+                << " fragmentos/píxel).\n";
+    } else {
+      std::cout << "Estrategia: reparto por filas.\n";
+    }
+    if (job.cfg.get_ray_streams() == 2) {
+      std::cout << "Flujos de rayos: 2 caminos intercalados por hilo.\n";
+    }
+
+    // El planificador propio no usa arenas TBB, así que no puede repartir por nodos NUMA
+    if (job.cfg.get_scheduler() == "worksteal" and job.cfg.get_numa() == "on") {
+      std::cout << "NUMA: no se aplica con el planificador propio.\n";
+      job.cfg.set_numa("off");
+    }
+    // La salida en flujo escribe las bandas en orden de filas, y el planificador propio las
+    // termina en orden de coste: el búfer de reordenación ya no estaría acotado por la ventana
+    if (job.cfg.get_stream_window() > 0) {
+      if (job.cfg.get_scheduler() == "worksteal") {
+        std::cout << "Salida en flujo: se usa el planificador de TBB.\n";
+        job.cfg.set_scheduler("tbb");
+      }
+      std::cout << "Salida en flujo: ventana de " << job.cfg.get_stream_window() << " bandas de "
+                << job.cfg.get_tile_height() << " filas.\n";
+    }
+    if (job.cfg.get_mmap_output() == "on") {
+      std::cout << "Salida proyectada en memoria: cada banda se escribe en su sitio del fichero.\n";
+    }
+    auto const numa = NumaDomains::prepare(job);
+    if (shard.count > 1) {
+      std::cout << "Parte " << shard.index << " de " << shard.count << ".\n";
+    }
+    run_frame_pipeline(job, numa, strategy, plan, shard);
+
+    std::cout << "Renderizado completado.\n";
+  }
+
+  void render_frames(std::span<RenderJob> const jobs, config const & cfg) {
+    auto global_limit  = setup_tbb(cfg);
+    auto const pinning = setup_affinity(cfg, global_limit);
+
+    std::cout << "Renderizando " << jobs.size() << " escenas pequeñas a la vez con TBB...\n";
+
+    tbb::parallel_for_each(jobs.begin(), jobs.end(), [&](RenderJob & job) {
+      job.cfg.set_scheduler("tbb");
+      job.cfg.set_numa("off");
+      run_frame_pipeline(job, NumaDomains{}, job.strategy, CheckpointPlan{}, shard_spec{});
+    });
+
+    std::cout << "Renderizado completado.\n";
+  }
+
+}  // namespace render
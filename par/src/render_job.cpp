@@ -0,0 +1,399 @@
+#include "render_job.hpp"
+#include "camera.hpp"
+#include "color.hpp"
+#include "compiled_scene_cache.hpp"
+#include "config.hpp"
+#include "hdr_image.hpp"
+#include "image_soa_par.hpp"
+#include "object.hpp"
+#include "ray.hpp"
+#include "sampling.hpp"
+#include "scene.hpp"
+#include "vector.hpp"
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/partitioner.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  // Color del fondo en la dirección del rayo
+  render::color background(render::ray const & r, render::RenderJob const & job) {
+    render::vector const unit_direction = r.get_direction().normalized();
+    auto const t = 0.5 * (unit_direction.y + 1.0);
+    return render::color{(1.0 - t) * job.cfg.get_background_light_color() +
+                         t * job.cfg.get_background_dark_color()};
+  }
+
+  // Calcula color de un rayo recursivamente
+  render::color ray_color(render::ray const & r, render::RenderJob const & job,
+                          render::scene const & scene, int depth, std::mt19937_64 & mat_rng) {
+    if (depth <= 0) {
+      return render::color{0.0, 0.0, 0.0};
+    }
+
+    render::hit_record rec;
+    constexpr double min_t = 1e-3;
+
+    if (scene.hit(r, min_t, std::numeric_limits<double>::infinity(), rec)) {
+      render::ray scattered;
+      if (rec.mat_ptr != nullptr) {
+        auto const result = rec.mat_ptr->scatter(r, rec, scattered, mat_rng);
+        if (result.scattered) {
+          return render::color{result.attenuation} *
+                 ray_color(scattered, job, scene, depth - 1, mat_rng);
+        }
+      }
+      return render::color{0.0, 0.0, 0.0};
+    }
+
+    return background(r, job);
+  }
+
+  // Camino que se traza rebote a rebote para poder intercalar dos en el mismo hilo
+  struct PathState {
+    render::ray r;
+    render::color throughput{1.0, 1.0, 1.0};
+    int depth;
+    bool done{false};
+  };
+
+  // Avanza un rebote del camino. Al terminar suma su contribución a accumulated. Multiplica la
+  // atenuación de delante hacia atrás, así que el redondeo difiere del de ray_color.
+  void step_path(PathState & path, render::RenderJob const & job, render::scene const & scene,
+                 std::mt19937_64 & mat_rng, render::color & accumulated) {
+    if (path.depth <= 0) {
+      path.done = true;
+      return;
+    }
+
+    render::hit_record rec;
+    constexpr double min_t = 1e-3;
+
+    if (not scene.hit(path.r, min_t, std::numeric_limits<double>::infinity(), rec)) {
+      accumulated += path.throughput * background(path.r, job);
+      path.done    = true;
+      return;
+    }
+
+    render::ray scattered;
+    if (rec.mat_ptr != nullptr) {
+      auto const result = rec.mat_ptr->scatter(path.r, rec, scattered, mat_rng);
+      if (result.scattered) {
+        path.throughput *= render::color{result.attenuation};
+        path.r           = scattered;
+        --path.depth;
+        return;
+      }
+    }
+    path.done = true;
+  }
+
+  // Parámetros de muestreo compartidos por las dos estrategias
+  struct SampleParams {
+    int image_width;
+    int image_height;
+    int samples_per_pixel;
+    int max_depth;
+    int ray_streams;
+  };
+
+  // Acumula las muestras [first, last) del píxel (i, j) con los flujos dados
+  render::color accumulate_samples(render::RenderJob const & job, render::scene const & scene,
+                                   SampleParams const & params, int i, int j, int first, int last,
+                                   std::mt19937_64 & ray_rng, std::mt19937_64 & mat_rng) {
+    std::uniform_real_distribution<double> dist(-0.5, 0.5);
+    render::color accumulated{0.0, 0.0, 0.0};
+
+    auto camera_ray = [&] {
+      auto const u = (static_cast<double>(i) + 0.5 + dist(ray_rng)) / params.image_width;
+      auto const v = (static_cast<double>(j) + 0.5 + dist(ray_rng)) / params.image_height;
+      return job.cam.get_ray(u, v);
+    };
+
+    int s = first;
+    if (params.ray_streams == 2) {
+      // Dos caminos independientes avanzan a la vez para que sus accesos a la escena se
+      // solapen. Comparten el flujo de materiales en otro orden: el resultado es
+      // estadísticamente equivalente, no idéntico bit a bit.
+      for (; s + 1 < last; s += 2) {
+        PathState first_path{camera_ray(), {1.0, 1.0, 1.0}, params.max_depth};
+        PathState second_path{camera_ray(), {1.0, 1.0, 1.0}, params.max_depth};
+        while (not first_path.done or not second_path.done) {
+          if (not first_path.done) {
+            step_path(first_path, job, scene, mat_rng, accumulated);
+          }
+          if (not second_path.done) {
+            step_path(second_path, job, scene, mat_rng, accumulated);
+          }
+        }
+      }
+    }
+
+    for (; s < last; ++s) {
+      render::ray const ray_sample = camera_ray();
+      accumulated += ray_color(ray_sample, job, scene, params.max_depth, mat_rng);
+    }
+    return accumulated;
+  }
+
+  // Estrategia por filas: cada tarea recorre filas completas con un flujo por fila
+  class RenderTask {
+    render::RenderJob const * job;
+    render::scene const * scene;
+    SampleParams params;
+    int first_row;
+    std::span<render::color> out;
+
+  public:
+    RenderTask(render::RenderJob const * j, render::scene const * scn, SampleParams const & p,
+               int row_offset, std::span<render::color> band)
+      : job(j), scene(scn), params(p), first_row(row_offset), out(band) {}
+
+    void operator()(tbb::blocked_range<int> const & r) const {
+      auto const width = static_cast<std::size_t>(params.image_width);
+
+      for (int j = r.begin(); j != r.end(); ++j) {
+        auto ray_rng = job->ray_stream(static_cast<std::uint64_t>(j));
+        auto mat_rng = job->material_stream(static_cast<std::uint64_t>(j));
+        std::size_t const row = static_cast<std::size_t>(j - first_row) * width;
+
+        for (int i = 0; i < params.image_width; ++i) {
+          render::color const accumulated = accumulate_samples(
+              *job, *scene, params, i, j, 0, params.samples_per_pixel, ray_rng, mat_rng);
+
+          out[row + static_cast<std::size_t>(i)] =
+              accumulated / static_cast<double>(params.samples_per_pixel);
+        }
+      }
+    }
+  };
+
+  // Estrategia por muestras: cada tarea calcula sumas parciales de (píxel, fragmento). Las
+  // sumas se guardan en una posición fija y se reducen después en orden de fragmento.
+  class SampleChunkTask {
+    render::RenderJob const * job;
+    render::scene const * scene;
+    SampleParams params;
+    int chunks;
+    std::size_t first_pixel;
+    std::vector<render::color> * partials;
+
+  public:
+    SampleChunkTask(render::RenderJob const * j, render::scene const * scn, SampleParams const & p,
+                    int chunk_count, std::size_t pixel_offset,
+                    std::vector<render::color> * partial_sums)
+      : job(j), scene(scn), params(p), chunks(chunk_count), first_pixel(pixel_offset),
+        partials(partial_sums) {}
+
+    void operator()(tbb::blocked_range<std::size_t> const & r) const {
+      auto const chunk_count = static_cast<std::size_t>(chunks);
+      auto const width       = static_cast<std::size_t>(params.image_width);
+
+      for (std::size_t idx = r.begin(); idx != r.end(); ++idx) {
+        std::size_t const pixel = first_pixel + idx / chunk_count;
+        std::size_t const chunk = idx % chunk_count;
+        int const i             = static_cast<int>(pixel % width);
+        int const j             = static_cast<int>(pixel / width);
+
+        int const first = static_cast<int>(chunk) * render::samples_per_chunk;
+        int const last  = std::min(first + render::samples_per_chunk, params.samples_per_pixel);
+
+        auto ray_rng = job->ray_stream(pixel, chunk);
+        auto mat_rng = job->material_stream(pixel, chunk);
+        (*partials)[idx] =
+            accumulate_samples(*job, *scene, params, i, j, first, last, ray_rng, mat_rng);
+      }
+    }
+  };
+
+  // Ejecuta parallel_for con el particionador elegido en la configuración
+  template <typename Range, typename Body>
+  void run_partitioned(Range const & range, Body const & body, std::string const & part_type) {
+    if (part_type == "static") {
+      tbb::parallel_for(range, body, tbb::static_partitioner());
+    } else if (part_type == "simple") {
+      tbb::parallel_for(range, body, tbb::simple_partitioner());
+    } else {
+      tbb::parallel_for(range, body, tbb::auto_partitioner());
+    }
+  }
+
+  // Ejecuta el cuerpo en el hilo que llama o repartido con parallel_for
+  template <typename Range, typename Body>
+  void run_range(Range const & range, Body const & body, render::RenderJob const & job,
+                 bool const inline_exec) {
+    if (inline_exec) {
+      body(range);
+      return;
+    }
+    run_partitioned(range, body, job.cfg.get_partitioner());
+  }
+
+  // Sigue un camino hasta que escapa o agota la profundidad y devuelve los impactos recorridos
+  int count_bounces(render::ray r, render::scene const & scene, int depth,
+                    std::mt19937_64 & mat_rng) {
+    constexpr double min_t = 1e-3;
+    int bounces            = 0;
+    for (; depth > 0; --depth) {
+      render::hit_record rec;
+      if (not scene.hit(r, min_t, std::numeric_limits<double>::infinity(), rec)) {
+        break;
+      }
+      ++bounces;
+      render::ray scattered;
+      if (rec.mat_ptr == nullptr or
+          not rec.mat_ptr->scatter(r, rec, scattered, mat_rng).scattered)
+      {
+        break;
+      }
+      r = scattered;
+    }
+    return bounces;
+  }
+
+  SampleParams sample_params(render::RenderJob const & job) {
+    return SampleParams{job.image.get_width(), job.image.get_height(),
+                        job.cfg.get_samples_per_pixel(), job.cfg.get_max_depth(),
+                        job.cfg.get_ray_streams()};
+  }
+
+  void render_rows(render::RenderJob const & job, render::scene const & scene, int row_begin,
+                   int row_end, std::span<render::color> out, bool inline_exec) {
+    RenderTask const task(&job, &scene, sample_params(job), row_begin, out);
+    int const grain = job.cfg.get_grain_size();
+    tbb::blocked_range<int> const range(row_begin, row_end, static_cast<size_t>(grain));
+    run_range(range, task, job, inline_exec);
+  }
+
+  void render_samples(render::RenderJob const & job, render::scene const & scene, int row_begin,
+                      int row_end, std::span<render::color> out, bool inline_exec) {
+    SampleParams const params = sample_params(job);
+    int const chunks          = render::sample_chunk_count(params.samples_per_pixel);
+    auto const chunk_count    = static_cast<std::size_t>(chunks);
+    auto const width          = static_cast<std::size_t>(params.image_width);
+    std::size_t const first   = static_cast<std::size_t>(row_begin) * width;
+    std::size_t const pixels  = static_cast<std::size_t>(row_end - row_begin) * width;
+
+    std::vector<render::color> partials(pixels * chunk_count);
+    SampleChunkTask const task(&job, &scene, params, chunks, first, &partials);
+    tbb::blocked_range<std::size_t> const range(0, partials.size(),
+                                                static_cast<size_t>(job.cfg.get_grain_size()));
+    run_range(range, task, job, inline_exec);
+
+    // Reducción en orden fijo de fragmento: el resultado no depende del planificador
+    auto const reduce = [&](tbb::blocked_range<std::size_t> const & r) {
+      for (std::size_t local = r.begin(); local != r.end(); ++local) {
+        render::color sum{0.0, 0.0, 0.0};
+        for (std::size_t c = 0; c < chunk_count; ++c) {
+          sum += partials[local * chunk_count + c];
+        }
+        out[local] = sum / static_cast<double>(params.samples_per_pixel);
+      }
+    };
+    tbb::blocked_range<std::size_t> const pixel_range(0, pixels);
+    if (inline_exec) {
+      reduce(pixel_range);
+    } else {
+      tbb::parallel_for(pixel_range, reduce);
+    }
+  }
+
+  // La configuración se carga antes que la escena, así que sus errores se comunican primero
+  render::config read_config(std::string const & path) {
+    render::config cfg;
+    render::load_config(path, cfg);
+    return cfg;
+  }
+
+}  // namespace
+
+namespace render {
+
+  RenderJob::RenderJob(std::string const & config_path, std::string const & scene_path_p,
+                       std::string output_path_p)
+      : RenderJob(read_config(config_path), nullptr, scene_path_p, std::move(output_path_p)) {
+    auto parsed = std::make_shared<scene>();
+    scene_cache = load_scene_cached(scene_path, cfg.get_scene_cache_dir(), *parsed);
+    scene_data  = std::move(parsed);
+  }
+
+  RenderJob::RenderJob(config cfg_p, std::shared_ptr<scene const> scene_p,
+                       std::string scene_path_p, std::string output_path_p)
+      : cfg{std::move(cfg_p)}, scene_data{std::move(scene_p)}, cam{cfg}, image{0, 0},
+        scene_path{std::move(scene_path_p)}, output_path{std::move(output_path_p)} {
+    int const image_width = cfg.get_image_width();
+    auto const aspect_ratio =
+        static_cast<double>(cfg.get_aspect_width()) / cfg.get_aspect_height();
+    int const image_height = static_cast<int>(image_width / aspect_ratio);
+
+    // La salida en flujo y la proyectada en memoria no necesitan la imagen completa
+    bool const whole_image = cfg.get_stream_window() == 0 and cfg.get_mmap_output() == "off";
+    cam                    = camera{cfg};
+    image                  = ImageSOA{image_width, image_height, whole_image};
+    if (cfg.get_framebuffer() == "hdr") {
+      hdr = hdr_image{image_width, image_height};
+    }
+    strategy = choose_parallel_strategy(cfg.get_parallel_strategy(), image_height,
+                                        cfg.get_samples_per_pixel());
+  }
+
+  void render_band(RenderJob const & job, scene const & scn, parallel_strategy const strategy,
+                   int const row_begin, int const row_end, std::span<color> out) {
+    if (strategy == parallel_strategy::samples) {
+      render_samples(job, scn, row_begin, row_end, out, false);
+    } else {
+      render_rows(job, scn, row_begin, row_end, out, false);
+    }
+  }
+
+  void render_band_inline(RenderJob const & job, scene const & scn,
+                          parallel_strategy const strategy, int const row_begin,
+                          int const row_end, std::span<color> out) {
+    if (strategy == parallel_strategy::samples) {
+      render_samples(job, scn, row_begin, row_end, out, true);
+    } else {
+      render_rows(job, scn, row_begin, row_end, out, true);
+    }
+  }
+
+  double estimate_band_cost(RenderJob const & job, scene const & scn, int const row_begin,
+                            int const row_end) {
+    SampleParams const params = sample_params(job);
+    std::uniform_real_distribution<double> dist(-0.5, 0.5);
+    std::uint64_t bounces = 0;
+    std::uint64_t probes  = 0;
+
+    for (int j = row_begin; j < row_end; j += probe_stride) {
+      auto ray_rng = job.ray_stream(static_cast<std::uint64_t>(j), probe_stream);
+      auto mat_rng = job.material_stream(static_cast<std::uint64_t>(j), probe_stream);
+      for (int i = 0; i < params.image_width; i += probe_stride) {
+        auto const u = (static_cast<double>(i) + 0.5 + dist(ray_rng)) / params.image_width;
+        auto const v = (static_cast<double>(j) + 0.5 + dist(ray_rng)) / params.image_height;
+        bounces += static_cast<std::uint64_t>(
+            count_bounces(job.cam.get_ray(u, v), scn, params.max_depth, mat_rng));
+        ++probes;
+      }
+    }
+
+    // Cada píxel cuesta al menos el rayo primario; se escala a los píxeles reales de la banda
+    if (probes == 0) {
+      return 0.0;
+    }
+    double const pixels = static_cast<double>(row_end - row_begin) * params.image_width;
+    return static_cast<double>(probes + bounces) / static_cast<double>(probes) * pixels *
+           params.samples_per_pixel;
+  }
+
+}  // namespace render
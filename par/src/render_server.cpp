@@ -0,0 +1,281 @@
+#include "render_server.hpp"
+#include "config.hpp"
+#include "frame_pipeline.hpp"
+#include "hdr_image.hpp"
+#include "render_frame.hpp"
+#include "render_job.hpp"
+#include "scene_cache.hpp"
+#include "shard.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+  [[noreturn]] void fail(std::string const & what, int const error) {
+    throw std::system_error(error, std::generic_category(), "Error: " + what);
+  }
+
+  // Dirección de un socket local. La unión permite pasarla como sockaddr genérico sin
+  // conversiones de punteros.
+  union socket_address {
+    sockaddr_un local;
+    sockaddr generic;
+  };
+
+  socket_address local_address(std::string const & path) {
+    socket_address address{};
+    address.local.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.local.sun_path)) {
+      throw std::invalid_argument("Error: Socket path too long: " + path);
+    }
+    path.copy(&address.local.sun_path[0], path.size());
+    return address;
+  }
+
+  // Cierra el descriptor al salir del ámbito
+  class file_descriptor {
+  public:
+    explicit file_descriptor(int const fd_p) : fd{fd_p} { }
+
+    ~file_descriptor() {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+
+    file_descriptor(file_descriptor const &)             = delete;
+    file_descriptor & operator=(file_descriptor const &) = delete;
+    file_descriptor(file_descriptor &&)                  = delete;
+    file_descriptor & operator=(file_descriptor &&)      = delete;
+
+    [[nodiscard]] int get() const { return fd; }
+
+  private:
+    int fd;
+  };
+
+  // Lee del socket hasta que el otro extremo cierra su lado de escritura
+  std::string read_all(int const fd) {
+    std::string text;
+    std::array<char, 4096> buffer{};
+    for (;;) {
+      ssize_t const got = recv(fd, buffer.data(), buffer.size(), 0);
+      if (got > 0) {
+        text.append(buffer.data(), static_cast<std::size_t>(got));
+      } else if (got == 0) {
+        return text;
+      } else if (errno != EINTR) {
+        fail("Cannot read from socket", errno);
+      }
+    }
+  }
+
+  // Escribe todo el texto. Si el otro extremo ya ha cerrado, el error se devuelve en lugar de
+  // terminar el proceso con SIGPIPE.
+  void write_all(int const fd, std::string_view text) {
+    while (not text.empty()) {
+      ssize_t const sent = send(fd, text.data(), text.size(), MSG_NOSIGNAL);
+      if (sent >= 0) {
+        text.remove_prefix(static_cast<std::size_t>(sent));
+      } else if (errno != EINTR) {
+        fail("Cannot write to socket", errno);
+      }
+    }
+  }
+
+  // Separa "orden argumento"
+  std::pair<std::string_view, std::string_view> split_command(std::string_view const line) {
+    auto const space = line.find(' ');
+    if (space == std::string_view::npos) {
+      return {line, {}};
+    }
+    return {line.substr(0, space), line.substr(space + 1)};
+  }
+
+  double seconds_since(std::chrono::steady_clock::time_point const start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}  // namespace
+
+namespace render {
+
+  RenderRequest parse_render_request(std::string const & text) {
+    RenderRequest request;
+    std::istringstream in{text};
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      auto const [command, argument] = split_command(line);
+      if (command == "shutdown" and argument.empty()) {
+        request.shutdown = true;
+      } else if (command == "config") {
+        request.config_path = argument;
+      } else if (command == "set") {
+        request.overrides += argument;
+        request.overrides += '\n';
+      } else if (command == "scene") {
+        request.scene_path = argument;
+      } else if (command == "output") {
+        request.output_path = argument;
+      } else {
+        throw std::invalid_argument("Error: Unknown request command: " + line);
+      }
+    }
+    if (not request.shutdown and (request.scene_path.empty() or request.output_path.empty())) {
+      throw std::invalid_argument("Error: Request needs a scene and an output");
+    }
+    return request;
+  }
+
+  std::string format_render_request(RenderRequest const & request) {
+    if (request.shutdown) {
+      return "shutdown\n";
+    }
+    std::string text;
+    if (not request.config_path.empty()) {
+      text += "config " + request.config_path + "\n";
+    }
+    std::istringstream overrides{request.overrides};
+    std::string line;
+    while (std::getline(overrides, line)) {
+      if (not line.empty()) {
+        text += "set " + line + "\n";
+      }
+    }
+    text += "scene " + request.scene_path + "\n";
+    text += "output " + request.output_path + "\n";
+    return text;
+  }
+
+  std::string submit_render_request(std::string const & socket_path,
+                                    RenderRequest const & request) {
+    file_descriptor const connection{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (connection.get() < 0) {
+      fail("Cannot create socket", errno);
+    }
+    auto const address = local_address(socket_path);
+    if (connect(connection.get(), &address.generic, sizeof(address.local)) != 0) {
+      fail("Cannot connect to render server: " + socket_path, errno);
+    }
+    write_all(connection.get(), format_render_request(request));
+    // Cerrar la escritura marca el final de la petición
+    if (shutdown(connection.get(), SHUT_WR) != 0) {
+      fail("Cannot write to socket", errno);
+    }
+    auto reply = read_all(connection.get());
+    if (not reply.empty() and reply.back() == '\n') {
+      reply.pop_back();
+    }
+    return reply;
+  }
+
+  RenderServer::RenderServer(std::string socket_path_p, std::size_t const max_scenes)
+      : socket_path{std::move(socket_path_p)}, scenes{max_scenes} {
+    auto const address = local_address(socket_path);
+    // Un socket que ya existe es de un servidor anterior que no pudo borrarlo
+    if (std::filesystem::is_socket(socket_path)) {
+      std::filesystem::remove(socket_path);
+    } else if (std::filesystem::exists(socket_path)) {
+      throw std::runtime_error("Error: Socket path exists and is not a socket: " + socket_path);
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+      fail("Cannot create socket", errno);
+    }
+    if (bind(listen_fd, &address.generic, sizeof(address.local)) != 0 or
+        listen(listen_fd, SOMAXCONN) != 0)
+    {
+      int const error = errno;
+      close(listen_fd);
+      fail("Cannot listen on socket: " + socket_path, error);
+    }
+  }
+
+  RenderServer::~RenderServer() {
+    close(listen_fd);
+    unlink(socket_path.c_str());
+  }
+
+  void RenderServer::run() {
+    std::cout << "Servidor de render escuchando en " << socket_path << std::endl;
+    for (;;) {
+      file_descriptor const connection{accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC)};
+      if (connection.get() < 0) {
+        if (errno == EINTR or errno == ECONNABORTED) {
+          continue;
+        }
+        fail("Cannot accept connection", errno);
+      }
+
+      // Un error en una petición se devuelve al cliente y el servidor sigue atendiendo
+      std::string reply;
+      bool stop = false;
+      try {
+        auto const request = parse_render_request(read_all(connection.get()));
+        stop               = request.shutdown;
+        reply              = stop ? "ok shutdown" : handle(request);
+      } catch (std::exception const & e) {
+        reply = std::string{"error "} + e.what();
+      }
+      std::cout << reply << std::endl;
+      try {
+        write_all(connection.get(), reply + "\n");
+      } catch (std::system_error const & e) {
+        std::cerr << e.what() << '\n';
+      }
+      if (stop) {
+        return;
+      }
+    }
+  }
+
+  std::string RenderServer::handle(RenderRequest const & request) {
+    auto const start = std::chrono::steady_clock::now();
+
+    config cfg;
+    if (not request.config_path.empty()) {
+      load_config(request.config_path, cfg);
+    }
+    apply_config_text(request.overrides, cfg);
+    auto const cached = scenes.get(request.scene_path, cfg.get_scene_cache_dir());
+    double const load = seconds_since(start);
+
+    auto const render_start = std::chrono::steady_clock::now();
+    RenderJob job(std::move(cfg), cached.value, request.scene_path, request.output_path);
+    render_frame(job, CheckpointPlan{}, shard_spec{});
+    if (not job.hdr.empty()) {
+      write_pfm(hdr_path_for(job.output_path), job.hdr);
+    }
+    double const render = seconds_since(render_start);
+
+    std::ostringstream reply;
+    reply << "ok scene=" << (cached.hit ? "hit" : "miss");
+    if (cached.disk != scene_cache_status::off) {
+      reply << " disk=" << to_string(cached.disk);
+    }
+    reply << " load=" << load
+          << " render=" << render << " total=" << seconds_since(start);
+    return reply.str();
+  }
+
+}  // namespace render
@@ -0,0 +1,57 @@
+// render-server: servidor de render persistente. Mantiene en memoria las escenas ya leídas y los
+// hilos de TBB entre trabajos, y atiende las peticiones de render-client por un socket local.
+//
+//   render-server <socket> [max_escenas]
+//
+// Se detiene con render-client <socket> --shutdown.
+
+#include "render_server.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <gsl/span>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+  // Escenas que se guardan si no se indica otra cosa
+  constexpr std::size_t default_max_scenes = 8;
+
+  std::size_t parse_max_scenes(std::string const & text) {
+    std::size_t used = 0;
+    unsigned long scenes = 0;
+    try {
+      scenes = std::stoul(text, &used);
+    } catch (std::exception const &) {
+      used = 0;
+    }
+    if (used != text.size() or scenes == 0) {
+      throw std::invalid_argument("Error: Invalid number of scenes: " + text);
+    }
+    return scenes;
+  }
+
+  int run(gsl::span<char const * const> args) {
+    if (args.size() != 2 and args.size() != 3) {
+      std::cerr << "Uso: render-server <socket> [max_escenas]\n";
+      return EXIT_FAILURE;
+    }
+    auto const max_scenes = args.size() == 3 ? parse_max_scenes(args[2]) : default_max_scenes;
+    render::RenderServer server(args[1], max_scenes);
+    server.run();
+    return EXIT_SUCCESS;
+  }
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  try {
+    return run({argv, static_cast<std::size_t>(argc)});
+  } catch (std::exception const & e) {
+    std::cerr << "Ha ocurrido una excepción: " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,171 @@
+#include "shard_workers.hpp"
+#include "shard.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+  // Descriptor por el que cada worker escribe su parte
+  constexpr int shard_fd = 3;
+
+  // Proceso hijo y el extremo de lectura de su tubería
+  struct Worker {
+    pid_t pid{-1};
+    int fd{-1};
+    std::string data;
+  };
+
+  [[noreturn]] void fail(std::string const & what, int const error) {
+    throw std::system_error(error, std::generic_category(), "Error: " + what);
+  }
+
+  // Lanza "<exe> --shard i/N <config> <escena> /dev/fd/3" con la salida estándar descartada y el
+  // extremo de escritura de la tubería como descriptor 3
+  Worker spawn_worker(int const index, int const count, std::string const & config_path,
+                      std::string const & scene_path) {
+    std::array<int, 2> fds{};
+    if (pipe2(fds.data(), O_CLOEXEC) != 0) {
+      fail("Cannot create pipe", errno);
+    }
+
+    std::vector<std::string> arguments{"/proc/self/exe",
+                                       "--shard",
+                                       std::to_string(index) + "/" + std::to_string(count),
+                                       config_path,
+                                       scene_path,
+                                       "/dev/fd/" + std::to_string(shard_fd)};
+    std::vector<char *> argv;
+    for (auto & argument : arguments) {
+      argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions{};
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], shard_fd);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    Worker worker;
+    int const error = posix_spawn(&worker.pid, argv.front(), &actions, nullptr, argv.data(),
+                                  environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (error != 0) {
+      close(fds[0]);
+      fail("Cannot start shard worker", error);
+    }
+    worker.fd = fds[0];
+    return worker;
+  }
+
+  // Lee todas las tuberías a la vez hasta que se cierran, para que ningún worker se quede
+  // bloqueado con la tubería llena
+  void collect(std::vector<Worker> & workers) {
+    std::array<char, 1 << 16> buffer{};
+    std::size_t open = workers.size();
+    while (open > 0) {
+      std::vector<pollfd> polled;
+      std::vector<Worker *> owners;
+      for (auto & worker : workers) {
+        if (worker.fd >= 0) {
+          polled.push_back(pollfd{.fd = worker.fd, .events = POLLIN, .revents = 0});
+          owners.push_back(&worker);
+        }
+      }
+      if (poll(polled.data(), polled.size(), -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        fail("Cannot read shard workers", errno);
+      }
+      for (std::size_t i = 0; i < polled.size(); ++i) {
+        if (polled[i].revents == 0) {
+          continue;
+        }
+        Worker & worker = *owners[i];
+        ssize_t const got = read(worker.fd, buffer.data(), buffer.size());
+        if (got > 0) {
+          worker.data.append(buffer.data(), static_cast<std::size_t>(got));
+        } else if (got == 0 or errno != EINTR) {
+          close(worker.fd);
+          worker.fd = -1;
+          --open;
+        }
+      }
+    }
+  }
+
+  // Espera a todos los workers y devuelve los números de los que no han terminado bien
+  std::string wait_all(std::vector<Worker> const & workers) {
+    std::string failed;
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+      int status = 0;
+      while (waitpid(workers[i].pid, &status, 0) < 0 and errno == EINTR) {
+      }
+      if (not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+        failed += ' ';
+        failed += std::to_string(i);
+      }
+    }
+    return failed;
+  }
+
+}  // namespace
+
+namespace render {
+
+  void render_with_workers(int const workers, std::string const & config_path,
+                           std::string const & scene_path, std::string const & output_path) {
+    if (workers <= 0) {
+      throw std::invalid_argument("Error: Invalid number of workers: " +
+                                  std::to_string(workers));
+    }
+    // Se vacía antes de lanzar los procesos para que sus mensajes de error salgan después
+    std::cout << "Coordinador: " << workers << " procesos en esta máquina." << std::endl;
+
+    std::vector<Worker> running;
+    try {
+      for (int i = 0; i < workers; ++i) {
+        running.push_back(spawn_worker(i, workers, config_path, scene_path));
+      }
+      collect(running);
+    } catch (...) {
+      // Los workers ya lanzados terminan solos al cerrarse su tubería
+      for (auto & worker : running) {
+        if (worker.fd >= 0) {
+          close(worker.fd);
+        }
+      }
+      static_cast<void>(wait_all(running));
+      throw;
+    }
+    if (auto const failed = wait_all(running); not failed.empty()) {
+      throw std::runtime_error("Error: Shard workers failed:" + failed);
+    }
+
+    std::vector<shard> parts;
+    for (std::size_t i = 0; i < running.size(); ++i) {
+      std::istringstream in{std::move(running[i].data)};
+      parts.push_back(read_shard(in));
+      if (parts.back().header.part.index != static_cast<int>(i)) {
+        throw std::runtime_error("Error: Worker " + std::to_string(i) + " sent another shard");
+      }
+      std::cout << "Parte " << i << ": " << shard_rows(parts.back().header) << " filas.\n";
+    }
+    write_shard_image(merge_shards(parts), output_path);
+  }
+
+}  // namespace render
@@ -0,0 +1,108 @@
+#include "thread_pinning.hpp"
+#include "config.hpp"
+#include "cpu_topology.hpp"
+
+#include <oneapi/tbb/info.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  // CPU en las que el proceso puede ejecutarse
+  std::vector<int> allowed_cpus(cpu_set_t const & mask) {
+    std::vector<int> cpus;
+    for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &mask)) {
+        cpus.push_back(static_cast<int>(cpu));
+      }
+    }
+    return cpus;
+  }
+
+}  // namespace
+
+namespace render {
+
+  ThreadPinning::ThreadPinning(std::vector<int> cpus) : cpus_{std::move(cpus)} {
+    CPU_ZERO(&original_mask_);
+    static_cast<void>(sched_getaffinity(0, sizeof(original_mask_), &original_mask_));
+    observe(true);
+  }
+
+  ThreadPinning::~ThreadPinning() {
+    observe(false);
+    // Los hilos que siguen en la arena no pasan por on_scheduler_exit tras desactivar el
+    // observador: se les devuelve la máscara desde aquí. Si el hilo ya terminó, falla sin más.
+    std::scoped_lock const lock{pinned_mutex_};
+    for (pid_t const tid : pinned_) {
+      static_cast<void>(sched_setaffinity(tid, sizeof(original_mask_), &original_mask_));
+    }
+  }
+
+  std::unique_ptr<ThreadPinning> ThreadPinning::create(config const & cfg) {
+    std::string const policy = cfg.get_thread_affinity();
+    if (policy == "none") {
+      return nullptr;
+    }
+    if (cfg.get_numa() == "on" and cfg.get_scheduler() != "worksteal" and
+        tbb::info::numa_nodes().size() > 1)
+    {
+      std::cout << "Afinidad: no se aplica con numa: on, cada arena se fija a su nodo.\n";
+      return nullptr;
+    }
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+      std::cout << "Afinidad: no se puede leer la máscara de CPU, se desactiva.\n";
+      return nullptr;
+    }
+
+    auto const cpus  = allowed_cpus(mask);
+    auto const cores = read_cpu_topology("/sys/devices/system/cpu", cpus);
+    auto plan        = affinity_plan(cores, policy);
+    if (plan.empty()) {
+      return nullptr;
+    }
+
+    std::cout << "Afinidad: " << policy << ", " << plan.size() << " CPU lógicas en "
+              << cores.size() << " núcleos físicos.\n";
+    return std::make_unique<ThreadPinning>(std::move(plan));
+  }
+
+  void ThreadPinning::on_scheduler_entry(bool /*is_worker*/) {
+    int const slot = tbb::this_task_arena::current_thread_index();
+    if (slot < 0) {
+      return;
+    }
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    auto const cpu = cpus_[static_cast<std::size_t>(slot) % cpus_.size()];
+    CPU_SET(static_cast<std::size_t>(cpu), &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask) == 0) {
+      std::scoped_lock const lock{pinned_mutex_};
+      pinned_.push_back(gettid());
+    }
+  }
+
+  void ThreadPinning::on_scheduler_exit(bool /*is_worker*/) {
+    static_cast<void>(sched_setaffinity(0, sizeof(original_mask_), &original_mask_));
+    std::scoped_lock const lock{pinned_mutex_};
+    auto const found = std::find(pinned_.begin(), pinned_.end(), gettid());
+    if (found != pinned_.end()) {
+      pinned_.erase(found);
+    }
+  }
+
+}  // namespace render
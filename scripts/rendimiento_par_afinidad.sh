@@ -0,0 +1,50 @@
+#!/bin/bash
+
+
+set -Eeuo pipefail
+
+export LD_LIBRARY_PATH="/opt/gcc-14/lib64${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}"
+
+BINARY="${BINARY:-$(pwd)/out/build/default/par/Release/render-par}"
+CONFIG_DIR="$(pwd)/tests"
+OUTPUT_DIR="$(pwd)/out/rendimiento"
+REPETICIONES="${REPETICIONES:-3}"
+
+mkdir -p "$OUTPUT_DIR"
+
+SPP="$(awk '/^samples_per_pixel:/ { print $2 }' "$CONFIG_DIR/config4.txt")"
+
+# Política -> claves que se añaden a config4
+declare -A POLITICAS=(
+    [sin_afinidad]=""
+    [nucleos]="thread_affinity: cores"
+    [smt]="thread_affinity: smt"
+    [nucleos_2_flujos]=$'thread_affinity: cores\nray_streams: 2'
+)
+
+# === CASO 4: afinidad de hilos ===
+echo "=== Caso 4 PAR - afinidad de hilos, ${REPETICIONES} repeticiones por política ==="
+printf "%-18s %12s %16s\n" "politica" "tiempo_s" "rayos_primarios/s"
+
+for politica in sin_afinidad nucleos smt nucleos_2_flujos; do
+    config="$OUTPUT_DIR/config4_${politica}.txt"
+    { cat "$CONFIG_DIR/config4.txt"; echo; echo "${POLITICAS[$politica]}"; } > "$config"
+
+    mejor=""
+    pixeles=""
+    for _ in $(seq "$REPETICIONES"); do
+        salida="$("$BINARY" "$config" "$CONFIG_DIR/scene4.txt" "$OUTPUT_DIR/par_4_${politica}.ppm")"
+        tiempo="$(sed -n 's/^Tiempo total: \([0-9.e+-]*\) segundos\./\1/p' <<< "$salida")"
+        pixeles="$(sed -n 's/^Renderizando escena (\([0-9]*\)x\([0-9]*\)).*/\1 \2/p' <<< "$salida" \
+                   | awk '{ print $1 * $2 }')"
+        if [[ -z "$mejor" ]] || awk -v t="$tiempo" -v m="$mejor" 'BEGIN { exit !(t < m) }'; then
+            mejor="$tiempo"
+        fi
+    done
+
+    awk -v p="$politica" -v t="$mejor" -v n="$pixeles" -v s="$SPP" \
+        'BEGIN { printf "%-18s %12.3f %16.0f\n", p, t, n * s / t }'
+done
+
+echo ""
+echo " Caso 4 completado (mejor tiempo de cada política)"
@@ -1,16 +1,19 @@
 #pragma once
 #include "color.hpp"
+#include "image_io.hpp"
+#include "tonemap.hpp"
 #include <cstdint>
-#include <fstream>
 #include <iostream>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 class ImageSOA {
 public:
-  ImageSOA(int width, int height) : width_(width), height_(height) {
-    if (width > 0 and height > 0) {
+  // Sin allocate_pixels solo se guardan las dimensiones (salida en flujo por bandas)
+  ImageSOA(int width, int height, bool allocate_pixels = true) : width_(width), height_(height) {
+    if (allocate_pixels and width > 0 and height > 0) {
       size_t const total_pixels = static_cast<size_t>(width_) * static_cast<size_t>(height_);
       r_channel_.resize(total_pixels);
       g_channel_.resize(total_pixels);
@@ -40,19 +43,43 @@ public:
     b_channel_[index] = color.to_discrete_b(gamma);
   }
 
-  void save_ppm(std::string const & filename) const {
-    std::ofstream out(filename);
-    if (!out.is_open()) {
-      throw std::runtime_error("Error: Cannot open file for writing: " + filename);
+  // Convierte una fila completa de colores lineales con el tonemapper dado
+  void set_row(int y, std::span<render::color const> pixels, render::tonemapper const & tonemap) {
+    if (r_channel_.empty()) {
+      return;
+    }
+    if (y < 0 or y >= height_ or pixels.size() != static_cast<size_t>(width_)) {
+      throw std::out_of_range("Error: set_row coordinates are out of bounds.");
+    }
+    size_t const first = static_cast<size_t>(y) * static_cast<size_t>(width_);
+    tonemap.map(pixels, std::span{r_channel_}.subspan(first, pixels.size()),
+                std::span{g_channel_}.subspan(first, pixels.size()),
+                std::span{b_channel_}.subspan(first, pixels.size()));
+  }
+
+  // Guarda la imagen como P3 (texto) o P6 (binario, una sola escritura)
+  void save_ppm(std::string const & filename,
+                render::image_format format = render::image_format::p3) const {
+    if (format == render::image_format::p6) {
+      render::write_p6(filename, width_, height_, r_channel_, g_channel_, b_channel_);
+      return;
     }
 
-    out << "P3\n" << width_ << " " << height_ << "\n255\n";
+    render::write_p3(filename, width_, height_, r_channel_, g_channel_, b_channel_);
+  }
 
-    size_t const total_pixels = static_cast<size_t>(width_) * static_cast<size_t>(height_);
-    for (size_t i = 0; i < total_pixels; ++i) {
-      out << static_cast<int>(r_channel_[i]) << " " << static_cast<int>(g_channel_[i]) << " "
-          << static_cast<int>(b_channel_[i]) << "\n";
+  // Guarda la imagen comprimida sin pérdidas (QOI), codificada en paralelo por franjas
+  void save_qoi(std::string const & filename) const {
+    render::write_qoi(filename, width_, height_, r_channel_, g_channel_, b_channel_);
+  }
+
+  // Guarda en el formato indicado
+  void save(std::string const & filename, render::image_format format) const {
+    if (format == render::image_format::qoi) {
+      save_qoi(filename);
+      return;
     }
+    save_ppm(filename, format);
   }
 
 private:
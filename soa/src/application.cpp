@@ -2,21 +2,29 @@
 #include "camera.hpp"
 #include "color.hpp"
 #include "config.hpp"
+#include "hdr_image.hpp"
+#include "image_io.hpp"
 #include "image_soa.hpp"
 #include "object.hpp"
 #include "ray.hpp"
 #include "scene.hpp"
 #include "scene_parser.hpp"
+#include "tonemap.hpp"
 #include "vector.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <gsl/span>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <random>
+#include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -26,6 +34,7 @@ namespace {
     render::scene scene_data;
     render::camera cam;
     ImageSOA image;
+    render::hdr_image hdr;  // Color lineal; solo se reserva con framebuffer: hdr
     std::string output_path;
     std::mt19937_64 ray_rng;
     std::mt19937_64 material_rng;
@@ -49,7 +58,10 @@ namespace {
 
       // Re-crear cámara e imagen con configuración cargada
       cam   = render::camera{cfg};
-      image = ImageSOA{image_width, image_height};
+      image = ImageSOA{image_width, image_height, cfg.get_stream_window() == 0};
+      if (cfg.get_framebuffer() == "hdr") {
+        hdr = render::hdr_image{image_width, image_height};
+      }
 
       // Inicializar generadores de números aleatorios
       ray_rng.seed(static_cast<std::mt19937_64::result_type>(cfg.get_ray_rng_seed()));
@@ -104,6 +116,27 @@ namespace {
     std::cout << "Renderizando escena (" << image_width << "x" << image_height << ") con "
               << samples_per_pixel << " samples/pixel...\n";
 
+    // Cada fila se acumula en lineal y se convierte a 8 bits de una vez
+    render::tonemapper const tonemap{gamma};
+    auto const width = static_cast<size_t>(std::max(image_width, 0));
+    std::vector<render::color> row(width);
+
+    // Con salida en flujo las filas se cuantizan en los canales de una banda de tile_height
+    // filas, que se escribe al completarse, en lugar de en la imagen completa
+    int const band_height = std::max(1, job.cfg.get_tile_height());
+    std::optional<render::image_stream_writer> writer;
+    std::vector<std::uint8_t> band_r;
+    std::vector<std::uint8_t> band_g;
+    std::vector<std::uint8_t> band_b;
+    if (job.cfg.get_stream_window() > 0) {
+      writer.emplace(job.output_path,
+                     render::resolve_image_format(job.cfg.get_output_format(), job.output_path),
+                     image_width, image_height);
+      band_r.resize(width * static_cast<size_t>(band_height));
+      band_g.resize(band_r.size());
+      band_b.resize(band_r.size());
+    }
+
     // Renderizar fila por fila
     for (int j = 0; j < image_height; ++j) {
       std::cerr << "\rScanlines restantes: " << (image_height - j) << "   " << std::flush;
@@ -121,12 +154,33 @@ namespace {
           accumulated += sample_color;
         }
 
-        // Promediar muestras y guardar píxel directamente (SOA)
-        render::color const pixel_color = accumulated / static_cast<double>(samples_per_pixel);
-        job.image.set_pixel(i, j, pixel_color, gamma);
+        // Promediar muestras
+        row[static_cast<size_t>(i)] = accumulated / static_cast<double>(samples_per_pixel);
+      }
+
+      if (writer) {
+        int const band_row  = j % band_height;
+        size_t const offset = static_cast<size_t>(band_row) * width;
+        tonemap.map(row, std::span{band_r}.subspan(offset, width),
+                    std::span{band_g}.subspan(offset, width),
+                    std::span{band_b}.subspan(offset, width));
+        if (band_row == band_height - 1 or j == image_height - 1) {
+          writer->write_rows(std::span{band_r}.first(offset + width),
+                             std::span{band_g}.first(offset + width),
+                             std::span{band_b}.first(offset + width));
+        }
+      } else {
+        // Guardar la fila en los canales (SOA)
+        job.image.set_row(j, row, tonemap);
+      }
+      if (not job.hdr.empty()) {
+        job.hdr.set_rows(j, row);
       }
     }
 
+    if (writer) {
+      writer->finish();
+    }
     std::cerr << "\rRenderizado completado. \n";
   }
 
@@ -149,9 +203,18 @@ int render::Application::run(gsl::span<char const * const> args) {
     std::chrono::duration<double> const elapsed = end_time - start_time;
     std::cout << "Tiempo total: " << elapsed.count() << " segundos.\n";
 
-    // Guardar imagen al final en canales separados para SOA
-    job.image.save_ppm(job.output_path);
+    // Guardar imagen al final en canales separados para SOA (en flujo ya está escrita)
+    if (job.cfg.get_stream_window() == 0) {
+      job.image.save(job.output_path,
+                     render::resolve_image_format(job.cfg.get_output_format(), job.output_path));
+    }
     std::cout << "Imagen guardada como " << job.output_path << "\n";
+    if (not job.hdr.empty()) {
+      std::string const hdr_path = render::hdr_path_for(job.output_path);
+      render::write_pfm(hdr_path, job.hdr);
+      std::cout << "Imagen lineal guardada como " << hdr_path << " ("
+                << job.cfg.get_samples_per_pixel() << " muestras/píxel)\n";
+    }
 
     return EXIT_SUCCESS;
   } catch (std::exception const & e) {
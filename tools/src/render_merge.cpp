@@ -0,0 +1,49 @@
+// render-merge: junta los ficheros de parte de un render distribuido (render-par --shard i/N)
+// en la imagen final, idéntica a la de un render en un solo proceso con la misma configuración.
+//
+//   render-merge <salida> <parte>...
+//
+// El formato de salida se resuelve como en render-par, con el output_format de la configuración
+// y la extensión de la salida. Si las partes llevan color lineal se escribe también el PFM.
+
+#include "shard.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <gsl/span>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  int run(gsl::span<char const * const> args) {
+    if (args.size() < 3) {
+      std::cerr << "Uso: render-merge <salida> <parte>...\n";
+      return EXIT_FAILURE;
+    }
+    std::string const output_path = args[1];
+
+    std::vector<render::shard> parts;
+    for (std::size_t i = 2; i < args.size(); ++i) {
+      parts.push_back(render::read_shard_file(args[i]));
+      auto const & header = parts.back().header;
+      std::cout << "Parte " << header.part.index << "/" << header.part.count << " (" << args[i]
+                << ", " << render::shard_rows(header) << " filas)\n";
+    }
+    render::write_shard_image(render::merge_shards(parts), output_path);
+    std::cout << "Imagen guardada como " << output_path << "\n";
+    return EXIT_SUCCESS;
+  }
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  try {
+    return run({argv, static_cast<std::size_t>(argc)});
+  } catch (std::exception const & e) {
+    std::cerr << "Ha ocurrido una excepción: " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
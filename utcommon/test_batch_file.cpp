@@ -0,0 +1,57 @@
+#include "batch_file.hpp"
+#include "config.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace render {
+
+  TEST(BatchFileTest, SplitsJobsAtOutputLines) {
+    std::istringstream in{"# Dos vistas\n"
+                          "output vista1.ppm\n"
+                          "field_of_view: 60\n"
+                          "\n"
+                          "output  vista2.ppm \n"
+                          "output vista3.ppm\n"
+                          "samples_per_pixel: 4\n"
+                          "image_width: 32\n"};
+    auto const jobs = parse_batch_jobs(in);
+    ASSERT_EQ(jobs.size(), 3U);
+    EXPECT_EQ(jobs[0].output_path, "vista1.ppm");
+    EXPECT_EQ(jobs[0].overrides, "field_of_view: 60\n");
+    EXPECT_EQ(jobs[1].output_path, "vista2.ppm");
+    EXPECT_TRUE(jobs[1].overrides.empty());
+    EXPECT_EQ(jobs[2].output_path, "vista3.ppm");
+    EXPECT_EQ(jobs[2].overrides, "samples_per_pixel: 4\nimage_width: 32\n");
+  }
+
+  TEST(BatchFileTest, OverridesApplyOnTopOfConfig) {
+    std::istringstream in{"output a.ppm\nimage_width: 32\n"};
+    auto const jobs = parse_batch_jobs(in);
+    config cfg;
+    cfg.set_samples_per_pixel(7);
+    apply_config_text(jobs[0].overrides, cfg);
+    EXPECT_EQ(cfg.get_image_width(), 32);
+    EXPECT_EQ(cfg.get_samples_per_pixel(), 7);
+  }
+
+  TEST(BatchFileTest, RejectsKeysBeforeFirstOutput) {
+    std::istringstream in{"image_width: 32\noutput a.ppm\n"};
+    EXPECT_THROW(parse_batch_jobs(in), std::invalid_argument);
+  }
+
+  TEST(BatchFileTest, RejectsOutputWithoutPath) {
+    std::istringstream in{"output\n"};
+    EXPECT_THROW(parse_batch_jobs(in), std::invalid_argument);
+  }
+
+  TEST(BatchFileTest, RejectsEmptyFile) {
+    std::istringstream in{"# nada\n\n"};
+    EXPECT_THROW(parse_batch_jobs(in), std::invalid_argument);
+  }
+
+  TEST(BatchFileTest, MissingFileThrows) {
+    EXPECT_THROW(read_batch_file("no_such_batch_file.txt"), std::runtime_error);
+  }
+
+}  // namespace render
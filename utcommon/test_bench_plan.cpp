@@ -0,0 +1,69 @@
+#include "bench_plan.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  TEST(BenchPlanTest, ReadsEveryKey) {
+    std::istringstream in{"# Matriz completa\n"
+                          "config: tests/config1.txt\n"
+                          "scene: tests/scene1.txt\n"
+                          "\n"
+                          "scene:  tests/scene2.txt \n"
+                          "frontends: soa par\n"
+                          "threads: 1 2 -1\n"
+                          "partitioners: simple static\n"
+                          "repetitions: 5\n"
+                          "reference: par\n"};
+    auto const plan = parse_bench_plan(in);
+    EXPECT_EQ(plan.config_path, "tests/config1.txt");
+    EXPECT_EQ(plan.scene_paths, (std::vector<std::string>{"tests/scene1.txt", "tests/scene2.txt"}));
+    EXPECT_EQ(plan.frontends, (std::vector<std::string>{"soa", "par"}));
+    EXPECT_EQ(plan.thread_counts, (std::vector<int>{1, 2, -1}));
+    EXPECT_EQ(plan.partitioners, (std::vector<std::string>{"simple", "static"}));
+    EXPECT_EQ(plan.repetitions, 5);
+    EXPECT_EQ(plan.reference, "par");
+  }
+
+  TEST(BenchPlanTest, DefaultsToAllFrontendsAndFirstAsReference) {
+    std::istringstream in{"config: c.txt\nscene: s.txt\n"};
+    auto const plan = parse_bench_plan(in);
+    EXPECT_EQ(plan.frontends, (std::vector<std::string>{"aos", "soa", "par"}));
+    EXPECT_EQ(plan.thread_counts, (std::vector<int>{-1}));
+    EXPECT_EQ(plan.partitioners, (std::vector<std::string>{"auto"}));
+    EXPECT_EQ(plan.repetitions, 3);
+    EXPECT_EQ(plan.reference, "aos");
+  }
+
+  TEST(BenchPlanTest, RejectsMissingConfigOrScenes) {
+    std::istringstream no_config{"scene: s.txt\n"};
+    EXPECT_THROW(parse_bench_plan(no_config), std::invalid_argument);
+    std::istringstream no_scene{"config: c.txt\n"};
+    EXPECT_THROW(parse_bench_plan(no_scene), std::invalid_argument);
+  }
+
+  TEST(BenchPlanTest, RejectsInvalidValues) {
+    for (std::string const line :
+         {"frontends: aos gpu", "threads: 0", "threads: 2x", "partitioners: affinity",
+          "repetitions: 0", "reference: aos", "color: red", "scene: a.txt b.txt", "threads:",
+          "sin clave"})
+    {
+      std::istringstream in{"config: c.txt\nscene: s.txt\nfrontends: soa par\n" + line + "\n"};
+      EXPECT_THROW(parse_bench_plan(in), std::invalid_argument) << line;
+    }
+  }
+
+  TEST(BenchPlanTest, ReadsFromFile) {
+    std::ofstream{"temp_bench_plan.txt"} << "config: c.txt\nscene: s.txt\nthreads: 4\n";
+    auto const plan = read_bench_plan("temp_bench_plan.txt");
+    EXPECT_EQ(plan.thread_counts, (std::vector<int>{4}));
+    std::filesystem::remove("temp_bench_plan.txt");
+    EXPECT_THROW(read_bench_plan("temp_bench_plan_missing.txt"), std::runtime_error);
+  }
+
+}  // namespace render
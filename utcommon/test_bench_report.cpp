@@ -0,0 +1,110 @@
+#include "bench_report.hpp"
+#include "image_io.hpp"
+#include <cmath>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    std::vector<bench_result> sample_results() {
+      return {
+          bench_result{.frontend        = "aos",
+                       .scene           = "tests/scene1.txt",
+                       .threads         = 1,
+                       .partitioner     = "-",
+                       .wall_seconds    = 1.5,
+                       .rays_per_second = 240'000.0,
+                       .peak_rss_kib    = 12'345,
+                       .rmse            = 0.0,
+                       .max_error       = 0},
+          bench_result{.frontend        = "par",
+                       .scene           = "escenas/\"a,b\".txt",
+                       .threads         = -1,
+                       .partitioner     = "static",
+                       .wall_seconds    = 0.25,
+                       .rays_per_second = 1.44e6,
+                       .peak_rss_kib    = 20'000,
+                       .rmse            = 3.125,
+                       .max_error       = 17},
+      };
+    }
+
+  }  // namespace
+
+  TEST(BenchReportTest, CompareImagesMeasuresRmseAndMaxError) {
+    ppm_image const a{.width = 2, .height = 1, .rgb = {0, 0, 0, 10, 10, 10}};
+    ppm_image const b{.width = 2, .height = 1, .rgb = {0, 0, 6, 10, 10, 10}};
+    auto const same = compare_images(a, a);
+    EXPECT_DOUBLE_EQ(same.rmse, 0.0);
+    EXPECT_EQ(same.max_error, 0);
+    auto const diff = compare_images(a, b);
+    EXPECT_DOUBLE_EQ(diff.rmse, std::sqrt(36.0 / 6.0));
+    EXPECT_EQ(diff.max_error, 6);
+
+    ppm_image const other{.width = 1, .height = 2, .rgb = a.rgb};
+    EXPECT_THROW((void)compare_images(a, other), std::invalid_argument);
+  }
+
+  TEST(BenchReportTest, CsvRoundTrip) {
+    auto const results = sample_results();
+    std::istringstream in{bench_results_csv(results)};
+    auto const loaded = parse_bench_results_csv(in);
+    ASSERT_EQ(loaded.size(), results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(loaded[i].frontend, results[i].frontend);
+      EXPECT_EQ(loaded[i].scene, results[i].scene);
+      EXPECT_EQ(loaded[i].threads, results[i].threads);
+      EXPECT_EQ(loaded[i].partitioner, results[i].partitioner);
+      EXPECT_EQ(loaded[i].wall_seconds, results[i].wall_seconds);
+      EXPECT_EQ(loaded[i].rays_per_second, results[i].rays_per_second);
+      EXPECT_EQ(loaded[i].peak_rss_kib, results[i].peak_rss_kib);
+      EXPECT_EQ(loaded[i].rmse, results[i].rmse);
+      EXPECT_EQ(loaded[i].max_error, results[i].max_error);
+    }
+  }
+
+  TEST(BenchReportTest, CsvRejectsOtherFormats) {
+    std::istringstream no_header{"aos,s.txt,1,-,1,1,1,0,0\n"};
+    EXPECT_THROW(parse_bench_results_csv(no_header), std::invalid_argument);
+    auto const header = bench_results_csv({});
+    std::istringstream short_line{header + "aos,s.txt,1\n"};
+    EXPECT_THROW(parse_bench_results_csv(short_line), std::invalid_argument);
+    std::istringstream bad_number{header + "aos,s.txt,uno,-,1,1,1,0,0\n"};
+    EXPECT_THROW(parse_bench_results_csv(bad_number), std::invalid_argument);
+  }
+
+  TEST(BenchReportTest, JsonEscapesStrings) {
+    auto const json = bench_results_json(sample_results());
+    EXPECT_EQ(json.front(), '[');
+    EXPECT_NE(json.find("\"frontend\": \"aos\""), std::string::npos);
+    EXPECT_NE(json.find("\"scene\": \"escenas/\\\"a,b\\\".txt\""), std::string::npos);
+    EXPECT_NE(json.find("\"threads\": -1"), std::string::npos);
+    EXPECT_NE(json.find("\"rmse\": 3.125"), std::string::npos);
+    EXPECT_EQ(bench_results_json({}), "[]\n");
+  }
+
+  TEST(BenchReportTest, FindRegressionsAboveThreshold) {
+    auto const baseline = sample_results();
+    auto current        = baseline;
+
+    current[0].wall_seconds = 1.6;  // Un 6,7 % más lento
+    current[1].wall_seconds = 0.3;  // Un 20 % más lento
+    EXPECT_TRUE(find_regressions(baseline, baseline, 0.1).empty());
+
+    auto const regressions = find_regressions(current, baseline, 0.1);
+    ASSERT_EQ(regressions.size(), 1U);
+    EXPECT_EQ(regressions[0].current.frontend, "par");
+    EXPECT_DOUBLE_EQ(regressions[0].baseline_seconds, 0.25);
+    EXPECT_NEAR(regressions[0].slowdown, 0.2, 1e-12);
+
+    current[1].threads = 4;  // Sin referencia: no se compara
+    EXPECT_TRUE(find_regressions(current, baseline, 0.1).empty());
+  }
+
+}  // namespace render
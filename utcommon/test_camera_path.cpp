@@ -0,0 +1,71 @@
+#include "camera_path.hpp"
+#include "config.hpp"
+#include "vector.hpp"
+#include <gtest/gtest.h>
+
+namespace render {
+
+  namespace {
+
+    config two_keyframes() {
+      config cfg;
+      cfg.add_camera_keyframe(camera_keyframe{.time          = 10.0,
+                                              .position      = vector{0.0, 0.0, -10.0},
+                                              .target        = vector{0.0, 0.0, 0.0},
+                                              .north         = vector{0.0, 1.0, 0.0},
+                                              .field_of_view = 90.0});
+      cfg.add_camera_keyframe(camera_keyframe{.time          = 20.0,
+                                              .position      = vector{10.0, 0.0, 0.0},
+                                              .target        = vector{0.0, 2.0, 0.0},
+                                              .north         = vector{0.0, 1.0, 0.0},
+                                              .field_of_view = 50.0});
+      return cfg;
+    }
+
+  }  // namespace
+
+  TEST(CameraPathTest, WithoutKeyframesKeepsCamera) {
+    config cfg;
+    cfg.set_camera_position(vector{1.0, 2.0, 3.0});
+    auto const frame = frame_config(cfg, 7);
+    EXPECT_DOUBLE_EQ(frame.get_camera_position().x, 1.0);
+    EXPECT_DOUBLE_EQ(frame.get_field_of_view(), cfg.get_field_of_view());
+  }
+
+  TEST(CameraPathTest, InterpolatesBetweenKeyframes) {
+    auto const frame = frame_config(two_keyframes(), 15);
+    EXPECT_DOUBLE_EQ(frame.get_camera_position().x, 5.0);
+    EXPECT_DOUBLE_EQ(frame.get_camera_position().z, -5.0);
+    EXPECT_DOUBLE_EQ(frame.get_camera_target().y, 1.0);
+    EXPECT_DOUBLE_EQ(frame.get_field_of_view(), 70.0);
+  }
+
+  TEST(CameraPathTest, HitsKeyframesExactly) {
+    auto const cfg = two_keyframes();
+    EXPECT_DOUBLE_EQ(frame_config(cfg, 10).get_field_of_view(), 90.0);
+    EXPECT_DOUBLE_EQ(frame_config(cfg, 20).get_field_of_view(), 50.0);
+  }
+
+  // Fuera del intervalo de los fotogramas clave se mantiene la cámara del extremo
+  TEST(CameraPathTest, ClampsOutsideKeyframes) {
+    auto const cfg    = two_keyframes();
+    auto const before = frame_config(cfg, 0);
+    EXPECT_DOUBLE_EQ(before.get_camera_position().z, -10.0);
+    EXPECT_DOUBLE_EQ(before.get_field_of_view(), 90.0);
+    auto const after = frame_config(cfg, 30);
+    EXPECT_DOUBLE_EQ(after.get_camera_position().x, 10.0);
+    EXPECT_DOUBLE_EQ(after.get_field_of_view(), 50.0);
+  }
+
+  TEST(CameraPathTest, OutputPathReplacesHashes) {
+    EXPECT_EQ(frame_output_path("vuelta_###.ppm", 7), "vuelta_007.ppm");
+    EXPECT_EQ(frame_output_path("dir#/f##.qoi", 123), "dir#/f123.qoi");
+    EXPECT_EQ(frame_output_path("#", 5), "5");
+  }
+
+  TEST(CameraPathTest, OutputPathAppendsNumber) {
+    EXPECT_EQ(frame_output_path("vuelta.ppm", 7), "vuelta_0007.ppm");
+    EXPECT_EQ(frame_output_path("out/vuelta", 12), "out/vuelta_0012");
+  }
+
+}  // namespace render
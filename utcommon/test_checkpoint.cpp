@@ -0,0 +1,128 @@
+#include "checkpoint.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    void write_text(std::string const & filename, std::string const & text) {
+      std::ofstream out(filename, std::ios::binary);
+      out << text;
+    }
+
+  }  // namespace
+
+  TEST(CheckpointTest, RoundTripKeepsRowsAndLinear) {
+    std::string const filename = "temp_checkpoint_test.ckpt";
+    checkpoint_header const header{.width       = 2,
+                                   .height      = 4,
+                                   .band_height = 2,
+                                   .rows_done   = 2,
+                                   .fingerprint = 0x1234U,
+                                   .strategy    = parallel_strategy::samples,
+                                   .ray_streams = 2};
+    std::vector<std::uint8_t> const r{1, 2, 3, 4};
+    std::vector<std::uint8_t> const g{5, 6, 7, 8};
+    std::vector<std::uint8_t> const b{9, 10, 11, 12};
+    std::vector<float> linear(12);
+    for (std::size_t i = 0; i < linear.size(); ++i) {
+      linear[i] = static_cast<float>(i) * 0.25F;
+    }
+    write_checkpoint(filename, header, r, g, b, linear);
+    EXPECT_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+    auto const state = read_checkpoint(filename);
+    EXPECT_EQ(state.header.width, 2);
+    EXPECT_EQ(state.header.height, 4);
+    EXPECT_EQ(state.header.band_height, 2);
+    EXPECT_EQ(state.header.rows_done, 2);
+    EXPECT_EQ(state.header.fingerprint, 0x1234U);
+    EXPECT_EQ(state.header.strategy, parallel_strategy::samples);
+    EXPECT_EQ(state.header.ray_streams, 2);
+    EXPECT_EQ(state.r, r);
+    EXPECT_EQ(state.g, g);
+    EXPECT_EQ(state.b, b);
+    EXPECT_EQ(state.linear, linear);
+
+    // Un punto de control posterior reemplaza al anterior
+    write_checkpoint(filename, checkpoint_header{.width = 2, .height = 4, .band_height = 2},
+                     {}, {}, {}, {});
+    auto const empty = read_checkpoint(filename);
+    EXPECT_EQ(empty.header.rows_done, 0);
+    EXPECT_EQ(empty.header.strategy, parallel_strategy::rows);
+    EXPECT_EQ(empty.header.ray_streams, 1);
+    EXPECT_TRUE(empty.r.empty());
+    EXPECT_TRUE(empty.linear.empty());
+    std::filesystem::remove(filename);
+  }
+
+  TEST(CheckpointTest, RejectsMismatchedSizes) {
+    checkpoint_header const header{.width = 2, .height = 2, .band_height = 1, .rows_done = 1};
+    std::array<std::uint8_t, 2> const channel{};
+    std::array<std::uint8_t, 1> const short_channel{};
+    std::array<float, 5> const short_linear{};
+    EXPECT_THROW(write_checkpoint("unused.ckpt", header, channel, short_channel, channel, {}),
+                 std::invalid_argument);
+    EXPECT_THROW(write_checkpoint("unused.ckpt", header, channel, channel, channel, short_linear),
+                 std::invalid_argument);
+    EXPECT_FALSE(std::filesystem::exists("unused.ckpt"));
+  }
+
+  TEST(CheckpointTest, RejectsInvalidFiles) {
+    std::string const filename = "temp_checkpoint_test.ckpt";
+    EXPECT_THROW((void) read_checkpoint("non_existent.ckpt"), std::runtime_error);
+    write_text(filename, "P6\n2 2\n255\n");
+    EXPECT_THROW((void) read_checkpoint(filename), std::runtime_error);
+
+    // Truncado: la cabecera promete más filas de las que hay
+    std::array<std::uint8_t, 2> const channel{};
+    write_checkpoint(filename, checkpoint_header{.width = 2, .height = 2, .band_height = 1,
+                                                 .rows_done = 1},
+                     channel, channel, channel, {});
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 1);
+    EXPECT_THROW((void) read_checkpoint(filename), std::runtime_error);
+    std::filesystem::remove(filename);
+  }
+
+  TEST(CheckpointTest, FingerprintDependsOnContents) {
+    std::array<std::string, 2> const files{"temp_fingerprint_a.txt", "temp_fingerprint_b.txt"};
+    write_text(files[0], "image_width: 64\n");
+    write_text(files[1], "sphere: 0 0 0 1 mat\n");
+    auto const first = fingerprint_files(files);
+    EXPECT_EQ(fingerprint_files(files), first);
+    write_text(files[1], "sphere: 0 0 0 2 mat\n");
+    EXPECT_NE(fingerprint_files(files), first);
+    EXPECT_THROW((void) fingerprint_files(std::array<std::string, 1>{"non_existent.txt"}),
+                 std::runtime_error);
+    std::filesystem::remove(files[0]);
+    std::filesystem::remove(files[1]);
+    EXPECT_EQ(checkpoint_path_for("out/frame.ppm"), "out/frame.ppm.ckpt");
+  }
+
+  TEST(CheckpointTest, FingerprintIsStableAcrossReadBlocks) {
+    // FNV-1a de los bytes seguido del separador de fichero; las huellas de puntos de control ya
+    // guardados deben seguir valiendo
+    write_text("temp_fingerprint_a.txt", "a");
+    EXPECT_EQ(fingerprint_files(std::array<std::string, 1>{"temp_fingerprint_a.txt"}),
+              0x089b'c907'b544'c769ULL);
+
+    // Un fichero de más de un bloque de lectura
+    std::string large(3 * (std::size_t{1} << 19U) + 5, '\0');
+    for (std::size_t i = 0; i < large.size(); ++i) {
+      large[i] = static_cast<char>((i * 7) & 0xFFU);
+    }
+    write_text("temp_fingerprint_a.txt", large);
+    EXPECT_EQ(fingerprint_files(std::array<std::string, 1>{"temp_fingerprint_a.txt"}),
+              0xe66a'ca03'09d0'c60cULL);
+    std::filesystem::remove("temp_fingerprint_a.txt");
+  }
+
+}  // namespace render
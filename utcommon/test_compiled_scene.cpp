@@ -0,0 +1,210 @@
+#include "compiled_scene.hpp"
+#include "material.hpp"
+#include "object.hpp"
+#include "scene.hpp"
+#include "scene_parser.hpp"
+#include "vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    void write_text_scene(std::string const & filename) {
+      std::ofstream out(filename);
+      out << "matte: gray 0.5 0.5 0.5\n"
+          << "metal: mirror 0.9 0.8 0.7 0.1\n"
+          << "refractive: glass 1.5\n"
+          << "sphere: 0 0 -2 1 gray\n"
+          << "cylinder: 1 2 3 0.5 0 2 0 glass\n"
+          << "sphere: -1 0.5 -3 0.25 mirror\n";
+    }
+
+    void expect_vector(vector const & actual, vector const & expected) {
+      EXPECT_DOUBLE_EQ(actual.x, expected.x);
+      EXPECT_DOUBLE_EQ(actual.y, expected.y);
+      EXPECT_DOUBLE_EQ(actual.z, expected.z);
+    }
+
+    std::vector<char> read_bytes(std::string const & filename) {
+      std::ifstream in(filename, std::ios::binary);
+      return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    void write_bytes(std::string const & filename, std::vector<char> const & bytes) {
+      std::ofstream out(filename, std::ios::binary);
+      out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+  }  // namespace
+
+  TEST(CompiledSceneTest, RoundTripKeepsMaterialsAndObjectsInOrder) {
+    write_text_scene("temp_compiled.txt");
+    scene original;
+    parse_scene_file("temp_compiled.txt", original);
+    write_compiled_scene("temp_compiled.bin", original);
+
+    scene loaded;
+    load_compiled_scene("temp_compiled.bin", loaded);
+    ASSERT_EQ(loaded.material_count(), 3U);
+    ASSERT_EQ(loaded.get_objects().size(), 3U);
+
+    auto const * mirror = dynamic_cast<metal_material const *>(loaded.get_material("mirror"));
+    ASSERT_NE(mirror, nullptr);
+    expect_vector(mirror->get_reflectance(), {0.9, 0.8, 0.7});
+    EXPECT_DOUBLE_EQ(mirror->get_diffusion(), 0.1);
+    auto const * glass = dynamic_cast<refractive_material const *>(loaded.get_material("glass"));
+    ASSERT_NE(glass, nullptr);
+    EXPECT_DOUBLE_EQ(glass->get_refraction_index(), 1.5);
+
+    auto const & objects = loaded.get_objects();
+    EXPECT_EQ(objects[0]->get_type(), "sphere");
+    EXPECT_EQ(objects[0]->get_material(), loaded.get_material("gray"));
+    auto const * cyl = dynamic_cast<cylinder const *>(objects[1].get());
+    ASSERT_NE(cyl, nullptr);
+    expect_vector(cyl->get_center(), {1.0, 2.0, 3.0});
+    expect_vector(cyl->get_axis(), {0.0, 2.0, 0.0});
+    EXPECT_DOUBLE_EQ(cyl->get_radius(), 0.5);
+    EXPECT_EQ(cyl->get_material(), loaded.get_material("glass"));
+    expect_vector(objects[2]->get_center(), {-1.0, 0.5, -3.0});
+    EXPECT_EQ(objects[2]->get_material(), loaded.get_material("mirror"));
+
+    std::filesystem::remove("temp_compiled.txt");
+    std::filesystem::remove("temp_compiled.bin");
+  }
+
+  TEST(CompiledSceneTest, LoadSceneFileDetectsFormat) {
+    write_text_scene("temp_compiled.txt");
+    scene original;
+    parse_scene_file("temp_compiled.txt", original);
+    write_compiled_scene("temp_compiled.bin", original);
+
+    EXPECT_FALSE(is_compiled_scene("temp_compiled.txt"));
+    EXPECT_TRUE(is_compiled_scene("temp_compiled.bin"));
+    EXPECT_FALSE(is_compiled_scene("temp_compiled_missing.bin"));
+
+    scene from_text;
+    load_scene_file("temp_compiled.txt", from_text);
+    scene from_binary;
+    load_scene_file("temp_compiled.bin", from_binary);
+    EXPECT_EQ(from_text.get_objects().size(), from_binary.get_objects().size());
+    EXPECT_EQ(from_text.material_count(), from_binary.material_count());
+
+    std::filesystem::remove("temp_compiled.txt");
+    std::filesystem::remove("temp_compiled.bin");
+  }
+
+  TEST(CompiledSceneTest, EmptySceneRoundTrip) {
+    scene const empty;
+    write_compiled_scene("temp_compiled_empty.bin", empty);
+    scene loaded;
+    load_compiled_scene("temp_compiled_empty.bin", loaded);
+    EXPECT_EQ(loaded.material_count(), 0U);
+    EXPECT_EQ(loaded.get_objects().size(), 0U);
+    std::filesystem::remove("temp_compiled_empty.bin");
+  }
+
+  TEST(CompiledSceneTest, RejectsTruncatedFile) {
+    write_text_scene("temp_compiled.txt");
+    scene original;
+    parse_scene_file("temp_compiled.txt", original);
+    write_compiled_scene("temp_compiled.bin", original);
+
+    auto bytes = read_bytes("temp_compiled.bin");
+    bytes.resize(bytes.size() - 8);
+    write_bytes("temp_compiled.bin", bytes);
+    scene loaded;
+    EXPECT_THROW(load_compiled_scene("temp_compiled.bin", loaded), std::runtime_error);
+
+    bytes.resize(16);
+    write_bytes("temp_compiled.bin", bytes);
+    EXPECT_THROW(load_compiled_scene("temp_compiled.bin", loaded), std::runtime_error);
+
+    std::filesystem::remove("temp_compiled.txt");
+    std::filesystem::remove("temp_compiled.bin");
+  }
+
+  TEST(CompiledSceneTest, RejectsOtherVersionAndBadMagic) {
+    write_text_scene("temp_compiled.txt");
+    scene original;
+    parse_scene_file("temp_compiled.txt", original);
+    write_compiled_scene("temp_compiled.bin", original);
+    auto const bytes = read_bytes("temp_compiled.bin");
+
+    // La versión va justo después de la firma
+    auto other_version = bytes;
+    other_version[compiled_scene_magic.size()] += 1;
+    write_bytes("temp_compiled.bin", other_version);
+    scene loaded;
+    EXPECT_THROW(load_compiled_scene("temp_compiled.bin", loaded), std::runtime_error);
+
+    auto bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write_bytes("temp_compiled.bin", bad_magic);
+    EXPECT_FALSE(is_compiled_scene("temp_compiled.bin"));
+    EXPECT_THROW(load_compiled_scene("temp_compiled.bin", loaded), std::runtime_error);
+
+    std::filesystem::remove("temp_compiled.txt");
+    std::filesystem::remove("temp_compiled.bin");
+  }
+
+  TEST(CompiledSceneTest, RejectsValuesTheTextParserRejects) {
+    // Cada valor de la escena es único, así que se puede localizar en el fichero compilado
+    {
+      std::ofstream out("temp_compiled.txt");
+      out << "matte: gray 0.125 0.25 0.375\n"
+          << "metal: mirror 0.9 0.8 0.7 0.0625\n"
+          << "refractive: glass 1.5\n"
+          << "sphere: 0 0 -3 0.75 gray\n"
+          << "cylinder: 4 5 6 0.5 0 2 0 glass\n";
+    }
+    scene original;
+    parse_scene_file("temp_compiled.txt", original);
+    write_compiled_scene("temp_compiled.bin", original);
+    auto const bytes = read_bytes("temp_compiled.bin");
+
+    double const nan = std::numeric_limits<double>::quiet_NaN();
+    double const inf = std::numeric_limits<double>::infinity();
+    std::vector<std::pair<double, double>> const cases{
+        {0.125, 1.25},  {0.125, nan}, {0.0625, -0.1}, {0.0625, inf}, {1.5, 0.0},
+        {0.75, 0.0},    {0.75, nan},  {-3.0, inf},    {0.5, -1.0},   {2.0, 0.0},
+    };
+    for (auto const & [from, to] : cases) {
+      auto patched = bytes;
+      std::array<char, sizeof(double)> pattern{};
+      std::memcpy(pattern.data(), &from, sizeof(double));
+      auto const found = std::ranges::search(patched, pattern).begin();
+      ASSERT_NE(found, patched.end()) << from;
+      ASSERT_TRUE(std::ranges::search(found + 1, patched.end(), pattern.begin(), pattern.end())
+                      .empty())
+          << from;
+      std::memcpy(&*found, &to, sizeof(double));
+      write_bytes("temp_compiled.bin", patched);
+
+      scene loaded;
+      try {
+        load_compiled_scene("temp_compiled.bin", loaded);
+        ADD_FAILURE() << from << " -> " << to << " aceptado";
+      } catch (std::runtime_error const & e) {
+        EXPECT_NE(std::string{e.what()}.find("Corrupt compiled scene file"), std::string::npos)
+            << from << " -> " << to << ": " << e.what();
+      }
+    }
+
+    std::filesystem::remove("temp_compiled.txt");
+    std::filesystem::remove("temp_compiled.bin");
+  }
+
+}  // namespace render
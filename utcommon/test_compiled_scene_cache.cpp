@@ -0,0 +1,126 @@
+#include "compiled_scene_cache.hpp"
+#include "checkpoint.hpp"
+#include "compiled_scene.hpp"
+#include "scene.hpp"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace render {
+
+  // Cada prueba usa su propia escena y su propio directorio, para poder ejecutarlas en paralelo
+
+  TEST(CompiledSceneCacheTest, MissThenHit) {
+    std::string const path = "temp_cache_miss_hit.txt";
+    std::string const dir  = "temp_cache_miss_hit";
+    std::filesystem::remove_all(dir);
+    std::ofstream{path} << "matte: gray 0.5 0.5 0.5\n"
+                        << "sphere: 0 0 -2 1 gray\n"
+                        << "cylinder: 1 0 -3 0.5 0 1 0 gray\n";
+
+    scene first;
+    EXPECT_EQ(load_scene_cached(path, dir, first), scene_cache_status::miss);
+    auto const entry = compiled_scene_cache_path(dir, fingerprint_files(std::array{path}));
+    EXPECT_TRUE(is_compiled_scene(entry));
+
+    scene second;
+    EXPECT_EQ(load_scene_cached(path, dir, second), scene_cache_status::hit);
+    EXPECT_EQ(second.get_objects().size(), first.get_objects().size());
+    EXPECT_DOUBLE_EQ(second.get_objects()[0]->get_radius(), 1.0);
+
+    // Un cambio en la escena da otra huella y otra entrada
+    std::ofstream{path} << "matte: gray 0.5 0.5 0.5\n"
+                        << "sphere: 0 0 -2 2 gray\n";
+    scene changed;
+    EXPECT_EQ(load_scene_cached(path, dir, changed), scene_cache_status::miss);
+    EXPECT_DOUBLE_EQ(changed.get_objects()[0]->get_radius(), 2.0);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(dir);
+  }
+
+  TEST(CompiledSceneCacheTest, OffWithoutDirectory) {
+    std::string const path = "temp_cache_off.txt";
+    std::ofstream{path} << "matte: gray 0.5 0.5 0.5\n"
+                        << "sphere: 0 0 -2 1 gray\n";
+    scene scn;
+    EXPECT_EQ(load_scene_cached(path, "", scn), scene_cache_status::off);
+    EXPECT_EQ(scn.get_objects().size(), 1U);
+    std::filesystem::remove(path);
+  }
+
+  TEST(CompiledSceneCacheTest, DamagedEntryIsRebuilt) {
+    std::string const path = "temp_cache_damaged.txt";
+    std::string const dir  = "temp_cache_damaged";
+    std::filesystem::remove_all(dir);
+    std::ofstream{path} << "matte: gray 0.5 0.5 0.5\n"
+                        << "sphere: 0 0 -2 1 gray\n"
+                        << "cylinder: 1 0 -3 0.5 0 1 0 gray\n";
+    scene first;
+    (void) load_scene_cached(path, dir, first);
+    auto const entry = compiled_scene_cache_path(dir, fingerprint_files(std::array{path}));
+    std::filesystem::resize_file(entry, std::filesystem::file_size(entry) - 4);
+
+    scene again;
+    EXPECT_EQ(load_scene_cached(path, dir, again), scene_cache_status::miss);
+    EXPECT_EQ(again.get_objects().size(), 2U);
+    scene rebuilt;
+    EXPECT_EQ(load_scene_cached(path, dir, rebuilt), scene_cache_status::hit);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(dir);
+  }
+
+  TEST(CompiledSceneCacheTest, EntryFromAnotherSourceIsRebuilt) {
+    std::string const path  = "temp_cache_source.txt";
+    std::string const other = "temp_cache_source_other.txt";
+    std::string const dir   = "temp_cache_source";
+    std::filesystem::remove_all(dir);
+    std::ofstream{path} << "matte: gray 0.5 0.5 0.5\n"
+                        << "sphere: 0 0 -2 1 gray\n";
+    auto const fingerprint = fingerprint_files(std::array{path});
+    auto const entry       = compiled_scene_cache_path(dir, fingerprint);
+
+    // Entrada con el nombre esperado pero compilada a partir de otra escena
+    std::ofstream{other} << "matte: gray 0.5 0.5 0.5\n"
+                         << "sphere: 0 0 -2 3 gray\n";
+    scene other_scene;
+    load_scene_file(other, other_scene);
+    std::filesystem::create_directories(dir);
+    write_compiled_scene(entry, other_scene, fingerprint + 1);
+
+    scene loaded;
+    EXPECT_EQ(load_scene_cached(path, dir, loaded), scene_cache_status::miss);
+    EXPECT_DOUBLE_EQ(loaded.get_objects()[0]->get_radius(), 1.0);
+    EXPECT_EQ(compiled_scene_source(entry), fingerprint);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(other);
+    std::filesystem::remove_all(dir);
+  }
+
+  TEST(CompiledSceneCacheTest, StoreFailureKeepsLoading) {
+    std::string const path = "temp_cache_store.txt";
+    std::string const dir  = "temp_cache_store_file";
+    std::ofstream{path} << "matte: gray 0.5 0.5 0.5\n"
+                        << "sphere: 0 0 -2 1 gray\n";
+    // Un fichero normal en lugar del directorio hace fallar la escritura de la entrada
+    std::ofstream{dir} << "no es un directorio\n";
+
+    scene scn;
+    EXPECT_EQ(load_scene_cached(path, dir, scn), scene_cache_status::miss);
+    EXPECT_EQ(scn.get_objects().size(), 1U);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(dir);
+  }
+
+  TEST(CompiledSceneCacheTest, PathCarriesFormatVersion) {
+    auto const path = compiled_scene_cache_path("cache", 0xabcU);
+    EXPECT_EQ(path, "cache/scene-0000000000000abc-v" + std::to_string(compiled_scene_version) +
+                        ".bin");
+  }
+
+}  // namespace render
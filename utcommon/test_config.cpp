@@ -685,6 +685,312 @@ namespace render {
     EXPECT_EQ(cfg.get_grain_size(), 1'000);
   }
 
+  // Pruebas de la estrategia de paralelización
+  TEST(ConfigDefaultTest, ParallelStrategy) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_parallel_strategy(), "auto");
+  }
+
+  TEST(ConfigLoadTest, ParallelStrategyRows) {
+    TempConfigFile const temp_file("parallel_strategy: rows\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_parallel_strategy(), "rows");
+  }
+
+  TEST(ConfigLoadTest, ParallelStrategySamples) {
+    TempConfigFile const temp_file("parallel_strategy: samples\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_parallel_strategy(), "samples");
+  }
+
+  TEST(ConfigValidationTest, ParallelStrategyInvalid) {
+    TempConfigFile const temp_file("parallel_strategy: pixels\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigParsingTest, ParallelStrategyNoArgs) {
+    TempConfigFile const temp_file("parallel_strategy:\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // Pruebas del modo NUMA
+  TEST(ConfigDefaultTest, NumaModes) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_numa(), "off");
+    EXPECT_EQ(cfg.get_numa_scene(), "shared");
+  }
+
+  TEST(ConfigLoadTest, NumaReplicated) {
+    TempConfigFile const temp_file("numa: on\nnuma_scene: replicated\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_numa(), "on");
+    EXPECT_EQ(cfg.get_numa_scene(), "replicated");
+  }
+
+  TEST(ConfigValidationTest, NumaInvalid) {
+    TempConfigFile const temp_file("numa: auto\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigValidationTest, NumaSceneInvalid) {
+    TempConfigFile const temp_file("numa_scene: copied\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // Pruebas de la altura de banda del pipeline
+  TEST(ConfigDefaultTest, TileHeight) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_tile_height(), 16);
+  }
+
+  TEST(ConfigLoadTest, TileHeight) {
+    TempConfigFile const temp_file("tile_height: 8\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_tile_height(), 8);
+  }
+
+  TEST(ConfigValidationTest, TileHeightZero) {
+    TempConfigFile const temp_file("tile_height: 0\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // Pruebas del planificador de tiles
+  TEST(ConfigDefaultTest, Scheduler) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_scheduler(), "tbb");
+  }
+
+  TEST(ConfigLoadTest, Scheduler) {
+    TempConfigFile const temp_file("scheduler: worksteal\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_scheduler(), "worksteal");
+  }
+
+  TEST(ConfigValidationTest, SchedulerInvalid) {
+    TempConfigFile const temp_file("scheduler: fifo\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // Pruebas de afinidad de hilos y flujos de rayos intercalados
+  TEST(ConfigDefaultTest, ThreadAffinityAndRayStreams) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_thread_affinity(), "none");
+    EXPECT_EQ(cfg.get_ray_streams(), 1);
+  }
+
+  TEST(ConfigLoadTest, ThreadAffinityAndRayStreams) {
+    TempConfigFile const temp_file("thread_affinity: cores\nray_streams: 2\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_thread_affinity(), "cores");
+    EXPECT_EQ(cfg.get_ray_streams(), 2);
+  }
+
+  TEST(ConfigValidationTest, ThreadAffinityInvalid) {
+    TempConfigFile const temp_file("thread_affinity: numa\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigValidationTest, RayStreamsOutOfRange) {
+    TempConfigFile const temp_file("ray_streams: 3\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // Pruebas del formato de salida
+  TEST(ConfigDefaultTest, OutputFormat) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_output_format(), "auto");
+  }
+
+  TEST(ConfigLoadTest, OutputFormat) {
+    TempConfigFile const temp_file("output_format: p6\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_output_format(), "p6");
+  }
+
+  TEST(ConfigLoadTest, OutputFormatQoi) {
+    TempConfigFile const temp_file("output_format: qoi\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_output_format(), "qoi");
+  }
+
+  TEST(ConfigValidationTest, OutputFormatInvalid) {
+    TempConfigFile const temp_file("output_format: png\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigDefaultTest, Framebuffer) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_framebuffer(), "ldr");
+  }
+
+  TEST(ConfigLoadTest, Framebuffer) {
+    TempConfigFile const temp_file("framebuffer: hdr\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_framebuffer(), "hdr");
+  }
+
+  TEST(ConfigValidationTest, FramebufferInvalid) {
+    TempConfigFile const temp_file("framebuffer: float\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigDefaultTest, StreamWindow) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_stream_window(), 0);
+  }
+
+  TEST(ConfigLoadTest, StreamWindow) {
+    TempConfigFile const temp_file("stream_window: 8\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_stream_window(), 8);
+  }
+
+  TEST(ConfigValidationTest, StreamWindowNegative) {
+    TempConfigFile const temp_file("stream_window: -1\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigDefaultTest, MmapOutput) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_mmap_output(), "off");
+  }
+
+  TEST(ConfigLoadTest, MmapOutput) {
+    TempConfigFile const temp_file("mmap_output: on\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_mmap_output(), "on");
+  }
+
+  TEST(ConfigValidationTest, MmapOutputInvalid) {
+    TempConfigFile const temp_file("mmap_output: yes\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigDefaultTest, CheckpointInterval) {
+    config const cfg;
+    EXPECT_DOUBLE_EQ(cfg.get_checkpoint_interval(), 0.0);
+  }
+
+  TEST(ConfigLoadTest, CheckpointInterval) {
+    TempConfigFile const temp_file("checkpoint_interval: 30.5\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_DOUBLE_EQ(cfg.get_checkpoint_interval(), 30.5);
+  }
+
+  TEST(ConfigValidationTest, CheckpointIntervalNegative) {
+    TempConfigFile const temp_file("checkpoint_interval: -1\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // apply_config_text cambia solo las claves que aparecen en el texto
+  TEST(ConfigLoadTest, ApplyConfigTextOverridesKeys) {
+    TempConfigFile const temp_file("samples_per_pixel: 4\ngamma: 2.0\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    ASSERT_NO_THROW(apply_config_text("samples_per_pixel: 16\n\nimage_width: 64", cfg));
+    EXPECT_EQ(cfg.get_samples_per_pixel(), 16);
+    EXPECT_EQ(cfg.get_image_width(), 64);
+    EXPECT_DOUBLE_EQ(cfg.get_gamma(), 2.0);
+    EXPECT_THROW(apply_config_text("unknown_key: 1\n", cfg), std::runtime_error);
+    EXPECT_THROW(apply_config_text("samples_per_pixel: 0\n", cfg), std::runtime_error);
+  }
+
+  TEST(ConfigDefaultTest, FrameCount) {
+    config const cfg;
+    EXPECT_EQ(cfg.get_frame_count(), 1);
+    EXPECT_TRUE(cfg.get_camera_keyframes().empty());
+  }
+
+  TEST(ConfigLoadTest, FrameCount) {
+    TempConfigFile const temp_file("frame_count: 48\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_frame_count(), 48);
+  }
+
+  TEST(ConfigValidationTest, FrameCountZero) {
+    TempConfigFile const temp_file("frame_count: 0\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigLoadTest, CameraKeyframes) {
+    TempConfigFile const temp_file("camera_keyframe: 0 0 0 -10 0 0 0 0 1 0 90\n"
+                                   "camera_keyframe: 24 10 0 0 0 1 0 0 1 0 60\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    auto const & keys = cfg.get_camera_keyframes();
+    ASSERT_EQ(keys.size(), 2U);
+    EXPECT_DOUBLE_EQ(keys[1].time, 24.0);
+    EXPECT_DOUBLE_EQ(keys[1].position.x, 10.0);
+    EXPECT_DOUBLE_EQ(keys[1].target.y, 1.0);
+    EXPECT_DOUBLE_EQ(keys[1].north.y, 1.0);
+    EXPECT_DOUBLE_EQ(keys[1].field_of_view, 60.0);
+  }
+
+  TEST(ConfigValidationTest, CameraKeyframeWrongCount) {
+    TempConfigFile const temp_file("camera_keyframe: 0 0 0 -10 0 0 0 0 1 0\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  // Los fotogramas clave deben ir en orden de tiempo estrictamente creciente
+  TEST(ConfigValidationTest, CameraKeyframeOutOfOrder) {
+    TempConfigFile const temp_file("camera_keyframe: 5 0 0 -10 0 0 0 0 1 0 90\n"
+                                   "camera_keyframe: 5 0 0 -9 0 0 0 0 1 0 90\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigValidationTest, CameraKeyframeInvalidFieldOfView) {
+    TempConfigFile const temp_file("camera_keyframe: 0 0 0 -10 0 0 0 0 1 0 180\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
+  TEST(ConfigDefaultTest, SceneCacheDir) {
+    config const cfg;
+    EXPECT_TRUE(cfg.get_scene_cache_dir().empty());
+  }
+
+  TEST(ConfigLoadTest, SceneCacheDir) {
+    TempConfigFile const temp_file("scene_cache_dir: /tmp/render-cache\n");
+    config cfg;
+    ASSERT_NO_THROW(load_config(temp_file.get_filename(), cfg));
+    EXPECT_EQ(cfg.get_scene_cache_dir(), "/tmp/render-cache");
+  }
+
+  TEST(ConfigValidationTest, SceneCacheDirMissingValue) {
+    TempConfigFile const temp_file("scene_cache_dir:\n");
+    config cfg;
+    EXPECT_THROW(load_config(temp_file.get_filename(), cfg), std::runtime_error);
+  }
+
   // Prueba de configuración completa incluyendo parámetros TBB
   TEST(ConfigLoadTest, AllParametersWithTBB) {
     TempConfigFile const temp_file("aspect_ratio: 21 9\n"
@@ -0,0 +1,89 @@
+#include "cpu_topology.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Helper que crea un árbol sysfs falso con la topología de cada CPU
+  class FakeSysfs {
+  public:
+    FakeSysfs() : root{std::filesystem::temp_directory_path() / "render_fake_sysfs"} {
+      std::filesystem::remove_all(root);
+    }
+
+    ~FakeSysfs() {
+      std::error_code ec;
+      std::filesystem::remove_all(root, ec);
+    }
+
+    // Eliminar copia
+    FakeSysfs(FakeSysfs const &)             = delete;
+    FakeSysfs & operator=(FakeSysfs const &) = delete;
+
+    // Eliminar movimiento
+    FakeSysfs(FakeSysfs &&)             = delete;
+    FakeSysfs & operator=(FakeSysfs &&) = delete;
+
+    void add_cpu(int cpu, int package, int core) const {
+      auto const dir = root / ("cpu" + std::to_string(cpu)) / "topology";
+      std::filesystem::create_directories(dir);
+      std::ofstream(dir / "physical_package_id") << package << '\n';
+      std::ofstream(dir / "core_id") << core << '\n';
+    }
+
+    [[nodiscard]] std::filesystem::path const & get_root() const { return root; }
+
+  private:
+    std::filesystem::path root;
+  };
+
+  // Pruebas de parse_cpu_list
+  TEST(CpuTopologyTest, ParseCpuListRangesAndSingles) {
+    EXPECT_EQ(parse_cpu_list("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(parse_cpu_list("").empty());
+  }
+
+  TEST(CpuTopologyTest, ParseCpuListRejectsMalformed) {
+    EXPECT_THROW(static_cast<void>(parse_cpu_list("1-")), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(parse_cpu_list("3-1")), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(parse_cpu_list("a")), std::runtime_error);
+  }
+
+  // Dos núcleos con dos hermanas SMT cada uno (numeración al estilo Intel: 0,2 y 1,3)
+  TEST(CpuTopologyTest, GroupsSiblingsByCore) {
+    FakeSysfs const sysfs;
+    sysfs.add_cpu(0, 0, 0);
+    sysfs.add_cpu(1, 0, 1);
+    sysfs.add_cpu(2, 0, 0);
+    sysfs.add_cpu(3, 0, 1);
+
+    std::vector<int> const allowed{0, 1, 2, 3};
+    auto const cores = read_cpu_topology(sysfs.get_root(), allowed);
+    ASSERT_EQ(cores.size(), 2U);
+    EXPECT_EQ(cores[0].cpus, (std::vector<int>{0, 2}));
+    EXPECT_EQ(cores[1].cpus, (std::vector<int>{1, 3}));
+
+    EXPECT_EQ(affinity_plan(cores, "cores"), (std::vector<int>{0, 1}));
+    EXPECT_EQ(affinity_plan(cores, "smt"), (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_TRUE(affinity_plan(cores, "none").empty());
+  }
+
+  // Sólo se consideran las CPU permitidas y las que no tienen topología son núcleos propios
+  TEST(CpuTopologyTest, HonoursAllowedCpusAndMissingTopology) {
+    FakeSysfs const sysfs;
+    sysfs.add_cpu(0, 0, 0);
+    sysfs.add_cpu(1, 0, 0);
+    sysfs.add_cpu(2, 1, 0);
+
+    std::vector<int> const allowed{1, 2, 7};
+    auto const cores = read_cpu_topology(sysfs.get_root(), allowed);
+    ASSERT_EQ(cores.size(), 3U);
+    EXPECT_EQ(affinity_plan(cores, "cores"), (std::vector<int>{7, 1, 2}));
+  }
+
+}  // namespace render
@@ -0,0 +1,141 @@
+#include "color.hpp"
+#include "hdr_image.hpp"
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    std::string read_binary(std::string const & filename) {
+      std::ifstream file(filename, std::ios::binary);
+      return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    void write_binary(std::string const & filename, std::string const & bytes) {
+      std::ofstream file(filename, std::ios::binary);
+      file << bytes;
+    }
+
+  }  // namespace
+
+  TEST(HdrImageTest, SetAndGetPixel) {
+    hdr_image image{3, 2};
+    image.set_pixel(2, 1, color{0.25, 1.5, -0.125});
+    color const value = image.get_pixel(2, 1);
+    EXPECT_DOUBLE_EQ(value.get_r(), 0.25);
+    EXPECT_DOUBLE_EQ(value.get_g(), 1.5);
+    EXPECT_DOUBLE_EQ(value.get_b(), -0.125);
+    EXPECT_DOUBLE_EQ(image.get_pixel(0, 0).get_r(), 0.0);
+    EXPECT_THROW(image.set_pixel(3, 0, color{}), std::out_of_range);
+    EXPECT_THROW((void) image.get_pixel(0, 2), std::out_of_range);
+  }
+
+  TEST(HdrImageTest, SetRowsAndGetRows) {
+    hdr_image image{2, 3};
+    std::vector<color> const rows{color{1, 2, 3}, color{4, 5, 6}, color{7, 8, 9},
+                                  color{10, 11, 12}};
+    image.set_rows(1, rows);
+    std::vector<color> out(4);
+    image.get_rows(1, 3, out);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      EXPECT_DOUBLE_EQ(out[i].get_r(), rows[i].get_r());
+      EXPECT_DOUBLE_EQ(out[i].get_b(), rows[i].get_b());
+    }
+    EXPECT_THROW(image.set_rows(2, rows), std::out_of_range);
+    EXPECT_THROW(image.set_rows(0, std::span{rows}.first(3)), std::out_of_range);
+    EXPECT_THROW(image.get_rows(0, 1, out), std::out_of_range);
+  }
+
+  // La primera línea de datos del PFM es la fila inferior de la imagen
+  TEST(HdrImageTest, WriteAndReadPfm) {
+    std::string const filename = "temp_hdr_image_test.pfm";
+    hdr_image image{2, 2};
+    image.set_pixel(0, 0, color{1.0, 0.0, 0.0});
+    image.set_pixel(1, 1, color{0.5, 2.0, 3.25});
+    write_pfm(filename, image);
+
+    std::string const bytes = read_binary(filename);
+    std::string const header{"PF\n2 2\n-1.0\n"};
+    ASSERT_EQ(bytes.size(), header.size() + 2 * 2 * 3 * sizeof(float));
+    EXPECT_EQ(bytes.substr(0, header.size()), header);
+
+    hdr_image const loaded = read_pfm(filename);
+    ASSERT_EQ(loaded.get_width(), 2);
+    ASSERT_EQ(loaded.get_height(), 2);
+    EXPECT_DOUBLE_EQ(loaded.get_pixel(0, 0).get_r(), 1.0);
+    EXPECT_DOUBLE_EQ(loaded.get_pixel(1, 1).get_g(), 2.0);
+    EXPECT_DOUBLE_EQ(loaded.get_pixel(1, 1).get_b(), 3.25);
+    std::filesystem::remove(filename);
+  }
+
+  // Un PFM con escala positiva guarda los float en big endian
+  TEST(HdrImageTest, ReadBigEndianPfm) {
+    std::string const filename = "temp_hdr_image_test.pfm";
+    // 1.0f = 0x3F800000, 2.0f = 0x40000000, 0.5f = 0x3F000000
+    write_binary(filename, std::string{"PF\n1 1\n1.0\n"} +
+                               std::string{'\x3F', '\x80', '\x00', '\x00', '\x40', '\x00',
+                                           '\x00', '\x00', '\x3F', '\x00', '\x00', '\x00'});
+    hdr_image const loaded = read_pfm(filename);
+    color const value      = loaded.get_pixel(0, 0);
+    EXPECT_DOUBLE_EQ(value.get_r(), 1.0);
+    EXPECT_DOUBLE_EQ(value.get_g(), 2.0);
+    EXPECT_DOUBLE_EQ(value.get_b(), 0.5);
+    std::filesystem::remove(filename);
+  }
+
+  TEST(HdrImageTest, ReadPfmRejectsInvalidFiles) {
+    std::string const filename = "temp_hdr_image_test.pfm";
+    write_binary(filename, "Pf\n1 1\n-1.0\n");
+    EXPECT_THROW((void) read_pfm(filename), std::runtime_error);
+    write_binary(filename, std::string{"PF\n1 1\n-1.0\n"} + std::string(5, '\0'));
+    EXPECT_THROW((void) read_pfm(filename), std::runtime_error);
+    std::filesystem::remove(filename);
+    EXPECT_THROW((void) read_pfm("/non_existent_directory/test.pfm"), std::runtime_error);
+  }
+
+  // La mezcla pondera cada render por sus muestras
+  TEST(HdrImageTest, MergeIsWeightedAverage) {
+    std::array<hdr_image, 2> images{hdr_image{1, 1}, hdr_image{1, 1}};
+    images[0].set_pixel(0, 0, color{1.0, 0.0, 0.5});
+    images[1].set_pixel(0, 0, color{0.0, 1.0, 0.5});
+    std::array<double, 2> const weights{96.0, 32.0};
+    hdr_image const merged = merge_hdr(images, weights);
+    EXPECT_DOUBLE_EQ(merged.get_pixel(0, 0).get_r(), 0.75);
+    EXPECT_DOUBLE_EQ(merged.get_pixel(0, 0).get_g(), 0.25);
+    EXPECT_DOUBLE_EQ(merged.get_pixel(0, 0).get_b(), 0.5);
+
+    std::array<hdr_image, 2> const mismatched{hdr_image{1, 1}, hdr_image{2, 1}};
+    EXPECT_THROW((void) merge_hdr(mismatched, weights), std::invalid_argument);
+    EXPECT_THROW((void) merge_hdr(images, std::span{weights}.first(1)), std::invalid_argument);
+  }
+
+  TEST(HdrImageTest, ParseWeightedHdr) {
+    auto const plain = parse_weighted_hdr("parcial.pfm");
+    EXPECT_EQ(plain.path, "parcial.pfm");
+    EXPECT_DOUBLE_EQ(plain.weight, 1.0);
+
+    auto const weighted = parse_weighted_hdr("dir@x/parcial.pfm@128");
+    EXPECT_EQ(weighted.path, "dir@x/parcial.pfm");
+    EXPECT_DOUBLE_EQ(weighted.weight, 128.0);
+
+    EXPECT_THROW((void) parse_weighted_hdr("parcial.pfm@"), std::invalid_argument);
+    EXPECT_THROW((void) parse_weighted_hdr("parcial.pfm@0"), std::invalid_argument);
+    EXPECT_THROW((void) parse_weighted_hdr("parcial.pfm@12x"), std::invalid_argument);
+  }
+
+  TEST(HdrImageTest, HdrPathFor) {
+    EXPECT_EQ(hdr_path_for("out.ppm"), "out.pfm");
+    EXPECT_EQ(hdr_path_for("dir.v2/out"), "dir.v2/out.pfm");
+    EXPECT_EQ(hdr_path_for("out.pfm"), "out.hdr.pfm");
+    EXPECT_EQ(hdr_path_for("out.pfm.ppm"), "out.pfm.pfm");
+  }
+
+}  // namespace render
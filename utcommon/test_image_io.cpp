@@ -0,0 +1,428 @@
+#include "image_io.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    std::string read_binary(std::string const & filename) {
+      std::ifstream file(filename, std::ios::binary);
+      return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    // P3 de referencia escrito con operator<<, como el save_ppm original
+    std::string reference_p3(int width, int height, std::vector<std::uint8_t> const & r,
+                             std::vector<std::uint8_t> const & g,
+                             std::vector<std::uint8_t> const & b) {
+      std::ostringstream out;
+      out << "P3\n" << width << " " << height << "\n255\n";
+      for (std::size_t i = 0; i < r.size(); ++i) {
+        out << static_cast<int>(r[i]) << " " << static_cast<int>(g[i]) << " "
+            << static_cast<int>(b[i]) << "\n";
+      }
+      return out.str();
+    }
+
+    // Imagen decodificada como bytes RGB intercalados
+    struct decoded_qoi {
+      int width{0};
+      int height{0};
+      std::vector<std::uint8_t> rgb;
+    };
+
+    // Decodificador QOI escrito a partir de la especificación, sin compartir código con el
+    // codificador
+    decoded_qoi decode_qoi(std::string const & data) {
+      auto byte_at = [&](std::size_t const pos) { return static_cast<std::uint8_t>(data.at(pos)); };
+      auto word_at = [&](std::size_t const pos) {
+        return (std::uint32_t{byte_at(pos)} << 24U) | (std::uint32_t{byte_at(pos + 1)} << 16U) |
+               (std::uint32_t{byte_at(pos + 2)} << 8U) | std::uint32_t{byte_at(pos + 3)};
+      };
+      if (data.substr(0, 4) != "qoif") {
+        throw std::runtime_error("decode_qoi: bad magic");
+      }
+      decoded_qoi image{.width  = static_cast<int>(word_at(4)),
+                        .height = static_cast<int>(word_at(8)),
+                        .rgb    = {}};
+      std::size_t const pixels =
+          static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
+
+      using rgba = std::array<std::uint8_t, 4>;
+      std::array<rgba, 64> index{};
+      rgba px{0, 0, 0, 255};
+      auto add = [](std::uint8_t const value, int const delta) {
+        return static_cast<std::uint8_t>(value + delta);
+      };
+
+      std::size_t pos = 14;
+      int run         = 0;
+      while (image.rgb.size() < 3 * pixels) {
+        if (run > 0) {
+          --run;
+        } else {
+          int const b1 = byte_at(pos++);
+          if (b1 == 0xFE) {
+            px = {byte_at(pos), byte_at(pos + 1), byte_at(pos + 2), px[3]};
+            pos += 3;
+          } else if (b1 == 0xFF) {
+            px = {byte_at(pos), byte_at(pos + 1), byte_at(pos + 2), byte_at(pos + 3)};
+            pos += 4;
+          } else if ((b1 & 0xC0) == 0x00) {
+            px = index.at(static_cast<std::size_t>(b1));
+          } else if ((b1 & 0xC0) == 0x40) {
+            px[0] = add(px[0], ((b1 >> 4) & 0x03) - 2);
+            px[1] = add(px[1], ((b1 >> 2) & 0x03) - 2);
+            px[2] = add(px[2], (b1 & 0x03) - 2);
+          } else if ((b1 & 0xC0) == 0x80) {
+            int const b2 = byte_at(pos++);
+            int const dg = (b1 & 0x3F) - 32;
+            px[0]        = add(px[0], dg - 8 + ((b2 >> 4) & 0x0F));
+            px[1]        = add(px[1], dg);
+            px[2]        = add(px[2], dg - 8 + (b2 & 0x0F));
+          } else {
+            run = b1 & 0x3F;
+          }
+          auto const slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+          index.at(static_cast<std::size_t>(slot)) = px;
+        }
+        image.rgb.insert(image.rgb.end(), px.begin(), px.begin() + 3);
+      }
+      if (data.substr(pos) != std::string{"\0\0\0\0\0\0\0\x01", 8}) {
+        throw std::runtime_error("decode_qoi: bad end marker");
+      }
+      return image;
+    }
+
+    // Mezcla de zonas planas, degradados y ruido para ejercitar todas las operaciones QOI
+    void fill_test_image(std::size_t const pixels, std::vector<std::uint8_t> & r,
+                         std::vector<std::uint8_t> & g, std::vector<std::uint8_t> & b) {
+      std::mt19937 rng{5};
+      std::uniform_int_distribution<int> dist(0, 255);
+      r.resize(pixels);
+      g.resize(pixels);
+      b.resize(pixels);
+      for (std::size_t i = 0; i < pixels; ++i) {
+        switch ((i / 500) % 4) {
+          case 0:
+            r[i] = 10;
+            g[i] = 20;
+            b[i] = 30;
+            break;
+          case 1:
+            r[i] = static_cast<std::uint8_t>(i / 3);
+            g[i] = static_cast<std::uint8_t>(i / 5);
+            b[i] = static_cast<std::uint8_t>(i / 7);
+            break;
+          case 2:
+            r[i] = static_cast<std::uint8_t>(dist(rng));
+            g[i] = static_cast<std::uint8_t>(dist(rng));
+            b[i] = static_cast<std::uint8_t>(dist(rng));
+            break;
+          default:
+            r[i] = static_cast<std::uint8_t>(i % 2 == 0 ? 200 : 90);
+            g[i] = static_cast<std::uint8_t>(i % 2 == 0 ? 200 : 95);
+            b[i] = static_cast<std::uint8_t>(i % 3 == 0 ? 0 : 255);
+            break;
+        }
+      }
+    }
+
+    std::vector<std::uint8_t> interleaved(std::vector<std::uint8_t> const & r,
+                                          std::vector<std::uint8_t> const & g,
+                                          std::vector<std::uint8_t> const & b) {
+      std::vector<std::uint8_t> rgb;
+      for (std::size_t i = 0; i < r.size(); ++i) {
+        rgb.insert(rgb.end(), {r[i], g[i], b[i]});
+      }
+      return rgb;
+    }
+
+  }  // namespace
+
+  // El formato explícito manda y "auto" decide por la extensión
+  TEST(ImageIOTest, ResolveImageFormat) {
+    EXPECT_EQ(resolve_image_format("p3", "out.pnm"), image_format::p3);
+    EXPECT_EQ(resolve_image_format("p6", "out.ppm"), image_format::p6);
+    EXPECT_EQ(resolve_image_format("auto", "out.ppm"), image_format::p3);
+    EXPECT_EQ(resolve_image_format("auto", "dir/out.pnm"), image_format::p6);
+    EXPECT_EQ(resolve_image_format("auto", "pnm"), image_format::p3);
+    EXPECT_EQ(resolve_image_format("qoi", "out.ppm"), image_format::qoi);
+    EXPECT_EQ(resolve_image_format("auto", "dir/out.qoi"), image_format::qoi);
+  }
+
+  TEST(ImageIOTest, PpmHeader) {
+    EXPECT_EQ(ppm_header(image_format::p3, 4, 2), "P3\n4 2\n255\n");
+    EXPECT_EQ(ppm_header(image_format::p6, 4, 2), "P6\n4 2\n255\n");
+  }
+
+  TEST(ImageIOTest, InterleaveRgb) {
+    std::array<std::uint8_t, 2> const r{1, 200};
+    std::array<std::uint8_t, 2> const g{2, 201};
+    std::array<std::uint8_t, 2> const b{3, 255};
+    std::string out(6, '\0');
+    interleave_rgb(r, g, b, out);
+    EXPECT_EQ(out, (std::string{'\x01', '\x02', '\x03', '\xC8', '\xC9', '\xFF'}));
+
+    std::string too_small(5, '\0');
+    EXPECT_THROW(interleave_rgb(r, g, b, too_small), std::invalid_argument);
+  }
+
+  // Todos los valores de un byte se codifican igual que con operator<<
+  TEST(ImageIOTest, EncodeP3MatchesStreamForAllValues) {
+    std::vector<std::uint8_t> r(256);
+    std::vector<std::uint8_t> g(256);
+    std::vector<std::uint8_t> b(256);
+    for (std::size_t v = 0; v < 256; ++v) {
+      r[v] = static_cast<std::uint8_t>(v);
+      g[v] = static_cast<std::uint8_t>(255 - v);
+      b[v] = static_cast<std::uint8_t>((v * 7) % 256);
+    }
+    EXPECT_EQ(encode_p3(16, 16, r, g, b), reference_p3(16, 16, r, g, b));
+  }
+
+  // Una imagen de varios bloques se ensambla en el orden correcto
+  TEST(ImageIOTest, EncodeP3MatchesStreamAcrossChunks) {
+    std::size_t const pixels = 2 * p3_chunk_pixels + 123;
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<std::uint8_t> r(pixels);
+    std::vector<std::uint8_t> g(pixels);
+    std::vector<std::uint8_t> b(pixels);
+    for (std::size_t i = 0; i < pixels; ++i) {
+      r[i] = static_cast<std::uint8_t>(dist(rng));
+      g[i] = static_cast<std::uint8_t>(dist(rng));
+      b[i] = static_cast<std::uint8_t>(dist(rng));
+    }
+    int const width        = static_cast<int>(pixels);
+    std::string const text = encode_p3(width, 1, r, g, b);
+    EXPECT_EQ(text, reference_p3(width, 1, r, g, b));
+    EXPECT_EQ(text.size(),
+              ppm_header(image_format::p3, width, 1).size() + p3_text_length(r, g, b));
+  }
+
+  TEST(ImageIOTest, EncodeP3PixelsRejectsSmallBuffer) {
+    std::array<std::uint8_t, 1> const value{100};
+    std::string out(12, '\0');
+    EXPECT_THROW(encode_p3_pixels(value, value, value, std::span{out}.first(11)),
+                 std::invalid_argument);
+    EXPECT_EQ(encode_p3_pixels(value, value, value, out), 12U);
+    EXPECT_EQ(out, "100 100 100\n");
+  }
+
+  TEST(ImageIOTest, WriteP3) {
+    std::string const filename = "temp_image_io_test.ppm";
+    std::vector<std::uint8_t> const r{255, 0};
+    std::vector<std::uint8_t> const g{0, 10};
+    std::vector<std::uint8_t> const b{0, 255};
+    write_p3(filename, 2, 1, r, g, b);
+    EXPECT_EQ(read_binary(filename), "P3\n2 1\n255\n255 0 0\n0 10 255\n");
+    std::filesystem::remove(filename);
+  }
+
+  // Un P6 escrito desde canales separados contiene la cabecera y los bytes intercalados
+  TEST(ImageIOTest, WriteP6FromChannels) {
+    std::string const filename = "temp_image_io_test.ppm";
+    std::array<std::uint8_t, 2> const r{255, 0};
+    std::array<std::uint8_t, 2> const g{0, 10};
+    std::array<std::uint8_t, 2> const b{0, 255};
+    write_p6(filename, 2, 1, r, g, b);
+
+    EXPECT_EQ(read_binary(filename),
+              (std::string{"P6\n2 1\n255\n"} +
+               std::string{'\xFF', '\x00', '\x00', '\x00', '\x0A', '\xFF'}));
+    std::filesystem::remove(filename);
+  }
+
+  TEST(ImageIOTest, WriteP6ThrowsOnInvalidPath) {
+    std::vector<char> const rgb(3, '\0');
+    EXPECT_THROW(write_p6("/non_existent_directory/test.ppm", 1, 1, rgb), std::runtime_error);
+  }
+
+  TEST(ImageIOTest, QoiHeader) {
+    EXPECT_EQ(qoi_header(258, 3),
+              (std::string{"qoif"} + std::string{'\x00', '\x00', '\x01', '\x02', '\x00', '\x00',
+                                                 '\x00', '\x03', '\x03', '\x00'}));
+    EXPECT_EQ(qoi_end_marker().size(), 8U);
+  }
+
+  // Un decodificador QOI estándar recupera exactamente los píxeles, también entre franjas
+  TEST(ImageIOTest, EncodeQoiRoundTrips) {
+    // 1703 x 77 píxeles: dos franjas completas y una parcial
+    int const width  = 1'703;
+    int const height = 77;
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    fill_test_image(static_cast<std::size_t>(width) * height, r, g, b);
+    ASSERT_GT(r.size(), 2 * qoi_chunk_pixels);
+    decoded_qoi const image = decode_qoi(encode_qoi(width, height, r, g, b));
+    EXPECT_EQ(image.width, width);
+    EXPECT_EQ(image.height, height);
+    EXPECT_EQ(image.rgb, interleaved(r, g, b));
+  }
+
+  // Franjas de cualquier tamaño codificadas por separado forman un único QOI válido
+  TEST(ImageIOTest, QoiStripsAreIndependent) {
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    fill_test_image(3'000, r, g, b);
+    std::string data = qoi_header(100, 30);
+    for (std::size_t first = 0; first < r.size(); first += 499) {
+      std::size_t const count = std::min<std::size_t>(499, r.size() - first);
+      append_qoi_pixels(std::span{r}.subspan(first, count), std::span{g}.subspan(first, count),
+                        std::span{b}.subspan(first, count), data);
+    }
+    data += qoi_end_marker();
+    EXPECT_EQ(decode_qoi(data).rgb, interleaved(r, g, b));
+  }
+
+  // Una imagen suave ocupa bastante menos que su P6
+  TEST(ImageIOTest, QoiCompressesSmoothImages) {
+    int const width  = 256;
+    int const height = 64;
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        r.push_back(static_cast<std::uint8_t>(x / 4));
+        g.push_back(static_cast<std::uint8_t>(y * 2));
+        b.push_back(static_cast<std::uint8_t>(128));
+      }
+    }
+    std::string const data      = encode_qoi(width, height, r, g, b);
+    std::size_t const p6_pixels = 3 * r.size();
+    EXPECT_LT(3 * data.size(), p6_pixels);
+    EXPECT_EQ(decode_qoi(data).rgb, interleaved(r, g, b));
+  }
+
+  TEST(ImageIOTest, WriteQoi) {
+    std::string const filename = "temp_image_io_test.qoi";
+    std::array<std::uint8_t, 2> const r{255, 0};
+    std::array<std::uint8_t, 2> const g{0, 10};
+    std::array<std::uint8_t, 2> const b{0, 255};
+    write_qoi(filename, 2, 1, r, g, b);
+    EXPECT_EQ(read_binary(filename), encode_qoi(2, 1, r, g, b));
+    EXPECT_EQ(decode_qoi(read_binary(filename)).rgb,
+              (std::vector<std::uint8_t>{255, 0, 0, 0, 10, 255}));
+    std::filesystem::remove(filename);
+  }
+
+  // write_image escribe cada formato con su codificador, como la resolución de output_format
+  TEST(ImageIOTest, WriteImageFollowsFormat) {
+    std::array<std::uint8_t, 2> const r{255, 0};
+    std::array<std::uint8_t, 2> const g{0, 10};
+    std::array<std::uint8_t, 2> const b{0, 255};
+    for (std::string const filename : {"temp_write_image.ppm", "temp_write_image.pnm",
+                                       "temp_write_image.qoi"})
+    {
+      auto const format = resolve_image_format("auto", filename);
+      write_image(filename, format, 2, 1, r, g, b);
+      auto const data = read_binary(filename);
+      if (format == image_format::qoi) {
+        EXPECT_EQ(data, encode_qoi(2, 1, r, g, b));
+      } else if (format == image_format::p6) {
+        EXPECT_EQ(data.substr(0, 2), "P6");
+      } else {
+        EXPECT_EQ(data, encode_p3(2, 1, r, g, b));
+      }
+      std::filesystem::remove(filename);
+    }
+  }
+
+  // Escribir por bandas produce el mismo fichero que codificar la imagen completa
+  TEST(ImageIOTest, StreamWriterMatchesWholeImage) {
+    std::string const filename = "temp_image_io_stream.out";
+    int const width            = 30;
+    int const height           = 20;
+    std::vector<std::uint8_t> r;
+    std::vector<std::uint8_t> g;
+    std::vector<std::uint8_t> b;
+    fill_test_image(static_cast<std::size_t>(width) * height, r, g, b);
+
+    for (image_format const format : {image_format::p3, image_format::p6, image_format::qoi}) {
+      {
+        image_stream_writer writer{filename, format, width, height};
+        for (std::size_t first = 0; first < r.size(); first += 7 * width) {
+          std::size_t const count = std::min<std::size_t>(7 * width, r.size() - first);
+          writer.write_rows(std::span{r}.subspan(first, count), std::span{g}.subspan(first, count),
+                            std::span{b}.subspan(first, count));
+        }
+        EXPECT_EQ(writer.get_rows_written(), height);
+        writer.finish();
+      }
+      std::string const streamed = read_binary(filename);
+      if (format == image_format::p3) {
+        EXPECT_EQ(streamed, encode_p3(width, height, r, g, b));
+      } else if (format == image_format::p6) {
+        std::string body;
+        append_encoded_pixels(format, r, g, b, body);
+        EXPECT_EQ(streamed, ppm_header(format, width, height) + body);
+      } else {
+        EXPECT_EQ(decode_qoi(streamed).rgb, interleaved(r, g, b));
+      }
+    }
+    std::filesystem::remove(filename);
+  }
+
+  TEST(ImageIOTest, StreamWriterChecksRowCount) {
+    std::string const filename = "temp_image_io_stream.out";
+    std::array<std::uint8_t, 4> const channel{1, 2, 3, 4};
+    {
+      image_stream_writer writer{filename, image_format::p6, 2, 1};
+      EXPECT_THROW(writer.write_rows(channel, channel, channel), std::invalid_argument);
+      EXPECT_THROW(writer.finish(), std::runtime_error);
+    }
+    {
+      image_stream_writer writer{filename, image_format::p6, 3, 2};
+      EXPECT_THROW(writer.write_rows(channel, channel, channel), std::invalid_argument);
+    }
+    std::filesystem::remove(filename);
+    EXPECT_THROW((image_stream_writer{"/non_existent_directory/test.ppm", image_format::p3, 1, 1}),
+                 std::runtime_error);
+  }
+
+  TEST(ImageIOTest, ReadPpmRoundTripsP3AndP6) {
+    std::vector<std::uint8_t> const r{0, 255, 7};
+    std::vector<std::uint8_t> const g{10, 128, 8};
+    std::vector<std::uint8_t> const b{200, 1, 9};
+    write_p3("temp_read.ppm", 3, 1, r, g, b);
+    auto const text = read_ppm("temp_read.ppm");
+    EXPECT_EQ(text.width, 3);
+    EXPECT_EQ(text.height, 1);
+    EXPECT_EQ(text.rgb, interleaved(r, g, b));
+
+    write_p6("temp_read.ppm", 1, 3, r, g, b);
+    auto const binary = read_ppm("temp_read.ppm");
+    EXPECT_EQ(binary.width, 1);
+    EXPECT_EQ(binary.height, 3);
+    EXPECT_EQ(binary.rgb, interleaved(r, g, b));
+    std::filesystem::remove("temp_read.ppm");
+  }
+
+  TEST(ImageIOTest, ReadPpmRejectsInvalidFiles) {
+    EXPECT_THROW((void)read_ppm("temp_read_missing.ppm"), std::runtime_error);
+    for (std::string const text : {"P5\n1 1\n255\n\n", "P3\n1 1\n65535\n1 2 3\n",
+                                   "P3\n2 1\n255\n1 2 3\n", "P3\n1 1\n255\n1 2 300\n"})
+    {
+      std::ofstream{"temp_read.ppm"} << text;
+      EXPECT_THROW((void)read_ppm("temp_read.ppm"), std::runtime_error) << text;
+    }
+    std::filesystem::remove("temp_read.ppm");
+  }
+
+}  // namespace render
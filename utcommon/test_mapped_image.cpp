@@ -0,0 +1,63 @@
+#include "image_io.hpp"
+#include "mapped_image.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace render {
+
+  namespace {
+
+    std::string read_binary(std::string const & filename) {
+      std::ifstream file(filename, std::ios::binary);
+      return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+  }  // namespace
+
+  // Las filas escritas en cualquier orden dan el mismo fichero que write_p6
+  TEST(MappedImageTest, MatchesWriteP6) {
+    std::string const filename = "temp_mapped_image_test.ppm";
+    std::array<std::uint8_t, 6> const r{1, 2, 3, 4, 5, 6};
+    std::array<std::uint8_t, 6> const g{10, 20, 30, 40, 50, 60};
+    std::array<std::uint8_t, 6> const b{100, 110, 120, 130, 140, 150};
+    write_p6(filename, 2, 3, r, g, b);
+    std::string const expected = read_binary(filename);
+
+    {
+      mapped_p6_file mapped{filename, 2, 3};
+      for (int const row : {2, 0, 1}) {
+        auto const first = static_cast<std::size_t>(2 * row);
+        interleave_rgb(std::span{r}.subspan(first, 2), std::span{g}.subspan(first, 2),
+                       std::span{b}.subspan(first, 2), mapped.rows(row, row + 1));
+        mapped.flush_rows(row, row + 1);
+      }
+      mapped.finish();
+    }
+    EXPECT_EQ(read_binary(filename), expected);
+    std::filesystem::remove(filename);
+  }
+
+  TEST(MappedImageTest, RejectsInvalidRowsAndUse) {
+    std::string const filename = "temp_mapped_image_test.ppm";
+    mapped_p6_file mapped{filename, 4, 2};
+    EXPECT_EQ(mapped.rows(0, 2).size(), 24U);
+    EXPECT_THROW((void) mapped.rows(1, 3), std::out_of_range);
+    EXPECT_THROW((void) mapped.rows(-1, 1), std::out_of_range);
+    mapped.finish();
+    EXPECT_THROW(mapped.finish(), std::runtime_error);
+    EXPECT_THROW((void) mapped.rows(0, 1), std::out_of_range);
+    std::filesystem::remove(filename);
+  }
+
+  TEST(MappedImageTest, ThrowsOnInvalidPath) {
+    EXPECT_THROW((mapped_p6_file{"/non_existent_directory/test.ppm", 1, 1}), std::system_error);
+  }
+
+}  // namespace render
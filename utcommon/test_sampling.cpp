@@ -0,0 +1,62 @@
+#include "sampling.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <set>
+
+namespace render {
+
+  // Comprueba que las estrategias explícitas se respetan sin importar el tamaño
+  TEST(SamplingTest, ExplicitStrategyIsHonoured) {
+    EXPECT_EQ(choose_parallel_strategy("rows", 10, 64), parallel_strategy::rows);
+    EXPECT_EQ(choose_parallel_strategy("samples", 10'000'000, 1), parallel_strategy::samples);
+  }
+
+  // Con pocas filas y varios fragmentos por píxel se reparten también las muestras
+  TEST(SamplingTest, AutoPicksSamplesForFewRowsAndSeveralChunks) {
+    EXPECT_EQ(choose_parallel_strategy("auto", 36, 256), parallel_strategy::samples);
+    EXPECT_EQ(choose_parallel_strategy("auto", few_rows - 1, samples_per_chunk + 1),
+              parallel_strategy::samples);
+  }
+
+  // Con bastantes filas se mantiene el reparto por filas
+  TEST(SamplingTest, AutoPicksRowsForManyRows) {
+    EXPECT_EQ(choose_parallel_strategy("auto", 180, 4'096), parallel_strategy::rows);
+    EXPECT_EQ(choose_parallel_strategy("auto", few_rows, 4'096), parallel_strategy::rows);
+  }
+
+  // Con un solo fragmento por píxel no hay muestras que repartir
+  TEST(SamplingTest, AutoPicksRowsForSingleChunk) {
+    EXPECT_EQ(choose_parallel_strategy("auto", 36, 1), parallel_strategy::rows);
+    EXPECT_EQ(choose_parallel_strategy("auto", 36, 20), parallel_strategy::rows);
+    EXPECT_EQ(choose_parallel_strategy("auto", 36, samples_per_chunk), parallel_strategy::rows);
+  }
+
+  // Comprueba el redondeo hacia arriba del número de fragmentos
+  TEST(SamplingTest, ChunkCountRoundsUp) {
+    EXPECT_EQ(sample_chunk_count(1), 1);
+    EXPECT_EQ(sample_chunk_count(samples_per_chunk), 1);
+    EXPECT_EQ(sample_chunk_count(samples_per_chunk + 1), 2);
+    EXPECT_EQ(sample_chunk_count(4'096), 4'096 / samples_per_chunk);
+    EXPECT_EQ(sample_chunk_count(0), 0);
+  }
+
+  // La semilla de un flujo es reproducible
+  TEST(SamplingTest, StreamSeedIsDeterministic) {
+    EXPECT_EQ(stream_seed(19, 7, 3), stream_seed(19, 7, 3));
+  }
+
+  // Claves distintas producen semillas distintas
+  TEST(SamplingTest, StreamSeedSeparatesKeys) {
+    std::set<std::uint64_t> seeds;
+    for (std::uint64_t key = 0; key < 64; ++key) {
+      for (std::uint64_t sub = 0; sub < 64; ++sub) {
+        seeds.insert(stream_seed(19, key, sub));
+      }
+    }
+    EXPECT_EQ(seeds.size(), std::size_t{64} * 64);
+    EXPECT_NE(stream_seed(19, 1, 2), stream_seed(19, 2, 1));
+    EXPECT_NE(stream_seed(19, 1), stream_seed(133, 1));
+  }
+
+}  // namespace render
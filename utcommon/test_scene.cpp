@@ -330,6 +330,38 @@ TEST(SceneTest, OverwriteMaterialWithSameName) {
   EXPECT_EQ(retrieved->get_type(), "metal");  // Debe ser el último añadido
 }
 
+// Verifica que los materiales reciben identificadores densos en orden de inserción.
+TEST(SceneTest, MaterialIdsFollowInsertionOrder) {
+  render::scene scn;
+
+  auto const red  = scn.add_material("red", std::make_unique<render::matte_material>(
+                                                render::vector{1, 0, 0}));
+  auto const blue = scn.add_material("blue", std::make_unique<render::matte_material>(
+                                                 render::vector{0, 0, 1}));
+
+  EXPECT_EQ(red, 0U);
+  EXPECT_EQ(blue, 1U);
+  EXPECT_EQ(scn.material_count(), 2U);
+  EXPECT_EQ(scn.find_material("blue"), blue);
+  EXPECT_EQ(scn.find_material("green"), render::scene::no_material);
+  EXPECT_EQ(scn.get_material_name(red), "red");
+  EXPECT_EQ(scn.get_material(blue), scn.get_material("blue"));
+}
+
+// Verifica que sustituir un material conserva su identificador.
+TEST(SceneTest, OverwriteMaterialKeepsId) {
+  render::scene scn;
+
+  auto const first  = scn.add_material("mat", std::make_unique<render::matte_material>(
+                                                   render::vector{1, 0, 0}));
+  auto const second = scn.add_material("mat", std::make_unique<render::metal_material>(
+                                                   render::vector{0, 1, 0}, 0.5));
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(scn.material_count(), 1U);
+  EXPECT_EQ(scn.get_material(first)->get_type(), "metal");
+}
+
 // Verifica que los materiales siguen accesibles después de añadir varios objetos.
 TEST(SceneTest, MaterialsSurviveObjectAddition) {
   render::scene scn;
@@ -0,0 +1,97 @@
+#include "scene_cache.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace render {
+
+  namespace {
+
+    void write_scene(std::string const & filename, double radius) {
+      std::ofstream out(filename);
+      out << "matte: gray 0.5 0.5 0.5\n"
+          << "sphere: 0 0 -2 " << radius << " gray\n";
+    }
+
+  }  // namespace
+
+  TEST(SceneCacheTest, ReusesSceneWithSameContents) {
+    write_scene("temp_cache_a.txt", 1.0);
+    write_scene("temp_cache_b.txt", 1.0);
+    scene_cache cache{4};
+
+    auto const first = cache.get("temp_cache_a.txt");
+    EXPECT_FALSE(first.hit);
+    auto const again = cache.get("temp_cache_a.txt");
+    EXPECT_TRUE(again.hit);
+    EXPECT_EQ(again.value, first.value);
+
+    // Otra ruta con el mismo contenido comparte la escena
+    auto const copy = cache.get("temp_cache_b.txt");
+    EXPECT_TRUE(copy.hit);
+    EXPECT_EQ(copy.value, first.value);
+
+    // Un fichero modificado se vuelve a leer
+    write_scene("temp_cache_a.txt", 2.0);
+    auto const changed = cache.get("temp_cache_a.txt");
+    EXPECT_FALSE(changed.hit);
+    EXPECT_NE(changed.value, first.value);
+    EXPECT_EQ(cache.size(), 2U);
+
+    std::filesystem::remove("temp_cache_a.txt");
+    std::filesystem::remove("temp_cache_b.txt");
+  }
+
+  TEST(SceneCacheTest, EvictsLeastRecentlyUsed) {
+    scene_cache cache{2};
+    for (int i = 1; i <= 3; ++i) {
+      write_scene("temp_cache_" + std::to_string(i) + ".txt", i);
+    }
+    (void) cache.get("temp_cache_1.txt");
+    (void) cache.get("temp_cache_2.txt");
+    EXPECT_TRUE(cache.get("temp_cache_1.txt").hit);
+    (void) cache.get("temp_cache_3.txt");
+    EXPECT_EQ(cache.size(), 2U);
+    EXPECT_TRUE(cache.get("temp_cache_1.txt").hit);
+    EXPECT_FALSE(cache.get("temp_cache_2.txt").hit);
+    for (int i = 1; i <= 3; ++i) {
+      std::filesystem::remove("temp_cache_" + std::to_string(i) + ".txt");
+    }
+  }
+
+  TEST(SceneCacheTest, SkipsHashWhileFileIsUnchanged) {
+    std::string const path = "temp_cache_stamp.txt";
+    write_scene(path, 1.0);
+    auto const past = std::filesystem::last_write_time(path) - std::chrono::hours{1};
+    std::filesystem::last_write_time(path, past);
+    scene_cache cache{4};
+    auto const first = cache.get(path);
+    EXPECT_FALSE(first.hit);
+
+    // Mismo inodo, tamaño y fecha: no se vuelve a calcular la huella aunque cambie el contenido
+    write_scene(path, 3.0);
+    std::filesystem::last_write_time(path, past);
+    auto const same_stamp = cache.get(path);
+    EXPECT_TRUE(same_stamp.hit);
+    EXPECT_EQ(same_stamp.value, first.value);
+
+    // Con otra fecha sí
+    std::filesystem::last_write_time(path, past + std::chrono::minutes{1});
+    auto const touched = cache.get(path);
+    EXPECT_FALSE(touched.hit);
+    EXPECT_DOUBLE_EQ(touched.value->get_objects()[0]->get_radius(), 3.0);
+
+    std::filesystem::remove(path);
+  }
+
+  TEST(SceneCacheTest, RejectsInvalidUse) {
+    EXPECT_THROW(scene_cache{0}, std::invalid_argument);
+    scene_cache cache{1};
+    EXPECT_THROW((void) cache.get("non_existent_scene.txt"), std::runtime_error);
+    EXPECT_EQ(cache.size(), 0U);
+  }
+
+}  // namespace render
@@ -0,0 +1,107 @@
+#include "scene_generator.hpp"
+#include "material.hpp"
+#include "object.hpp"
+#include "scene.hpp"
+#include "scene_parser.hpp"
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace render {
+
+  namespace {
+
+    std::string generated_text(scene_generator_options const & options) {
+      scene scn;
+      generate_scene(options, scn);
+      std::ostringstream out;
+      write_scene_text(scn, out);
+      return out.str();
+    }
+
+  }  // namespace
+
+  TEST(SceneGeneratorTest, SameSeedGivesSameScene) {
+    scene_generator_options options;
+    options.object_count = 200;
+    options.seed         = 7;
+    EXPECT_EQ(generated_text(options), generated_text(options));
+
+    auto other = options;
+    other.seed = 8;
+    EXPECT_NE(generated_text(options), generated_text(other));
+  }
+
+  TEST(SceneGeneratorTest, HonoursCountsAndMix) {
+    scene_generator_options options;
+    options.object_count      = 500;
+    options.cylinder_fraction = 0.0;
+    options.material_count    = 10;
+    options.material_mix      = {0.0, 1.0, 0.0};
+    scene scn;
+    generate_scene(options, scn);
+
+    ASSERT_EQ(scn.get_objects().size(), 500U);
+    EXPECT_EQ(scn.material_count(), 10U);
+    for (scene::material_id id = 0; id < scn.material_count(); ++id) {
+      EXPECT_EQ(scn.get_material(id)->get_type(), "metal");
+    }
+    for (auto const & obj : scn.get_objects()) {
+      EXPECT_EQ(obj->get_type(), "sphere");
+    }
+  }
+
+  TEST(SceneGeneratorTest, OneMaterialPerObjectOnGrid) {
+    scene_generator_options options;
+    options.object_count      = 100;
+    options.material_count    = 0;
+    options.cylinder_fraction = 1.0;
+    options.layout            = scene_layout::grid;
+    scene scn;
+    generate_scene(options, scn);
+
+    EXPECT_EQ(scn.material_count(), 100U);
+    for (auto const & obj : scn.get_objects()) {
+      EXPECT_EQ(obj->get_type(), "cylinder");
+      EXPECT_GE(obj->get_center().x, -11.0);
+      EXPECT_LE(obj->get_center().x, 11.0);
+    }
+  }
+
+  TEST(SceneGeneratorTest, TextReadsBackIdentically) {
+    for (auto const layout : {scene_layout::uniform, scene_layout::clustered, scene_layout::grid}) {
+      scene_generator_options options;
+      options.object_count = 300;
+      options.layout       = layout;
+      auto const text      = generated_text(options);
+
+      scene parsed;
+      parse_scene_text(text, parsed);
+      EXPECT_EQ(parsed.get_objects().size(), 300U);
+      std::ostringstream again;
+      write_scene_text(parsed, again);
+      EXPECT_EQ(again.str(), text);
+    }
+  }
+
+  TEST(SceneGeneratorTest, RejectsInvalidOptions) {
+    scene scn;
+    scene_generator_options options;
+    options.object_count = 0;
+    EXPECT_THROW(generate_scene(options, scn), std::invalid_argument);
+
+    options.object_count      = 10;
+    options.cylinder_fraction = 1.5;
+    EXPECT_THROW(generate_scene(options, scn), std::invalid_argument);
+
+    options.cylinder_fraction = 0.5;
+    options.material_mix      = {0.0, 0.0, 0.0};
+    EXPECT_THROW(generate_scene(options, scn), std::invalid_argument);
+
+    EXPECT_EQ(parse_scene_layout("clustered"), scene_layout::clustered);
+    EXPECT_THROW((void) parse_scene_layout("spiral"), std::invalid_argument);
+  }
+
+}  // namespace render
@@ -507,3 +507,93 @@ TEST(SceneParserTest, ErrorMessageContainsLineContent) {
     EXPECT_NE(error_msg.find("invalid_tag"), std::string::npos) << "Error message: " << error_msg;
   }
 }
+
+// Tests del parseo desde memoria
+
+// Verifica que parse_scene_text acepta el mismo formato que el archivo, con o sin salto de línea
+// al final.
+TEST(SceneParserTest, ParseSceneTextWithoutFinalNewline) {
+  render::scene scn;
+  ASSERT_NO_THROW(render::parse_scene_text("matte: m1 0.8 0.1 0.1\n"
+                                           "\t sphere   0 1 0 0.5 m1",
+                                           scn));
+  EXPECT_NE(scn.get_material("m1"), nullptr);
+}
+
+// Verifica que el mensaje de error de datos sobrantes incluye los tokens que sobran.
+TEST(SceneParserTest, ExtraDataMessageListsExtraTokens) {
+  render::scene scn;
+  try {
+    render::parse_scene_text("matte: m1 0.8 0.1 0.1 sobra  otra\n", scn);
+    FAIL() << "Expected std::runtime_error";
+  } catch (std::runtime_error const & e) {
+    std::string const error_msg = e.what();
+    EXPECT_NE(error_msg.find("Extra: sobra otra"), std::string::npos) << error_msg;
+  }
+}
+
+// Verifica que los números se convierten como con std::stod: signo + opcional y error si el
+// token no empieza por un número.
+TEST(SceneParserTest, NumbersFollowStodRules) {
+  render::scene scn;
+  ASSERT_NO_THROW(render::parse_scene_text("refractive: glass +1.5\n", scn));
+  EXPECT_THROW(render::parse_scene_text("refractive: bad abc\n", scn), std::invalid_argument);
+  EXPECT_THROW(render::parse_scene_text("refractive: big 1e999\n", scn), std::out_of_range);
+}
+
+// Tests de escenas grandes, que se leen por fragmentos en paralelo
+
+namespace {
+
+  // Escena de más de 2 MiB: un material y lines esferas que lo usan
+  std::string large_scene(int lines) {
+    std::string text = "matte: m1 0.5 0.5 0.5\n";
+    for (int i = 0; i < lines; ++i) {
+      text += "sphere: " + std::to_string(i) + " 0.25 -1.5 0.75 m1\n";
+    }
+    return text;
+  }
+
+  constexpr int large_scene_lines = 80'000;
+
+  // Mensaje del error al leer el texto
+  std::string parse_error_message(std::string const & text) {
+    render::scene scn;
+    try {
+      render::parse_scene_text(text, scn);
+    } catch (std::exception const & e) {
+      return e.what();
+    }
+    return "";
+  }
+
+}  // namespace
+
+// Verifica que el número de línea de un error es correcto aunque esté en otro fragmento.
+TEST(SceneParserTest, LargeSceneReportsGlobalLineNumber) {
+  auto const text = large_scene(large_scene_lines) + "invalid_tag: x\n";
+  ASSERT_GT(text.size(), std::size_t{2} << 20);
+  auto const expected = "Error on line " + std::to_string(large_scene_lines + 2);
+  EXPECT_EQ(parse_error_message(text).find(expected), 0U) << parse_error_message(text);
+}
+
+// Verifica que un material usado en un fragmento y definido en otro posterior no es válido.
+TEST(SceneParserTest, LargeSceneMaterialDefinedAfterUseFails) {
+  auto const text = "sphere: 0 0 0 1 late\n" + large_scene(large_scene_lines) +
+                    "matte: late 0.5 0.5 0.5\n";
+  EXPECT_EQ(parse_error_message(text).find("Error: Material not found [late]"), 0U);
+}
+
+// Verifica que, con varios errores, se informa del primero del archivo.
+TEST(SceneParserTest, LargeSceneReportsFirstError) {
+  auto const text = large_scene(large_scene_lines) + "sphere: 0 0 0 -1 m1\n" +
+                    large_scene(large_scene_lines);
+  auto const message = parse_error_message(text);
+  EXPECT_EQ(message.find("Error: Invalid sphere parameters"), 0U) << message;
+}
+
+// Verifica que un nombre repetido se detecta antes que unos parámetros no válidos.
+TEST(SceneParserTest, DuplicateNameReportedBeforeInvalidParameters) {
+  auto const message = parse_error_message("matte: m1 0.5 0.5 0.5\nmatte: m1 -1 0 0\n");
+  EXPECT_EQ(message.find("Error: Material with name [m1] already exists"), 0U) << message;
+}
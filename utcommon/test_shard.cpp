@@ -0,0 +1,192 @@
+#include "hdr_image.hpp"
+#include "image_io.hpp"
+#include "shard.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Imagen de 3x7 en bandas de 2 filas (la última de 1) con valores distintos por píxel
+    constexpr int width       = 3;
+    constexpr int height      = 7;
+    constexpr int band_height = 2;
+
+    shard_header make_header(int index, int count) {
+      return shard_header{.width         = width,
+                          .height        = height,
+                          .band_height   = band_height,
+                          .part          = {.index = index, .count = count},
+                          .fingerprint   = 42,
+                          .output_format = "p6",
+                          .strategy      = parallel_strategy::samples,
+                          .ray_streams   = 2};
+    }
+
+    std::uint8_t value(std::size_t pixel, std::size_t channel) {
+      return static_cast<std::uint8_t>(3 * pixel + channel);
+    }
+
+    // Parte index de count recortada de la imagen de prueba
+    shard make_shard(int index, int count, bool with_linear) {
+      shard part;
+      part.header = make_header(index, count);
+      for (int row = 0; row < height; ++row) {
+        if (not shard_owns_band(part.header.part, static_cast<std::size_t>(row / band_height))) {
+          continue;
+        }
+        for (int x = 0; x < width; ++x) {
+          auto const pixel = static_cast<std::size_t>(row * width + x);
+          part.r.push_back(value(pixel, 0));
+          part.g.push_back(value(pixel, 1));
+          part.b.push_back(value(pixel, 2));
+          if (with_linear) {
+            for (std::size_t c = 0; c < 3; ++c) {
+              part.linear.push_back(static_cast<float>(value(pixel, c)) / 256.0F);
+            }
+          }
+        }
+      }
+      return part;
+    }
+
+    std::string round_trip(shard const & part) {
+      std::ostringstream out;
+      write_shard(out, part.header, part.r, part.g, part.b, part.linear);
+      return out.str();
+    }
+
+    std::string read_binary(std::string const & filename) {
+      std::ifstream file(filename, std::ios::binary);
+      return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+  }  // namespace
+
+  TEST(ShardTest, ParsesSpec) {
+    auto const spec = parse_shard_spec("2/5");
+    EXPECT_EQ(spec.index, 2);
+    EXPECT_EQ(spec.count, 5);
+    for (std::string const text : {"5/5", "-1/3", "1", "1/0", "a/2", "1/2x", "/2", ""}) {
+      EXPECT_THROW((void) parse_shard_spec(text), std::invalid_argument) << text;
+    }
+  }
+
+  // Cada banda pertenece exactamente a una parte
+  TEST(ShardTest, PartsCoverEveryBandOnce) {
+    for (int count = 1; count <= 5; ++count) {
+      int rows = 0;
+      for (std::size_t band = 0; band < 10; ++band) {
+        int owners = 0;
+        for (int index = 0; index < count; ++index) {
+          owners += shard_owns_band({.index = index, .count = count}, band) ? 1 : 0;
+        }
+        EXPECT_EQ(owners, 1);
+      }
+      for (int index = 0; index < count; ++index) {
+        rows += shard_rows(make_header(index, count));
+      }
+      EXPECT_EQ(rows, height);
+    }
+  }
+
+  TEST(ShardTest, StreamRoundTrip) {
+    auto const part = make_shard(1, 3, true);
+    std::istringstream in{round_trip(part)};
+    auto const read = read_shard(in);
+    EXPECT_EQ(read.header.part.index, 1);
+    EXPECT_EQ(read.header.part.count, 3);
+    EXPECT_EQ(read.header.fingerprint, 42U);
+    EXPECT_EQ(read.header.output_format, "p6");
+    EXPECT_EQ(read.header.strategy, parallel_strategy::samples);
+    EXPECT_EQ(read.header.ray_streams, 2);
+    EXPECT_EQ(read.r, part.r);
+    EXPECT_EQ(read.b, part.b);
+    EXPECT_EQ(read.linear, part.linear);
+
+    std::istringstream truncated{round_trip(part).substr(0, 60)};
+    EXPECT_THROW((void) read_shard(truncated), std::runtime_error);
+    std::istringstream garbage{"P6\n3 7\n255\n"};
+    EXPECT_THROW((void) read_shard(garbage), std::runtime_error);
+
+    std::ostringstream out;
+    EXPECT_THROW(write_shard(out, part.header, part.r, part.g, {}, {}), std::invalid_argument);
+  }
+
+  // Juntar las partes en cualquier orden da la imagen completa
+  TEST(ShardTest, MergeRebuildsWholeFrame) {
+    auto const whole = make_shard(0, 1, true);
+    std::vector<shard> const parts{make_shard(2, 3, true), make_shard(0, 3, true),
+                                   make_shard(1, 3, true)};
+    auto const merged = merge_shards(parts);
+    EXPECT_EQ(merged.header.part.count, 1);
+    EXPECT_EQ(merged.r, whole.r);
+    EXPECT_EQ(merged.g, whole.g);
+    EXPECT_EQ(merged.b, whole.b);
+    EXPECT_EQ(merged.linear, whole.linear);
+  }
+
+  TEST(ShardTest, MergeRejectsMissingOrForeignParts) {
+    std::vector<shard> missing{make_shard(0, 3, false), make_shard(1, 3, false)};
+    EXPECT_THROW((void) merge_shards(missing), std::invalid_argument);
+
+    std::vector<shard> repeated{make_shard(0, 2, false), make_shard(0, 2, false)};
+    EXPECT_THROW((void) merge_shards(repeated), std::invalid_argument);
+
+    std::vector<shard> foreign{make_shard(0, 2, false), make_shard(1, 2, false)};
+    foreign[1].header.fingerprint = 7;
+    EXPECT_THROW((void) merge_shards(foreign), std::invalid_argument);
+
+    std::vector<shard> mixed{make_shard(0, 2, false), make_shard(1, 2, true)};
+    EXPECT_THROW((void) merge_shards(mixed), std::invalid_argument);
+
+    // Otra estrategia u otros flujos de rayos dan otros números aleatorios en cada píxel
+    std::vector<shard> other_strategy{make_shard(0, 2, false), make_shard(1, 2, false)};
+    other_strategy[1].header.strategy = parallel_strategy::rows;
+    EXPECT_THROW((void) merge_shards(other_strategy), std::invalid_argument);
+
+    std::vector<shard> other_streams{make_shard(0, 2, false), make_shard(1, 2, false)};
+    other_streams[1].header.ray_streams = 1;
+    EXPECT_THROW((void) merge_shards(other_streams), std::invalid_argument);
+  }
+
+  // La imagen final es la misma que escribir la imagen completa, y el PFM lleva el color lineal
+  TEST(ShardTest, WritesFinalImageAndPfm) {
+    std::string const filename = "temp_shard_test.ppm";
+    std::string const expected = "temp_shard_expected.ppm";
+    auto const whole           = make_shard(0, 1, true);
+    write_p6(expected, width, height, whole.r, whole.g, whole.b);
+
+    std::vector<shard> const parts{make_shard(0, 2, true), make_shard(1, 2, true)};
+    write_shard_image(merge_shards(parts), filename);
+    EXPECT_EQ(read_binary(filename), read_binary(expected));
+    auto const hdr = read_pfm(hdr_path_for(filename));
+    EXPECT_DOUBLE_EQ(hdr.get_pixel(2, 6).get_b(), static_cast<double>(whole.linear.back()));
+
+    EXPECT_THROW(write_shard_image(parts[0], filename), std::invalid_argument);
+    std::filesystem::remove(filename);
+    std::filesystem::remove(hdr_path_for(filename));
+    std::filesystem::remove(expected);
+  }
+
+  TEST(ShardTest, FileRoundTrip) {
+    std::string const filename = "temp_shard_test.shard";
+    auto const part            = make_shard(1, 2, false);
+    write_shard_file(filename, part.header, part.r, part.g, part.b, part.linear);
+    auto const read = read_shard_file(filename);
+    EXPECT_EQ(read.r, part.r);
+    EXPECT_TRUE(read.linear.empty());
+    std::filesystem::remove(filename);
+    EXPECT_THROW((void) read_shard_file("non_existent.shard"), std::runtime_error);
+  }
+
+}  // namespace render
@@ -0,0 +1,180 @@
+#include "tile_scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace render {
+
+  // El propietario extrae en orden LIFO
+  TEST(WorkStealingDequeTest, PopIsLifo) {
+    work_stealing_deque deque(3);
+    deque.push(1);
+    deque.push(2);
+    deque.push(3);
+    EXPECT_EQ(deque.pop(), 3U);
+    EXPECT_EQ(deque.pop(), 2U);
+    EXPECT_EQ(deque.pop(), 1U);
+    EXPECT_FALSE(deque.pop().has_value());
+  }
+
+  // Los ladrones extraen en orden FIFO
+  TEST(WorkStealingDequeTest, StealIsFifo) {
+    work_stealing_deque deque(3);
+    deque.push(1);
+    deque.push(2);
+    deque.push(3);
+    EXPECT_EQ(deque.steal(), 1U);
+    EXPECT_EQ(deque.size_hint(), 2U);
+    EXPECT_EQ(deque.pop(), 3U);
+    EXPECT_EQ(deque.steal(), 2U);
+    EXPECT_FALSE(deque.steal().has_value());
+  }
+
+  // Superar la capacidad fija es un error
+  TEST(WorkStealingDequeTest, PushBeyondCapacityThrows) {
+    work_stealing_deque deque(1);
+    deque.push(0);
+    EXPECT_THROW(deque.push(1), std::length_error);
+  }
+
+  // Con varios ladrones concurrentes cada elemento se entrega exactamente una vez
+  TEST(WorkStealingDequeTest, ConcurrentPopAndStealDeliverEachItemOnce) {
+    constexpr std::size_t items = 20'000;
+    work_stealing_deque deque(items);
+    for (std::size_t i = 0; i < items; ++i) {
+      deque.push(i);
+    }
+
+    std::vector<std::atomic<int>> seen(items);
+    std::atomic<std::size_t> taken{0};
+    {
+      std::vector<std::jthread> thieves;
+      for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+          while (taken.load() < items) {
+            if (auto const item = deque.steal()) {
+              seen[*item].fetch_add(1);
+              taken.fetch_add(1);
+            }
+          }
+        });
+      }
+      while (taken.load() < items) {
+        if (auto const item = deque.pop()) {
+          seen[*item].fetch_add(1);
+          taken.fetch_add(1);
+        }
+      }
+    }
+
+    for (auto const & count : seen) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+
+  // El reparto inicial equilibra el coste y deja el tile más caro al final de cada cola
+  TEST(TileSchedulerTest, InitialAssignmentBalancesCost) {
+    std::vector<double> const costs{8.0, 1.0, 4.0, 4.0, 2.0, 1.0};
+    auto const assignment = tile_scheduler::initial_assignment(costs, 2);
+    ASSERT_EQ(assignment.size(), 2U);
+
+    std::vector<double> loads;
+    std::size_t total_tiles = 0;
+    for (auto const & tiles : assignment) {
+      double load = 0.0;
+      for (std::size_t const tile : tiles) {
+        load += costs[tile];
+      }
+      loads.push_back(load);
+      total_tiles += tiles.size();
+      EXPECT_TRUE(std::ranges::is_sorted(tiles, [&](std::size_t a, std::size_t b) {
+        return costs[a] < costs[b];
+      }));
+    }
+    EXPECT_EQ(total_tiles, costs.size());
+    EXPECT_DOUBLE_EQ(loads[0], 10.0);
+    EXPECT_DOUBLE_EQ(loads[1], 10.0);
+  }
+
+  // Cada tile se ejecuta una sola vez aunque los costes estimados estén muy desequilibrados
+  TEST(TileSchedulerTest, RunsEveryTileOnce) {
+    std::vector<double> costs(257, 1.0);
+    costs[0] = 1000.0;
+    std::vector<std::atomic<int>> runs(costs.size());
+
+    tile_scheduler scheduler(4);
+    auto const stats = scheduler.run(costs, [&](std::size_t tile, int worker) {
+      EXPECT_GE(worker, 0);
+      EXPECT_LT(worker, 4);
+      runs[tile].fetch_add(1);
+    });
+
+    for (auto const & count : runs) {
+      EXPECT_EQ(count.load(), 1);
+    }
+    EXPECT_EQ(std::accumulate(stats.tiles_done.begin(), stats.tiles_done.end(), std::size_t{0}),
+              costs.size());
+    EXPECT_GE(stats.imbalance(), 0.0);
+  }
+
+  // Un único hilo ejecuta todo sin robos
+  TEST(TileSchedulerTest, SingleWorkerNeverSteals) {
+    std::vector<double> const costs(10, 1.0);
+    tile_scheduler scheduler(1);
+    std::vector<std::size_t> order;
+    auto const stats = scheduler.run(costs, [&](std::size_t tile, int) { order.push_back(tile); });
+    EXPECT_EQ(order.size(), costs.size());
+    EXPECT_EQ(stats.steals, 0U);
+  }
+
+  // Sin tiles no se ejecuta nada
+  TEST(TileSchedulerTest, EmptyRunIsNoop) {
+    tile_scheduler scheduler(3);
+    int calls        = 0;
+    auto const stats = scheduler.run({}, [&](std::size_t, int) { ++calls; });
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(stats.steals, 0U);
+  }
+
+  // La excepción del cuerpo se propaga al llamante
+  TEST(TileSchedulerTest, PropagatesBodyException) {
+    std::vector<double> const costs(16, 1.0);
+    tile_scheduler scheduler(2);
+    EXPECT_THROW(scheduler.run(costs, [](std::size_t tile, int) {
+      if (tile == 5) {
+        throw std::runtime_error("fallo");
+      }
+    }), std::runtime_error);
+  }
+
+  // Los hilos auxiliares se crean una vez y se reutilizan en cada ejecución
+  TEST(TileSchedulerTest, ReusesWorkerThreadsAcrossRuns) {
+    std::vector<double> const costs(64, 1.0);
+    tile_scheduler scheduler(3);
+    std::mutex ids_mutex;
+    std::set<std::thread::id> ids;
+    auto body = [&](std::size_t, int) {
+      std::this_thread::sleep_for(std::chrono::microseconds{200});
+      std::scoped_lock const lock{ids_mutex};
+      ids.insert(std::this_thread::get_id());
+    };
+    for (int i = 0; i < 3; ++i) {
+      (void) scheduler.run(costs, body);
+    }
+    EXPECT_LE(ids.size(), 3U);
+  }
+
+  // Un número de hilos no positivo no es válido
+  TEST(TileSchedulerTest, RejectsNonPositiveWorkers) {
+    EXPECT_THROW(tile_scheduler{0}, std::invalid_argument);
+  }
+
+}  // namespace render
@@ -0,0 +1,100 @@
+#include "color.hpp"
+#include "tonemap.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Gammas de las configuraciones de prueba y algunos extremos
+    constexpr std::array reference_gammas{1.0, 1.8, 2.2, 2.5, 0.45, 3.7};
+
+    std::uint8_t reference(double linear, double gamma) {
+      return color{linear, 0.0, 0.0}.to_discrete_r(gamma);
+    }
+
+  }  // namespace
+
+  // Coincide con to_discrete en valores aleatorios dentro y fuera de [0, 1]
+  TEST(TonemapTest, MatchesToDiscreteOnRandomValues) {
+    std::mt19937_64 rng{11};
+    std::uniform_real_distribution<double> wide(-0.25, 1.25);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (double const gamma : reference_gammas) {
+      tonemapper const tonemap{gamma};
+      for (int i = 0; i < 50'000; ++i) {
+        double const linear = i % 2 == 0 ? wide(rng) : std::pow(unit(rng), 6.0);
+        ASSERT_EQ(tonemap.to_discrete(linear), reference(linear, gamma))
+            << "gamma " << gamma << " linear " << linear;
+      }
+    }
+  }
+
+  // Coincide justo en cada cambio de byte, que es donde fallaría una tabla aproximada
+  TEST(TonemapTest, MatchesToDiscreteAtEveryStep) {
+    for (double const gamma : reference_gammas) {
+      tonemapper const tonemap{gamma};
+      for (int k = 0; k <= 255; ++k) {
+        // Valor lineal aproximado del paso k y sus vecinos inmediatos
+        double const linear = std::pow(k / 255.0, gamma);
+        for (double const x : {std::nextafter(linear, 0.0), linear, std::nextafter(linear, 2.0)}) {
+          ASSERT_EQ(tonemap.to_discrete(x), reference(x, gamma))
+              << "gamma " << gamma << " k " << k;
+        }
+      }
+    }
+  }
+
+  TEST(TonemapTest, HandlesLimits) {
+    tonemapper const tonemap{2.2};
+    EXPECT_EQ(tonemap.to_discrete(-1.0), 0);
+    EXPECT_EQ(tonemap.to_discrete(0.0), 0);
+    EXPECT_EQ(tonemap.to_discrete(1.0), 255);
+    EXPECT_EQ(tonemap.to_discrete(std::numeric_limits<double>::infinity()), 255);
+    EXPECT_DOUBLE_EQ(tonemap.get_gamma(), 2.2);
+  }
+
+  // map convierte cada canal igual que los to_discrete_* de color
+  TEST(TonemapTest, MapMatchesColorChannels) {
+    std::vector<color> const pixels{color{0.1, 0.5, 0.9}, color{1.5, -0.2, 0.0031}};
+    std::vector<std::uint8_t> r(2);
+    std::vector<std::uint8_t> g(2);
+    std::vector<std::uint8_t> b(2);
+    tonemapper const tonemap{1.8};
+    tonemap.map(pixels, r, g, b);
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      EXPECT_EQ(r[i], pixels[i].to_discrete_r(1.8));
+      EXPECT_EQ(g[i], pixels[i].to_discrete_g(1.8));
+      EXPECT_EQ(b[i], pixels[i].to_discrete_b(1.8));
+    }
+
+    std::vector<std::uint8_t> short_channel(1);
+    EXPECT_THROW(tonemap.map(pixels, short_channel, g, b), std::invalid_argument);
+  }
+
+  // map_interleaved escribe los mismos bytes que map, intercalados
+  TEST(TonemapTest, MapInterleavedMatchesMap) {
+    std::vector<color> const pixels{color{0.1, 0.5, 0.9}, color{1.5, -0.2, 0.0031}};
+    std::vector<std::uint8_t> r(2);
+    std::vector<std::uint8_t> g(2);
+    std::vector<std::uint8_t> b(2);
+    std::vector<char> rgb(6);
+    tonemapper const tonemap{2.2};
+    tonemap.map(pixels, r, g, b);
+    tonemap.map_interleaved(pixels, rgb);
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      EXPECT_EQ(static_cast<std::uint8_t>(rgb[3 * i]), r[i]);
+      EXPECT_EQ(static_cast<std::uint8_t>(rgb[3 * i + 1]), g[i]);
+      EXPECT_EQ(static_cast<std::uint8_t>(rgb[3 * i + 2]), b[i]);
+    }
+    EXPECT_THROW(tonemap.map_interleaved(pixels, std::span{rgb}.first(5)), std::invalid_argument);
+  }
+
+}  // namespace render
@@ -0,0 +1,85 @@
+#include "config.hpp"
+#include "frame_pipeline.hpp"
+#include "render_frame.hpp"
+#include "render_job.hpp"
+#include "sampling.hpp"
+#include "scene.hpp"
+#include "scene_parser.hpp"
+#include "shard.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <string>
+
+namespace render {
+
+  namespace {
+
+    std::string read_binary(std::string const & filename) {
+      std::ifstream file(filename, std::ios::binary);
+      return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    // Cada prueba usa sus propios ficheros, para poder ejecutarlas en paralelo
+    std::shared_ptr<scene const> small_scene(std::string const & filename) {
+      std::ofstream{filename} << "matte: gray 0.5 0.5 0.5\n"
+                              << "metal: mirror 0.9 0.8 0.7 0.1\n"
+                              << "refractive: glass 1.5\n"
+                              << "sphere: 0 0 -2 1 gray\n"
+                              << "sphere: 1 0.5 -3 0.5 glass\n"
+                              << "cylinder: -1 0 -3 0.3 0 1 0 mirror\n";
+      auto scn = std::make_shared<scene>();
+      parse_scene_file(filename, *scn);
+      std::filesystem::remove(filename);
+      return scn;
+    }
+
+    // Renderiza con la configuración dada y devuelve los bytes de la imagen
+    std::string render_with(std::string const & settings, std::string const & output) {
+      config cfg;
+      apply_config_text("image_width: 64\nsamples_per_pixel: 8\nmax_depth: 4\n" + settings, cfg);
+      std::string const scene_path = output + ".scene.txt";
+      RenderJob job{cfg, small_scene(scene_path), scene_path, output};
+      render_frame(job, CheckpointPlan{}, shard_spec{});
+      std::string bytes = read_binary(output);
+      std::filesystem::remove(output);
+      return bytes;
+    }
+
+  }  // namespace
+
+  // La misma configuración da la misma imagen con cualquier número de hilos
+  TEST(RenderFrameTest, AutoStrategyDoesNotDependOnThreadCount) {
+    auto const one  = render_with("num_threads: 1\n", "temp_par_auto_1.ppm");
+    auto const four = render_with("num_threads: 4\n", "temp_par_auto_4.ppm");
+    ASSERT_FALSE(one.empty());
+    EXPECT_EQ(one, four);
+  }
+
+  // Cada estrategia explícita es también independiente del número de hilos
+  TEST(RenderFrameTest, ExplicitStrategiesDoNotDependOnThreadCount) {
+    for (std::string const strategy : {"rows", "samples"}) {
+      auto const setting = "parallel_strategy: " + strategy + "\n";
+      EXPECT_EQ(render_with(setting + "num_threads: 1\n", "temp_par_" + strategy + "_1.ppm"),
+                render_with(setting + "num_threads: 3\n", "temp_par_" + strategy + "_3.ppm"))
+          << strategy;
+    }
+  }
+
+  // "auto" sólo reparte por muestras en imágenes de pocas filas con varios fragmentos por píxel
+  TEST(RenderFrameTest, AutoStrategyForModerateAndThumbnailRenders) {
+    auto const scn = small_scene("temp_par_strategy.txt");
+    config moderate;
+    apply_config_text("image_width: 320\naspect_ratio: 16 9\nsamples_per_pixel: 20\n", moderate);
+    EXPECT_EQ(RenderJob(moderate, scn, "temp_par_strategy.txt", "temp_par_strategy.ppm").strategy,
+              parallel_strategy::rows);
+
+    config thumbnail;
+    apply_config_text("image_width: 64\naspect_ratio: 16 9\nsamples_per_pixel: 256\n", thumbnail);
+    EXPECT_EQ(RenderJob(thumbnail, scn, "temp_par_strategy.txt", "temp_par_strategy.ppm").strategy,
+              parallel_strategy::samples);
+  }
+
+}  // namespace render
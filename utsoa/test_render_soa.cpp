@@ -9,6 +9,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 class ApplicationTest : public ::testing::Test {
 protected:
@@ -131,6 +132,49 @@ TEST_F(ImageSOATest, SetPixelAndSavePPM) {
   EXPECT_EQ(actual_content, expected_content);
 }
 
+// Comprueba que save_ppm en P6 escribe la cabecera y los bytes RGB intercalados
+TEST_F(ImageSOATest, SetPixelAndSavePPMBinary) {
+  ImageSOA image(2, 1);
+  double const gamma = 1.0;
+  image.set_pixel(0, 0, render::color{1.0, 0.0, 0.0}, gamma);
+  image.set_pixel(1, 0, render::color{0.0, 0.0, 1.0}, gamma);
+  image.save_ppm(test_filename, render::image_format::p6);
+  std::string const expected_content =
+      std::string{"P6\n2 1\n255\n"} + std::string{'\xFF', '\x00', '\x00', '\x00', '\x00', '\xFF'};
+  EXPECT_EQ(readFile(test_filename), expected_content);
+}
+
+// Comprueba que save con QOI escribe un fichero QOI con las operaciones esperadas
+TEST_F(ImageSOATest, SetPixelAndSaveQoi) {
+  ImageSOA image(2, 1);
+  double const gamma = 1.0;
+  image.set_pixel(0, 0, render::color{1.0, 0.0, 0.0}, gamma);
+  image.set_pixel(1, 0, render::color{0.0, 0.0, 1.0}, gamma);
+  image.save(test_filename, render::image_format::qoi);
+  // Primer píxel completo (QOI_OP_RGB); el segundo es una diferencia con desbordamiento
+  // circular (+1, 0, -1) que cabe en QOI_OP_DIFF
+  std::string const pixels{'\xFE', '\xFF', '\x00', '\x00', '\x79'};
+  EXPECT_EQ(readFile(test_filename),
+            render::qoi_header(2, 1) + pixels + render::qoi_end_marker());
+}
+
+// Comprueba que set_row escribe los mismos bytes que set_pixel
+TEST_F(ImageSOATest, SetRowMatchesSetPixel) {
+  double const gamma = 2.2;
+  std::vector<render::color> const row{render::color{0.2, 0.4, 0.6},
+                                       render::color{1.2, 0.0, 0.05}};
+  ImageSOA by_row(2, 1);
+  ImageSOA by_pixel(2, 1);
+  by_row.set_row(0, row, render::tonemapper{gamma});
+  by_pixel.set_pixel(0, 0, row[0], gamma);
+  by_pixel.set_pixel(1, 0, row[1], gamma);
+  by_row.save_ppm(test_filename);
+  std::string const row_content = readFile(test_filename);
+  by_pixel.save_ppm(test_filename);
+  EXPECT_EQ(row_content, readFile(test_filename));
+  EXPECT_THROW(by_row.set_row(1, row, render::tonemapper{gamma}), std::out_of_range);
+}
+
 // Comprueba si save_ppm falla con una ruta de archivo inválida
 TEST(ImageSOA, SavePPMThrowsOnInvalidPath) {
   ImageSOA const image(1, 1);